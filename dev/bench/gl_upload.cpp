@@ -0,0 +1,155 @@
+// CPU cost of getting a CEF software frame into the overlay texture: the
+// fenced PBO ring (--gl-upload=ring) against glTexSubImage2D + glFinish
+// (--gl-upload=sync). Runs OpenGLCompositor itself on a headless EGL
+// context (EGL_MESA_platform_surfaceless), so it works on llvmpipe in CI
+// as well as on a real GPU. Each frame is uploaded, then composited into
+// an offscreen framebuffer so the GPU actually reads the texture, as in
+// the main loop.
+//
+//   g++ -O2 -std=c++17 -I src dev/bench/gl_upload.cpp src/compositor/opengl_compositor.cpp
+//       src/compositor/gl_surface_pool.cpp src/context/egl_context.cpp src/logging.cpp
+//       -lEGL -lGLESv2 -lSDL3 -lwayland-egl -lX11 -o /tmp/gl_upload_bench
+//   /tmp/gl_upload_bench [width height frames]
+//
+// Force software rendering with EGL_PLATFORM=surfaceless LIBGL_ALWAYS_SOFTWARE=1.
+
+#include "compositor/opengl_compositor.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static bool initEgl() {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!getPlatformDisplay) {
+        fprintf(stderr, "eglGetPlatformDisplayEXT unavailable\n");
+        return false;
+    }
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        fprintf(stderr, "No surfaceless EGL display (needs EGL_MESA_platform_surfaceless)\n");
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const EGLint config_attrs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(display, config_attrs, &config, 1, &count) || count == 0) {
+        fprintf(stderr, "No GLES3 EGL config\n");
+        return false;
+    }
+    const EGLint context_attrs[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_NONE};
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attrs);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        fprintf(stderr, "GLES3 context creation failed\n");
+        return false;
+    }
+    printf("GL: %s / %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+    return true;
+}
+
+struct Result {
+    double avg_us;
+    double p50_us;
+    double p99_us;
+    double max_us;
+    double frame_us;  // Upload + composite + flush, wall time per frame
+};
+
+static Result run(OpenGLCompositor::UploadMode mode, int width, int height, int frames,
+                  const DamageRegion* damage) {
+    OpenGLCompositor::setUploadMode(mode);
+    OpenGLCompositor compositor;
+    compositor.init(nullptr, width, height);
+
+    // Offscreen target standing in for the window
+    GLuint target = 0;
+    GLuint fbo = 0;
+    glGenTextures(1, &target);
+    glBindTexture(GL_TEXTURE_2D, target);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4, 0xff);
+    std::vector<double> upload_us;
+    upload_us.reserve(frames);
+
+    // First upload creates the texture; keep it out of the numbers
+    compositor.updateOverlayPartial(pixels.data(), width, height);
+
+    auto start = Clock::now();
+    for (int i = 0; i < frames; i++) {
+        pixels[(static_cast<size_t>(i) * 4099) % pixels.size()] ^= 0x5a;  // New content each frame
+        auto t0 = Clock::now();
+        compositor.updateOverlayPartial(pixels.data(), width, height, damage);
+        upload_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+
+        glClear(GL_COLOR_BUFFER_BIT);
+        compositor.composite(width, height, 1.0f);
+        glFlush();
+    }
+    glFinish();
+    double total_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &target);
+    compositor.cleanup();
+
+    std::sort(upload_us.begin(), upload_us.end());
+    double sum = 0;
+    for (double us : upload_us) sum += us;
+    Result r;
+    r.avg_us = sum / frames;
+    r.p50_us = upload_us[frames / 2];
+    r.p99_us = upload_us[std::min(frames - 1, frames * 99 / 100)];
+    r.max_us = upload_us.back();
+    r.frame_us = total_us / frames;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 2 ? atoi(argv[1]) : 1920;
+    int height = argc > 2 ? atoi(argv[2]) : 1080;
+    int frames = argc > 3 ? atoi(argv[3]) : 300;
+    if (width <= 0 || height <= 0 || frames <= 0) {
+        fprintf(stderr, "usage: %s [width height frames]\n", argv[0]);
+        return 1;
+    }
+    if (!initEgl()) return 1;
+
+    // Typical partial paint: a caret/progress-bar sized rect plus a card
+    DamageRegion partial;
+    partial.add({width / 4, height - 80, width / 2, 24});
+    partial.add({64, 64, std::min(400, width - 64), std::min(300, height - 64)});
+
+    printf("%dx%d, %d frames; per-upload CPU time (us)\n", width, height, frames);
+    printf("%-6s %-8s %9s %9s %9s %9s %12s\n", "mode", "damage", "avg", "p50", "p99", "max", "frame avg");
+    struct Case { const char* name; OpenGLCompositor::UploadMode mode; const DamageRegion* damage; };
+    const Case cases[] = {
+        {"sync", OpenGLCompositor::UploadMode::Sync, nullptr},
+        {"ring", OpenGLCompositor::UploadMode::Ring, nullptr},
+        {"sync", OpenGLCompositor::UploadMode::Sync, &partial},
+        {"ring", OpenGLCompositor::UploadMode::Ring, &partial},
+    };
+    for (const auto& c : cases) {
+        Result r = run(c.mode, width, height, frames, c.damage);
+        printf("%-6s %-8s %9.0f %9.0f %9.0f %9.0f %12.0f\n", c.name, c.damage ? "partial" : "full",
+               r.avg_us, r.p50_us, r.p99_us, r.max_us, r.frame_us);
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Item JSON extraction: the single-pass reader against the per-field
+// rescanning helpers it replaced, on Jellyfin item fixtures (an episode with
+// a normal and a large cast/stream list, and an audio track).
+//
+//   g++ -O2 -std=c++17 -I src dev/bench/item_json.cpp src/player/item_json.cpp
+//       src/json_reader.cpp src/logging.cpp -lSDL3 -o /tmp/item_json_bench
+//   /tmp/item_json_bench dev/bench/fixtures/*.json
+
+#include "player/item_json.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using Clock = std::chrono::steady_clock;
+
+// Previous helpers, verbatim: each call rescans from the start of the text
+// and matches the first occurrence of the key at any depth
+static std::string jsonGetString(const std::string& json, const std::string& key) {
+    std::string search = "\"" + key + "\":";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) return "";
+    pos += search.length();
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
+    if (pos >= json.size() || json[pos] != '"') return "";
+    pos++;
+    std::string result;
+    while (pos < json.size() && json[pos] != '"') {
+        if (json[pos] == '\\' && pos + 1 < json.size()) {
+            pos++;
+        }
+        result += json[pos++];
+    }
+    return result;
+}
+
+static int64_t jsonGetInt(const std::string& json, const std::string& key) {
+    std::string search = "\"" + key + "\":";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) return 0;
+    pos += search.length();
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
+    std::string num;
+    while (pos < json.size() && (isdigit(json[pos]) || json[pos] == '-')) {
+        num += json[pos++];
+    }
+    return num.empty() ? 0 : std::stoll(num);
+}
+
+static int jsonGetIntDefault(const std::string& json, const std::string& key, int defaultVal) {
+    std::string search = "\"" + key + "\":";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) return defaultVal;
+    pos += search.length();
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
+    if (pos >= json.size()) return defaultVal;
+    bool negative = false;
+    if (json[pos] == '-') { negative = true; pos++; }
+    int val = 0;
+    while (pos < json.size() && json[pos] >= '0' && json[pos] <= '9') {
+        val = val * 10 + (json[pos] - '0');
+        pos++;
+    }
+    return negative ? -val : val;
+}
+
+static double jsonGetDouble(const std::string& json, const std::string& key, bool* hasValue) {
+    std::string search = "\"" + key + "\":";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) {
+        *hasValue = false;
+        return 0.0;
+    }
+    pos += search.length();
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
+    std::string num;
+    while (pos < json.size() && (isdigit(json[pos]) || json[pos] == '-' || json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E' || json[pos] == '+')) {
+        num += json[pos++];
+    }
+    *hasValue = !num.empty();
+    return num.empty() ? 0.0 : std::stod(num);
+}
+
+static std::string jsonGetFirstArrayString(const std::string& json, const std::string& key) {
+    std::string search = "\"" + key + "\":";
+    size_t pos = json.find(search);
+    if (pos == std::string::npos) return "";
+    pos += search.length();
+    while (pos < json.size() && json[pos] != '[') pos++;
+    if (pos >= json.size()) return "";
+    pos++;
+    while (pos < json.size() && json[pos] != '"' && json[pos] != ']') pos++;
+    if (pos >= json.size() || json[pos] == ']') return "";
+    pos++;
+    std::string result;
+    while (pos < json.size() && json[pos] != '"') {
+        if (json[pos] == '\\' && pos + 1 < json.size()) pos++;
+        result += json[pos++];
+    }
+    return result;
+}
+
+// What the load path used to do: metadata plus gain and track indices
+static ItemJson legacyParse(const std::string& json) {
+    ItemJson item;
+    item.meta.title = jsonGetString(json, "Name");
+    item.meta.artist = jsonGetString(json, "SeriesName");
+    if (item.meta.artist.empty()) item.meta.artist = jsonGetFirstArrayString(json, "Artists");
+    item.meta.album = jsonGetString(json, "SeasonName");
+    if (item.meta.album.empty()) item.meta.album = jsonGetString(json, "Album");
+    item.meta.track_number = static_cast<int>(jsonGetInt(json, "IndexNumber"));
+    item.meta.duration_us = jsonGetInt(json, "RunTimeTicks") / 10;
+    std::string type = jsonGetString(json, "Type");
+    if (type == "Audio") {
+        item.meta.media_type = MediaType::Audio;
+    } else if (type == "Movie" || type == "Episode" || type == "Video" || type == "MusicVideo") {
+        item.meta.media_type = MediaType::Video;
+    }
+    item.normalization_gain = jsonGetDouble(json, "NormalizationGain", &item.has_normalization_gain);
+    item.sub_idx = jsonGetIntDefault(json, "_subIdx", -1);
+    item.audio_idx = jsonGetIntDefault(json, "_audioIdx", -1);
+    return item;
+}
+
+static const char* typeName(MediaType t) {
+    return t == MediaType::Audio ? "audio" : t == MediaType::Video ? "video" : "unknown";
+}
+
+template <typename Parse>
+static double bench(const std::string& json, Parse parse, ItemJson& out) {
+    // Scale iterations so each run reads ~200 MB
+    int iterations = static_cast<int>(200e6 / static_cast<double>(json.size())) + 1;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        out = parse(json);
+    }
+    double secs = std::chrono::duration<double>(Clock::now() - start).count();
+    return secs / iterations * 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s item.json...\n", argv[0]);
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        std::ifstream file(argv[i]);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string json = buffer.str();
+        if (json.empty()) {
+            fprintf(stderr, "%s: empty or unreadable\n", argv[i]);
+            continue;
+        }
+
+        ItemJson legacy, single;
+        double legacy_us = bench(json, legacyParse, legacy);
+        double single_us = bench(json, parseItemJson, single);
+        printf("%s (%zu KB)\n", argv[i], json.size() / 1024);
+        printf("  rescanning:  %8.2f us  title=\"%s\" artist=\"%s\" album=\"%s\" type=%s\n", legacy_us,
+               legacy.meta.title.c_str(), legacy.meta.artist.c_str(), legacy.meta.album.c_str(),
+               typeName(legacy.meta.media_type));
+        printf("  single pass: %8.2f us  title=\"%s\" artist=\"%s\" album=\"%s\" type=%s\n", single_us,
+               single.meta.title.c_str(), single.meta.artist.c_str(), single.meta.album.c_str(),
+               typeName(single.meta.media_type));
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Throughput of the mpv event channel (event thread -> main thread) against
+// the mutex + vector queue it replaced.
+//
+//   g++ -O2 -std=c++17 -pthread -I src dev/bench/mpv_event_channel.cpp -o /tmp/mpv_event_bench
+//   /tmp/mpv_event_bench
+
+#include "player/mpv_event_thread.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr int kEvents = 2000000;
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Previous design: heap-backed event per update, pushed under a mutex,
+// drained by swapping vectors
+struct LegacyEvent {
+    int type;
+    double value = 0;
+    bool flag = false;
+    std::string error;
+    std::vector<std::pair<int64_t, int64_t>> ranges;
+};
+
+static void benchLegacy() {
+    std::mutex mutex;
+    std::vector<LegacyEvent> pending;
+    std::atomic<bool> done{false};
+    long delivered = 0;
+
+    auto start = Clock::now();
+    std::thread producer([&] {
+        for (int i = 0; i < kEvents; i++) {
+            std::lock_guard<std::mutex> lock(mutex);
+            LegacyEvent ev;
+            ev.type = 0;
+            ev.value = i;
+            pending.push_back(std::move(ev));
+        }
+        done = true;
+    });
+    while (true) {
+        bool finished = done.load();
+        std::vector<LegacyEvent> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(pending);
+        }
+        delivered += static_cast<long>(batch.size());
+        if (finished && batch.empty()) break;
+        if (batch.empty()) std::this_thread::yield();
+    }
+    producer.join();
+    double secs = seconds(start);
+    printf("mutex+vector  %10.0f events/s  (%ld delivered)\n", kEvents / secs, delivered);
+}
+
+static void benchLatestValue() {
+    LatestValue<double> slot;
+    std::atomic<bool> done{false};
+    long taken = 0;
+    double last = -1;
+
+    auto start = Clock::now();
+    std::thread producer([&] {
+        for (int i = 0; i < kEvents; i++) {
+            slot.store(i);
+        }
+        done = true;
+    });
+    while (true) {
+        bool finished = done.load();
+        double v;
+        if (slot.take(v)) {
+            taken++;
+            last = v;
+        } else if (finished) {
+            break;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    double secs = seconds(start);
+    printf("latest-value  %10.0f events/s  (%ld taken, last %.0f)\n", kEvents / secs, taken, last);
+}
+
+static void benchRing() {
+    static SpscRing<MpvEvent, 256> ring;
+    long popped = 0;
+
+    auto start = Clock::now();
+    std::thread producer([&] {
+        MpvEvent ev;
+        ev.type = MpvEvent::Type::Seeked;
+        for (int i = 0; i < kEvents; i++) {
+            ev.value = i;
+            while (!ring.push(ev)) std::this_thread::yield();
+        }
+    });
+    MpvEvent ev;
+    while (popped < kEvents) {
+        if (ring.pop(ev)) {
+            popped++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    double secs = seconds(start);
+    printf("spsc ring     %10.0f events/s  (%ld popped)\n", kEvents / secs, popped);
+}
+
+int main() {
+    benchLegacy();
+    benchLatestValue();
+    benchRing();
+    return 0;
+}
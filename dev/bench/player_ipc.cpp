@@ -0,0 +1,217 @@
+// Encode/decode cost of the binary player IPC batch against the previous
+// one-named-message-per-call path. Both sides run through the same
+// mutex-protected hand-off to a second thread, standing in for the process
+// hop; the real Mojo transport adds a per-message cost on top, which
+// batching divides by the batch size.
+//
+//   g++ -O2 -std=c++17 -pthread -I src dev/bench/player_ipc.cpp src/cef/player_ipc.cpp -o /tmp/player_ipc_bench
+//   /tmp/player_ipc_bench
+
+#include "cef/player_ipc.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+static constexpr int kTasks = 200000;       // Renderer tasks (e.g. timeupdate handlers)
+static constexpr int kRoundTrips = 20000;
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// One renderer task's worth of calls: position, rate and state reports
+static void taskCommands(int i, std::vector<PlayerCommand>& out) {
+    out.clear();
+    out.push_back(PlayerCommand::make(PlayerOp::MediaPosition, i));
+    out.push_back(PlayerCommand::makeDouble(PlayerOp::MediaNotifyRate, 1.0));
+    out.push_back(PlayerCommand::make(PlayerOp::MediaState, 1));
+}
+
+// Previous design: named message with a variant argument list per call,
+// decoded on the browser side by comparing names
+struct LegacyMessage {
+    std::string name;
+    std::vector<std::variant<int, double, bool, std::string>> args;
+};
+
+static LegacyMessage legacyEncode(const PlayerCommand& cmd) {
+    LegacyMessage msg;
+    switch (cmd.op) {
+    case PlayerOp::MediaPosition: msg.name = "notifyPosition"; msg.args.emplace_back(cmd.int_arg); break;
+    case PlayerOp::MediaNotifyRate: msg.name = "notifyRateChange"; msg.args.emplace_back(cmd.double_arg); break;
+    default: msg.name = "notifyPlaybackState"; msg.args.emplace_back(std::string("Playing")); break;
+    }
+    return msg;
+}
+
+static PlayerCommand legacyDecode(const LegacyMessage& msg) {
+    static const char* const kNames[] = {
+        "playerLoad", "playerStop", "playerPause", "playerPlay", "playerSeek", "playerSetVolume",
+        "playerSetMuted", "playerSetSpeed", "playerSetSubtitle", "playerSetAudio",
+        "playerSetAudioDelay", "saveServerUrl", "notifyMetadata", "notifyPosition", "notifySeek",
+        "notifyPlaybackState", "notifyArtwork", "notifyQueueChange", "notifyRateChange",
+    };
+    for (const char* name : kNames) {
+        if (msg.name != name) continue;
+        if (msg.name == "notifyPosition") return PlayerCommand::make(PlayerOp::MediaPosition, std::get<int>(msg.args[0]));
+        if (msg.name == "notifyRateChange") return PlayerCommand::makeDouble(PlayerOp::MediaNotifyRate, std::get<double>(msg.args[0]));
+        if (msg.name == "notifyPlaybackState") {
+            const auto& state = std::get<std::string>(msg.args[0]);
+            return PlayerCommand::make(PlayerOp::MediaState, state == "Playing" ? 1 : state == "Paused" ? 2 : 0);
+        }
+    }
+    return PlayerCommand::make(PlayerOp::Stop);
+}
+
+template <typename T>
+class Channel {
+public:
+    void send(T&& value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(value));
+        }
+        cv_.notify_one();
+    }
+    T receive() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !queue_.empty(); });
+        T value = std::move(queue_.front());
+        queue_.pop_front();
+        return value;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<T> queue_;
+};
+
+static void benchLegacy() {
+    Channel<LegacyMessage> channel;
+    std::vector<PlayerCommand> cmds;
+    long messages = 0;
+    long delivered = 0;
+
+    auto start = Clock::now();
+    std::thread browser([&] {
+        for (;;) {
+            LegacyMessage msg = channel.receive();
+            if (msg.name.empty()) break;
+            PlayerCommand cmd = legacyDecode(msg);
+            delivered += cmd.op == PlayerOp::Stop ? 0 : 1;
+        }
+    });
+    for (int i = 0; i < kTasks; i++) {
+        taskCommands(i, cmds);
+        for (const auto& cmd : cmds) {
+            channel.send(legacyEncode(cmd));
+            messages++;
+        }
+    }
+    channel.send(LegacyMessage{});
+    browser.join();
+    double secs = seconds(start);
+    printf("named messages: %7.2f M commands/s  (%ld messages, %ld delivered)\n",
+           delivered / secs / 1e6, messages, delivered);
+}
+
+static void benchBinary() {
+    Channel<std::vector<uint8_t>> channel;
+    std::vector<PlayerCommand> cmds;
+    PlayerIpcBatch batch;
+    long messages = 0;
+    long delivered = 0;
+    std::function<void(PlayerCommand&&)> deliver = [&](PlayerCommand&&) { delivered++; };
+
+    auto start = Clock::now();
+    std::thread browser([&] {
+        for (;;) {
+            std::vector<uint8_t> shm = channel.receive();
+            if (shm.empty()) break;
+            decodePlayerBatch(shm.data(), shm.size(), deliver);
+        }
+    });
+    for (int i = 0; i < kTasks; i++) {
+        taskCommands(i, cmds);
+        for (const auto& cmd : cmds) {
+            batch.add(cmd);
+        }
+        // Copy into a fresh region, as CefSharedProcessMessageBuilder does
+        const uint8_t* data = batch.data();
+        channel.send(std::vector<uint8_t>(data, data + batch.size()));
+        batch.clear();
+        messages++;
+    }
+    channel.send(std::vector<uint8_t>{});
+    browser.join();
+    double secs = seconds(start);
+    printf("binary batches: %7.2f M commands/s  (%ld messages, %ld delivered)\n",
+           delivered / secs / 1e6, messages, delivered);
+}
+
+// One command there and an acknowledgement back, per iteration
+template <typename Send>
+static void benchRoundTrip(const char* label, Send send) {
+    std::atomic<int> acked{0};
+    std::atomic<int> sent{0};
+    std::atomic<bool> quit{false};
+
+    std::thread browser([&] {
+        int seen = 0;
+        while (!quit.load(std::memory_order_acquire)) {
+            if (sent.load(std::memory_order_acquire) == seen) {
+                std::this_thread::yield();
+                continue;
+            }
+            send();
+            seen++;
+            acked.store(seen, std::memory_order_release);
+        }
+    });
+
+    auto start = Clock::now();
+    for (int i = 1; i <= kRoundTrips; i++) {
+        sent.store(i, std::memory_order_release);
+        while (acked.load(std::memory_order_acquire) != i) {
+            std::this_thread::yield();
+        }
+    }
+    double secs = seconds(start);
+    quit.store(true, std::memory_order_release);
+    browser.join();
+    printf("%s round trip: %6.2f us\n", label, secs / kRoundTrips * 1e6);
+}
+
+int main() {
+    benchLegacy();
+    benchBinary();
+
+    // Round trip: encode + decode of one notifyPosition on the receiving thread
+    PlayerCommand cmd = PlayerCommand::make(PlayerOp::MediaPosition, 1234);
+    benchRoundTrip("named message", [&] {
+        volatile int sink = legacyDecode(legacyEncode(cmd)).int_arg;
+        (void)sink;
+    });
+    PlayerIpcBatch batch;
+    std::function<void(PlayerCommand&&)> deliver = [](PlayerCommand&& c) {
+        volatile int sink = c.int_arg;
+        (void)sink;
+    };
+    benchRoundTrip("binary batch ", [&] {
+        batch.add(cmd);
+        decodePlayerBatch(batch.data(), batch.size(), deliver);
+        batch.clear();
+    });
+    return 0;
+}
@@ -0,0 +1,112 @@
+// HwdecPolicy without a GPU: hand-built capabilities, rule parsing, select()
+// per stream and the failure transitions recordOutcome() drives. Exits
+// non-zero on the first mismatch.
+//
+//   g++ -O2 -std=c++17 -I src dev/checks/hwdec_policy.cpp src/player/mpv/hwdec_policy.cpp
+//       src/logging.cpp -lSDL3 -o /tmp/hwdec_policy_check
+//   /tmp/hwdec_policy_check
+
+#include "player/mpv/hwdec_policy.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static int s_failures = 0;
+
+static void expect(const char* what, const std::string& got, const std::string& want) {
+    if (got == want) return;
+    fprintf(stderr, "FAIL %s: got \"%s\", want \"%s\"\n", what, got.c_str(), want.c_str());
+    s_failures++;
+}
+
+static void expect(const char* what, bool got, bool want) {
+    expect(what, std::string(got ? "true" : "false"), std::string(want ? "true" : "false"));
+}
+
+// Vulkan video for the common codecs, VA-API for anything
+static HwdecCapabilities caps() {
+    HwdecCapabilities caps;
+    caps.interops.push_back({"vulkan", {"h264", "hevc", "av1"}});
+    caps.interops.push_back({"vaapi", {}});
+    return caps;
+}
+
+static void setRules(const char* spec) {
+    std::vector<HwdecPolicy::Rule> rules;
+    if (!HwdecPolicy::parseRules(spec, rules)) {
+        fprintf(stderr, "FAIL parseRules(\"%s\") rejected\n", spec);
+        s_failures++;
+    }
+    HwdecPolicy::setDefaultRules(std::move(rules));
+}
+
+static void checkParse() {
+    std::vector<HwdecPolicy::Rule> rules;
+    expect("parse allow", HwdecPolicy::parseRules("allow", rules), true);
+    expect("parse full", HwdecPolicy::parseRules("deny:vaapi:hevc:Main 10:10,allow", rules), true);
+    expect("parse full count", std::to_string(rules.size()), "2");
+    expect("parse full fields", rules[0].interop + "|" + rules[0].codec + "|" + rules[0].profile + "|" +
+           std::to_string(rules[0].bit_depth), "vaapi|hevc|Main 10|10");
+    expect("parse bad verb", HwdecPolicy::parseRules("maybe", rules), false);
+    expect("parse bad depth", HwdecPolicy::parseRules("deny:*:*:*:ten", rules), false);
+    expect("parse extra field", HwdecPolicy::parseRules("deny:*:*:*:10:x", rules), false);
+}
+
+static void checkSelect() {
+    const HwdecStream h264{"h264", "High", 8};
+    const HwdecStream vp9{"vp9", "Profile 0", 8};
+    const HwdecStream hevc10{"hevc", "Main 10", 10};
+    const HwdecStream av1_10{"av1", "Main", 10};
+
+    setRules("");
+    HwdecPolicy policy(caps());
+    expect("h264", policy.select(h264), "vulkan,vaapi");
+    expect("vp9 (codec filter)", policy.select(vp9), "vaapi");
+    expect("hevc 10-bit (built-in deny)", policy.select(hevc10), "no");
+    expect("no interops", HwdecPolicy(HwdecCapabilities{}).select(h264), "no");
+
+    setRules("deny:vaapi");
+    expect("deny vaapi", HwdecPolicy(caps()).select(h264), "vulkan");
+
+    setRules("allow:vulkan:hevc:*:10");
+    HwdecPolicy hevc_only(caps());
+    expect("allow hevc 10-bit on vulkan", hevc_only.select(hevc10), "vulkan");
+    expect("av1 10-bit still denied", hevc_only.select(av1_10), "no");
+
+    setRules("allow");
+    expect("allow overrides built-in", HwdecPolicy(caps()).select(hevc10), "vulkan,vaapi");
+    setRules("");
+}
+
+static void checkOutcomes() {
+    const HwdecStream h264{"h264", "High", 8};
+    const HwdecStream h264_main{"h264", "Main", 8};
+    const HwdecStream hevc{"hevc", "Main", 8};
+
+    HwdecPolicy policy(caps());
+    expect("hw in use is no failure", policy.recordOutcome(h264, "vulkan,vaapi", "vaapi"), false);
+    expect("software requested is no failure", policy.recordOutcome(h264, "no", "no"), false);
+    expect("unchanged after non-failures", policy.select(h264), "vulkan,vaapi");
+
+    // One interop offered and lost: the next one is still tried
+    expect("vulkan failed", policy.recordOutcome(hevc, "vulkan", "no"), true);
+    expect("hevc after vulkan failure", policy.select(hevc), "vaapi");
+
+    // Everything offered failed: software for that stream class only
+    expect("all failed", policy.recordOutcome(h264, "vulkan,vaapi", "no"), true);
+    expect("h264 High after failure", policy.select(h264), "no");
+    expect("h264 Main unaffected", policy.select(h264_main), "vulkan,vaapi");
+    expect("other policy unaffected", HwdecPolicy(caps()).select(h264), "vulkan,vaapi");
+}
+
+int main() {
+    checkParse();
+    checkSelect();
+    checkOutcomes();
+    if (s_failures) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    printf("hwdec policy: all checks passed\n");
+    return 0;
+}
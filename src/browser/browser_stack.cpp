@@ -2,6 +2,7 @@
 #include "include/cef_browser.h"
 #include "../logging.h"
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 // BrowserEntry implementation
@@ -45,25 +46,105 @@ void BrowserEntry::resize(int width, int height) {
     }
 }
 
-std::function<void(const void*, int, int)> BrowserEntry::makePaintCallback() {
-    return [this](const void* buffer, int w, int h) {
-        // Write to back buffer without blocking
-        int write_idx = paint_write_idx.load(std::memory_order_relaxed);
-        auto& buf = paint_buffers[write_idx];
+PaintCallback BrowserEntry::makePaintCallback() {
+    return [this](const void* buffer, int w, int h, const CefRenderHandler::RectList& dirtyRects) {
+        // Collect this paint's damage (CEF reports it in paint buffer pixels)
+        paint_damage.clear();
+        for (const auto& r : dirtyRects) {
+            paint_damage.add(clipDamageRect({r.x, r.y, r.width, r.height}, w, h));
+        }
+        if (dirtyRects.empty()) {
+            paint_damage.setFull();
+        }
+
+        // Write into the slot the CEF thread owns; the GL thread never touches it
+        auto& buf = paint_buffers[paint_write_idx];
         size_t size = static_cast<size_t>(w) * h * 4;
-        if (buf.data.size() < size) {
-            buf.data.resize(size);
+        bool size_changed = buf.width != w || buf.height != h || buf.data.size() < size;
+
+        // The slot holds an older frame: bring it up to date with everything
+        // painted since (stale) plus this paint's damage
+        size_t copied = 0;
+        if (size_changed || paint_damage.full() || buf.stale.full()) {
+            if (buf.data.size() < size) {
+                buf.data.resize(size);
+            }
+            std::memcpy(buf.data.data(), buffer, size);
+            copied = size;
+        } else {
+            const auto* src = static_cast<const uint8_t*>(buffer);
+            for (const auto& r : buf.stale.rects()) {
+                copyDamageRect(buf.data.data(), src, w, r);
+                copied += static_cast<size_t>(r.area()) * 4;
+            }
+            for (const auto& r : paint_damage.rects()) {
+                copyDamageRect(buf.data.data(), src, w, r);
+                copied += static_cast<size_t>(r.area()) * 4;
+            }
         }
-        std::memcpy(buf.data.data(), buffer, size);
         buf.width = w;
         buf.height = h;
+        buf.stale.clear();
+
+        // Opacity: a paint covering the frame decides it; a partial paint can
+        // only keep an opaque frame opaque (regaining it waits for a full paint).
+        // Sampled, not scanned: this runs on the CEF UI thread for every paint.
+        const auto* pixels = static_cast<const uint8_t*>(buffer);
+        DamageRect whole{0, 0, w, h};
+        DamageRect bounds = paint_damage.bounds(w, h);
+        bool covers = paint_damage.full() || (paint_damage.rects().size() == 1 &&
+                      bounds.width == w && bounds.height == h);
+        if (covers) {
+            paint_opaque = isOpaqueRectSampled(pixels, w, whole);
+        } else if (size_changed) {
+            paint_opaque = false;
+        } else if (paint_opaque) {
+            for (const auto& r : paint_damage.rects()) {
+                if (!isOpaqueRectSampled(pixels, w, r)) {
+                    paint_opaque = false;
+                    break;
+                }
+            }
+        }
+        buf.opaque = paint_opaque;
+        for (int i = 0; i < 3; i++) {
+            if (i == paint_write_idx) continue;
+            if (size_changed) {
+                paint_buffers[i].stale.setFull();
+            } else {
+                paint_buffers[i].stale.merge(paint_damage);
+            }
+        }
 
-        // Swap buffers (brief lock)
-        {
-            std::lock_guard<std::mutex> lock(paint_swap_mutex);
-            buf.dirty = true;
-            paint_write_idx.store(1 - write_idx, std::memory_order_release);
+        // Upload damage must also cover frames published but not yet taken,
+        // since a newer frame replaces them in the mailbox
+        if (!(paint_ready.load(std::memory_order_acquire) & kPaintFresh)) {
+            paint_pending.clear();
         }
+        if (size_changed) {
+            paint_pending.setFull();
+        } else {
+            paint_pending.merge(paint_damage);
+        }
+        buf.upload.clear();
+        buf.upload.merge(paint_pending);
+
+        // Publish: swap our slot into the mailbox and take back the previous one
+        uint8_t prev = paint_ready.exchange(static_cast<uint8_t>(paint_write_idx | kPaintFresh),
+                                            std::memory_order_acq_rel);
+        paint_write_idx = prev & kPaintIndexMask;
+        if (prev & kPaintFresh) {
+            paint_stats.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t paints = paint_stats.paints.fetch_add(1, std::memory_order_relaxed) + 1;
+        paint_stats.copied_bytes.fetch_add(copied, std::memory_order_relaxed);
+        paint_stats.frame_bytes.fetch_add(size, std::memory_order_relaxed);
+        LOG_VERBOSE(LOG_COMPOSITOR, "%s paint #%llu: damaged %lld / %zu bytes (%zu rects), copied %zu%s",
+                    name.c_str(), static_cast<unsigned long long>(paints),
+                    static_cast<long long>(paint_damage.area(w, h) * 4), size,
+                    paint_damage.full() ? size_t(1) : paint_damage.rects().size(), copied,
+                    (prev & kPaintFresh) ? ", dropped previous" : "");
 
         // Wake main loop to process the new frame
         if (wake_main_loop) {
@@ -72,14 +153,89 @@ std::function<void(const void*, int, int)> BrowserEntry::makePaintCallback() {
     };
 }
 
-void BrowserEntry::flushPaintBuffer() {
-    std::lock_guard<std::mutex> lock(paint_swap_mutex);
-    int read_idx = 1 - paint_write_idx.load(std::memory_order_acquire);
-    auto& buf = paint_buffers[read_idx];
-    if (buf.dirty && !buf.data.empty()) {
-        compositor->updateOverlayPartial(buf.data.data(), buf.width, buf.height);
-        buf.dirty = false;
+PopupCallback BrowserEntry::makePopupCallback() {
+    return [this](const CefRect& rect, const void* buffer, int w, int h) {
+        bool has_pixels = buffer && w > 0 && h > 0;
+        if (has_pixels) {
+            size_t size = static_cast<size_t>(w) * h * 4;
+            popup_paint.data.resize(size);
+            std::memcpy(popup_paint.data.data(), buffer, size);
+            popup_paint.width = w;
+            popup_paint.height = h;
+        }
+        {
+            std::lock_guard<std::mutex> lock(popup_mutex);
+            popup_rect = {rect.x, rect.y, rect.width, rect.height};
+            if (has_pixels) {
+                std::swap(popup_paint, popup_pending);
+                popup_pixels_pending = true;
+            }
+            popup_dirty.store(true, std::memory_order_release);
+        }
+        LOG_VERBOSE(LOG_COMPOSITOR, "%s popup %s %d,%d %dx%d", name.c_str(),
+                    has_pixels ? "paint" : "geometry", rect.x, rect.y, rect.width, rect.height);
+
+        if (wake_main_loop) {
+            wake_main_loop();
+        }
+    };
+}
+
+void BrowserEntry::flushPopup() {
+    if (!popup_dirty.load(std::memory_order_acquire)) {
+        return;
+    }
+    DamageRect rect;
+    bool has_pixels;
+    {
+        std::lock_guard<std::mutex> lock(popup_mutex);
+        rect = popup_rect;
+        has_pixels = popup_pixels_pending;
+        if (has_pixels) {
+            std::swap(popup_pending, popup_upload);
+            popup_pixels_pending = false;
+        }
+        popup_dirty.store(false, std::memory_order_relaxed);
     }
+    if (has_pixels) {
+        compositor->updatePopup(popup_upload.data.data(), popup_upload.width, popup_upload.height);
+    }
+    compositor->setPopupRect(rect);
+}
+
+size_t BrowserEntry::flushPaintBuffer() {
+    flushPopup();
+
+    // Take the newest published frame; only this thread clears kPaintFresh
+    if (!(paint_ready.load(std::memory_order_acquire) & kPaintFresh)) {
+        return 0;
+    }
+    uint8_t prev = paint_ready.exchange(static_cast<uint8_t>(paint_read_idx), std::memory_order_acq_rel);
+    paint_read_idx = prev & kPaintIndexMask;
+
+    // The slot is ours until the next exchange, so upload without holding anything
+    auto& buf = paint_buffers[paint_read_idx];
+    if (buf.data.empty()) {
+        return 0;
+    }
+    size_t uploaded = compositor->updateOverlayPartial(buf.data.data(), buf.width, buf.height,
+                                                      &buf.upload);
+    compositor->setOpaque(buf.opaque);
+
+    uint64_t total = paint_stats.uploaded_bytes.fetch_add(uploaded, std::memory_order_relaxed) + uploaded;
+    uint64_t paints = paint_stats.paints.load(std::memory_order_relaxed);
+    if (paints - last_stats_log >= 300) {
+        last_stats_log = paints;
+        uint64_t frame = paint_stats.frame_bytes.load(std::memory_order_relaxed);
+        uint64_t copied = paint_stats.copied_bytes.load(std::memory_order_relaxed);
+        uint64_t dropped = paint_stats.dropped.load(std::memory_order_relaxed);
+        LOG_DEBUG(LOG_COMPOSITOR, "%s paint stats: %llu paints (%llu dropped), copied %.1f MB, uploaded %.1f MB of %.1f MB full-frame (%.1f%%)",
+                  name.c_str(), static_cast<unsigned long long>(paints),
+                  static_cast<unsigned long long>(dropped),
+                  copied / 1048576.0, total / 1048576.0, frame / 1048576.0,
+                  frame ? 100.0 * total / frame : 0.0);
+    }
+    return uploaded;
 }
 
 void BrowserEntry::importQueued() {
@@ -174,14 +330,30 @@ BrowserLayer* BrowserStack::getInputLayer(const std::string& name) {
 PaintCallback BrowserStack::makePaintCallback(const std::string& name) {
     auto* entry = get(name);
     if (!entry) {
-        return [](const void*, int, int) {};  // no-op
+        return [](const void*, int, int, const CefRenderHandler::RectList&) {};  // no-op
     }
     return entry->makePaintCallback();
 }
 
 void BrowserStack::flushAll() {
+    using Clock = std::chrono::steady_clock;
+    flush_stats_ = {};
+    for (auto& entry : browsers_) {
+        auto t0 = Clock::now();
+        flush_stats_.uploaded_bytes += entry->flushPaintBuffer();
+        auto t1 = Clock::now();
+        entry->importQueued();
+        auto t2 = Clock::now();
+        entry->flushOverlay();
+        auto t3 = Clock::now();
+        flush_stats_.paint_ns += std::chrono::duration_cast<std::chrono::nanoseconds>((t1 - t0) + (t3 - t2)).count();
+        flush_stats_.import_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+    }
+}
+
+void BrowserStack::collectDamage(DamageRegion& out) {
     for (auto& entry : browsers_) {
-        entry->flushPaintBuffer();
+        entry->compositor->collectDamage(entry->alpha, out);
     }
 }
 
@@ -247,14 +419,58 @@ void BrowserStack::cleanupCompositors() {
 }
 
 void BrowserStack::renderAll(int width, int height) {
+    flushAll();
+    compositeAll(width, height);
+}
+
+void BrowserStack::compositeAll(int width, int height) {
+    composite_stats_ = {};
+    composite_stats_.layers = static_cast<int>(browsers_.size());
+#ifdef __APPLE__
+    // Each browser presents its own CAMetalLayer
     for (auto& entry : browsers_) {
-        entry->flushPaintBuffer();
-        entry->importQueued();
-        entry->flushOverlay();
         if (entry->compositor->hasValidOverlay() || entry->compositor->hasPendingContent()) {
             entry->compositor->composite(width, height, entry->alpha);
+            composite_stats_.drawn++;
+            composite_stats_.draws++;
         }
     }
+#else
+    // Nothing beneath the topmost layer that opaquely covers the window shows through
+    size_t first = 0;
+    for (size_t i = browsers_.size(); i-- > 0;) {
+        auto& entry = browsers_[i];
+        if (entry->compositor->hasValidOverlay() &&
+            entry->compositor->coversView(entry->alpha, width, height)) {
+            first = i;
+            break;
+        }
+    }
+
+    composite_layers_.clear();
+    for (size_t i = 0; i < browsers_.size(); i++) {
+        auto& entry = browsers_[i];
+        if (!entry->compositor->hasValidOverlay() && !entry->compositor->hasPendingContent()) {
+            composite_stats_.skipped_empty++;
+            entry->compositor->skipComposite();
+        } else if (i < first) {
+            composite_stats_.skipped_occluded++;
+            entry->compositor->skipComposite();
+        } else if (entry->alpha <= 0.0f) {
+            composite_stats_.skipped_transparent++;
+            entry->compositor->skipComposite();
+        } else {
+            composite_layers_.push_back({entry->compositor.get(), entry->alpha});
+        }
+    }
+    composite_stats_.drawn = static_cast<int>(composite_layers_.size());
+    composite_stats_.draws = Compositor::compositeLayers(composite_layers_.data(), composite_stats_.drawn,
+                                                         width, height);
+#endif
+    LOG_VERBOSE(LOG_COMPOSITOR, "composite: %d layers, %d drawn in %d draws, skipped %d empty / %d transparent / %d occluded",
+                composite_stats_.layers, composite_stats_.drawn, composite_stats_.draws,
+                composite_stats_.skipped_empty, composite_stats_.skipped_transparent,
+                composite_stats_.skipped_occluded);
 }
 
 bool BrowserStack::anyHasPendingContent() const {
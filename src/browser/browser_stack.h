@@ -11,7 +11,9 @@
 #include <cstdint>
 
 #include "include/cef_client.h"
+#include "include/cef_render_handler.h"
 #include "../input/browser_layer.h"
+#include "../compositor/damage_rect.h"
 
 #ifdef __APPLE__
 #include "../compositor/metal_compositor.h"
@@ -42,14 +44,39 @@ struct CompositorContext {
 #endif
 };
 
-// Paint buffer for double-buffered CEF paint callbacks
+// Paint buffer slot for the triple-buffered CEF paint handoff
 struct PaintBuffer {
     std::vector<uint8_t> data;
     int width = 0;
     int height = 0;
-    bool dirty = false;
+    DamageRegion stale;   // Painted into other slots since this one was last written (CEF thread only)
+    DamageRegion upload;  // Damage since the last frame the GL thread took (published with the slot)
+    bool opaque = false;  // Every pixel has alpha 255 (lets the compositor cull layers beneath)
 };
 
+// Paint/upload byte counters (damaged vs full-frame) for telemetry
+struct PaintStats {
+    std::atomic<uint64_t> paints{0};
+    std::atomic<uint64_t> copied_bytes{0};    // Bytes memcpy'd into paint buffers
+    std::atomic<uint64_t> uploaded_bytes{0};  // Bytes uploaded to the compositor
+    std::atomic<uint64_t> frame_bytes{0};     // Full-frame bytes for the same paints
+    std::atomic<uint64_t> dropped{0};         // Frames replaced in the mailbox before upload
+};
+
+// Callback type for paint events (dirty rects empty = whole frame)
+using PaintCallback = std::function<void(const void* buffer, int width, int height,
+                                         const CefRenderHandler::RectList& dirtyRects)>;
+
+// Popup (PET_POPUP) pixels handed from the CEF thread to the GL thread
+struct PopupBuffer {
+    std::vector<uint8_t> data;
+    int width = 0;
+    int height = 0;
+};
+
+// Callback type for popup layer updates (rect empty = hidden, buffer null = geometry only)
+using PopupCallback = std::function<void(const CefRect& rect, const void* buffer, int width, int height)>;
+
 // Per-browser state container
 struct BrowserEntry {
     std::string name;
@@ -59,9 +86,29 @@ struct BrowserEntry {
     std::function<InputReceiver*()> getInputReceiver;  // set at creation, returns input receiver
     std::function<bool()> isClosed;  // set at creation, returns true when browser is closed
     std::unique_ptr<BrowserLayer> input_layer;
-    std::array<PaintBuffer, 2> paint_buffers;
-    std::atomic<int> paint_write_idx{0};
-    std::mutex paint_swap_mutex;
+    // Triple-buffered paint mailbox: CEF thread owns the write slot, GL thread
+    // owns the read slot, and the ready slot is exchanged atomically so neither
+    // side ever waits. paint_ready holds the slot index plus kPaintFresh when it
+    // carries a frame the GL thread has not taken yet.
+    static constexpr uint8_t kPaintIndexMask = 0x3;
+    static constexpr uint8_t kPaintFresh = 0x4;
+    std::array<PaintBuffer, 3> paint_buffers;
+    int paint_write_idx = 0;               // CEF thread only
+    int paint_read_idx = 2;                // GL thread only
+    std::atomic<uint8_t> paint_ready{1};
+    DamageRegion paint_damage;   // Scratch for the current paint (CEF thread only)
+    DamageRegion paint_pending;  // Damage published but possibly not yet taken (CEF thread only)
+    bool paint_opaque = false;   // Latest paint is known to be fully opaque (CEF thread only)
+    // Popup layer: buffers are swapped under popup_mutex, never copied or uploaded under it
+    std::mutex popup_mutex;
+    PopupBuffer popup_paint;    // CEF thread only
+    PopupBuffer popup_pending;  // guarded by popup_mutex
+    PopupBuffer popup_upload;   // GL thread only
+    DamageRect popup_rect;      // guarded by popup_mutex (empty = hidden)
+    bool popup_pixels_pending = false;     // guarded by popup_mutex
+    std::atomic<bool> popup_dirty{false};  // Fast-path check without mutex
+    PaintStats paint_stats;
+    uint64_t last_stats_log = 0;  // paint count at last stats log (main thread)
     std::unique_ptr<Compositor> compositor;  // owned
     float alpha = 1.0f;
     std::function<void()> wake_main_loop;  // Called after paint to wake main loop
@@ -80,10 +127,17 @@ struct BrowserEntry {
     void resize(int width, int height);
 
     // Create paint callback for CEF
-    std::function<void(const void*, int, int)> makePaintCallback();
+    PaintCallback makePaintCallback();
+
+    // Create popup layer callback for CEF
+    PopupCallback makePopupCallback();
 
-    // Flush dirty paint buffer to compositor
-    void flushPaintBuffer();
+    // Upload the newest completed paint (if any) to the compositor.
+    // Returns bytes uploaded.
+    size_t flushPaintBuffer();
+
+    // Hand popup geometry/pixels to the compositor
+    void flushPopup();
 
     // Platform-specific compositor operations
     void importQueued();   // importQueuedIOSurface (macOS) / importQueuedDmabuf (Linux)
@@ -96,9 +150,6 @@ struct BrowserEntry {
     void forceRepaint();
 };
 
-// Callback type for paint events
-using PaintCallback = std::function<void(const void* buffer, int width, int height)>;
-
 // Manages all browsers in z-order (back to front)
 class BrowserStack {
 public:
@@ -113,7 +164,29 @@ public:
 
     // Paint management
     PaintCallback makePaintCallback(const std::string& name);
-    void flushAll();  // flush all dirty paint buffers to compositors
+    void flushAll();  // flush paint buffers, popups, and GPU imports to compositors
+
+    // Time spent in the last flushAll, by step
+    struct FlushStats {
+        uint64_t paint_ns = 0;        // flushPaintBuffer + flushOverlay (CPU paint uploads)
+        uint64_t import_ns = 0;       // importQueued (dmabuf / IOSurface)
+        uint64_t uploaded_bytes = 0;  // Paint pixels uploaded
+    };
+    const FlushStats& flushStats() const { return flush_stats_; }
+
+    // Merge window damage from every compositor since the last call (call after flushAll)
+    void collectDamage(DamageRegion& out);
+
+    // Layer counts for the last compositeAll
+    struct CompositeStats {
+        int layers = 0;               // Browsers in the stack
+        int drawn = 0;                // Layers blended into the frame
+        int draws = 0;                // Draw calls issued
+        int skipped_empty = 0;        // No content yet
+        int skipped_transparent = 0;  // alpha 0 (e.g. faded-out overlay)
+        int skipped_occluded = 0;     // Beneath an opaque layer covering the window
+    };
+    const CompositeStats& compositeStats() const { return composite_stats_; }
 
     // Visibility (for fade animation before removal)
     void setAlpha(const std::string& name, float alpha);
@@ -144,6 +217,9 @@ public:
     // Flush paint buffers, import GPU textures, and composite all visible browsers
     void renderAll(int width, int height);
 
+    // Composite all visible browsers without flushing (back-to-front order)
+    void compositeAll(int width, int height);
+
     // Check if stack is empty
     bool empty() const { return browsers_.empty(); }
 
@@ -156,4 +232,9 @@ public:
 private:
     std::vector<std::unique_ptr<BrowserEntry>> browsers_;  // z-order: back to front
     std::unordered_map<std::string, BrowserEntry*> by_name_;
+    CompositeStats composite_stats_;
+    FlushStats flush_stats_;
+#ifndef __APPLE__
+    std::vector<Compositor::Layer> composite_layers_;  // Reused each frame
+#endif
 };
@@ -5,9 +5,17 @@
 #include "include/cef_browser.h"
 #include "include/cef_command_line.h"
 #include "include/cef_frame.h"
+#include "include/cef_shared_process_message_builder.h"
+#include "include/cef_task.h"
+#include "player/media_session.h"
+#include "player/player_state_mirror.h"
 #include <cstring>
+#include <map>
 #include "logging.h"
 
+// Carries the player state mirror name to renderer processes
+static constexpr const char* kPlayerStateSwitch = "player-state-shm";
+
 void App::OnBeforeCommandLineProcessing(const CefString& process_type,
                                         CefRefPtr<CefCommandLine> command_line) {
     // Disable all Google services
@@ -61,6 +69,12 @@ void App::OnContextInitialized() {
     CefRegisterSchemeHandlerFactory("app", "", new EmbeddedSchemeHandlerFactory());
 }
 
+void App::OnBeforeChildProcessLaunch(CefRefPtr<CefCommandLine> command_line) {
+    if (!player_state_mirror_.empty()) {
+        command_line->AppendSwitchWithValue(kPlayerStateSwitch, player_state_mirror_);
+    }
+}
+
 void App::OnScheduleMessagePumpWork(int64_t delay_ms) {
     // Called by CEF (from any thread) when it needs CefDoMessageLoopWork()
     if (delay_ms <= 0) {
@@ -109,6 +123,117 @@ void App::DoWork() {
     }
 }
 
+// Handlers registered by the page through jmpNative.setPushHandlers(), per
+// browser (renderer thread only)
+struct JsPushTarget {
+    CefRefPtr<CefV8Context> context;
+    CefRefPtr<CefV8Value> handlers[kJsPushOpCount];
+};
+static std::map<int, JsPushTarget> s_push_targets;
+
+// Renderer side of the player state mirror, mapped on first use
+static PlayerStateMirror s_state_mirror;
+static bool s_state_mirror_tried = false;
+
+static PlayerStateMirror& stateMirror(const std::string& in_process_name) {
+    if (!s_state_mirror_tried) {
+        s_state_mirror_tried = true;
+        // Single-process mode (macOS) has no switch but shares the name
+        std::string name = CefCommandLine::GetGlobalCommandLine()->GetSwitchValue(kPlayerStateSwitch).ToString();
+        if (name.empty()) name = in_process_name;
+        if (!name.empty() && !s_state_mirror.open(name)) {
+            LOG_WARN(LOG_CEF, "Player state mirror %s unavailable", name.c_str());
+        }
+    }
+    return s_state_mirror;
+}
+
+// jmpNative.playerState: getters read the newest snapshot from the mirror
+class PlayerStateAccessor : public CefV8Accessor {
+public:
+    explicit PlayerStateAccessor(PlayerStateMirror& mirror) : mirror_(mirror) {}
+
+    bool Get(const CefString& name,
+             const CefRefPtr<CefV8Value> object,
+             CefRefPtr<CefV8Value>& retval,
+             CefString& exception) override {
+        PlayerStateSnapshot state;
+        bool valid = mirror_.read(state);
+        std::string key = name.ToString();
+        if (key == "valid") {
+            retval = CefV8Value::CreateBool(valid);
+        } else if (!valid) {
+            retval = CefV8Value::CreateNull();
+        } else if (key == "position") {
+            retval = CefV8Value::CreateDouble(state.position_ms);
+        } else if (key == "duration") {
+            retval = CefV8Value::CreateDouble(state.duration_ms);
+        } else if (key == "paused") {
+            retval = CefV8Value::CreateBool(state.paused);
+        } else if (key == "buffering") {
+            retval = CefV8Value::CreateBool(state.buffering);
+        } else if (key == "rate") {
+            retval = CefV8Value::CreateDouble(state.rate);
+        } else if (key == "volume") {
+            retval = CefV8Value::CreateInt(state.volume);
+        } else if (key == "muted") {
+            retval = CefV8Value::CreateBool(state.muted);
+        } else if (key == "bufferedRanges") {
+            CefRefPtr<CefV8Value> ranges = CefV8Value::CreateArray(state.range_count);
+            for (int i = 0; i < state.range_count; i++) {
+                CefRefPtr<CefV8Value> range = CefV8Value::CreateObject(nullptr, nullptr);
+                range->SetValue("start", CefV8Value::CreateDouble(static_cast<double>(state.ranges[i].start)), V8_PROPERTY_ATTRIBUTE_NONE);
+                range->SetValue("end", CefV8Value::CreateDouble(static_cast<double>(state.ranges[i].end)), V8_PROPERTY_ATTRIBUTE_NONE);
+                ranges->SetValue(i, range);
+            }
+            retval = ranges;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool Set(const CefString& name,
+             const CefRefPtr<CefV8Value> object,
+             const CefRefPtr<CefV8Value> value,
+             CefString& exception) override {
+        return false;  // Read-only
+    }
+
+private:
+    PlayerStateMirror& mirror_;
+    IMPLEMENT_REFCOUNTING(PlayerStateAccessor);
+};
+
+static const char* const kPlayerStateProperties[] = {
+    "valid", "position", "duration", "paused", "buffering", "rate", "volume", "muted", "bufferedRanges",
+};
+
+// jmpNative player functions, sent to the browser process as PlayerCommands
+static const struct {
+    const char* name;
+    PlayerOp op;
+} kPlayerFunctions[] = {
+    {"playerLoad", PlayerOp::Load},
+    {"playerStop", PlayerOp::Stop},
+    {"playerPause", PlayerOp::Pause},
+    {"playerPlay", PlayerOp::Play},
+    {"playerSeek", PlayerOp::Seek},
+    {"playerSetVolume", PlayerOp::Volume},
+    {"playerSetMuted", PlayerOp::Mute},
+    {"playerSetSpeed", PlayerOp::Speed},
+    {"playerSetSubtitle", PlayerOp::Subtitle},
+    {"playerSetAudio", PlayerOp::Audio},
+    {"playerSetAudioDelay", PlayerOp::AudioDelay},
+    {"notifyMetadata", PlayerOp::MediaMetadata},
+    {"notifyPosition", PlayerOp::MediaPosition},
+    {"notifySeek", PlayerOp::MediaSeeked},
+    {"notifyPlaybackState", PlayerOp::MediaState},
+    {"notifyArtwork", PlayerOp::MediaArtwork},
+    {"notifyQueueChange", PlayerOp::MediaQueue},
+    {"notifyRateChange", PlayerOp::MediaNotifyRate},
+};
+
 void App::OnContextCreated(CefRefPtr<CefBrowser> browser,
                            CefRefPtr<CefFrame> frame,
                            CefRefPtr<CefV8Context> context) {
@@ -119,32 +244,26 @@ void App::OnContextCreated(CefRefPtr<CefBrowser> browser,
 
     CefRefPtr<CefV8Value> window = context->GetGlobal();
     CefRefPtr<NativeV8Handler> handler = new NativeV8Handler(browser);
+    CefRefPtr<PlayerIpcSender> sender = new PlayerIpcSender(browser);
 
     // Create window.jmpNative for native calls
     CefRefPtr<CefV8Value> jmpNative = CefV8Value::CreateObject(nullptr, nullptr);
-    jmpNative->SetValue("playerLoad", CefV8Value::CreateFunction("playerLoad", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerStop", CefV8Value::CreateFunction("playerStop", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerPause", CefV8Value::CreateFunction("playerPause", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerPlay", CefV8Value::CreateFunction("playerPlay", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSeek", CefV8Value::CreateFunction("playerSeek", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSetVolume", CefV8Value::CreateFunction("playerSetVolume", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSetMuted", CefV8Value::CreateFunction("playerSetMuted", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSetSpeed", CefV8Value::CreateFunction("playerSetSpeed", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSetSubtitle", CefV8Value::CreateFunction("playerSetSubtitle", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSetAudio", CefV8Value::CreateFunction("playerSetAudio", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("playerSetAudioDelay", CefV8Value::CreateFunction("playerSetAudioDelay", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+    for (const auto& fn : kPlayerFunctions) {
+        jmpNative->SetValue(fn.name, CefV8Value::CreateFunction(fn.name, new PlayerV8Handler(fn.op, sender)),
+                            V8_PROPERTY_ATTRIBUTE_READONLY);
+    }
     jmpNative->SetValue("saveServerUrl", CefV8Value::CreateFunction("saveServerUrl", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
     jmpNative->SetValue("loadServer", CefV8Value::CreateFunction("loadServer", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
     jmpNative->SetValue("checkServerConnectivity", CefV8Value::CreateFunction("checkServerConnectivity", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifyMetadata", CefV8Value::CreateFunction("notifyMetadata", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifyPosition", CefV8Value::CreateFunction("notifyPosition", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifySeek", CefV8Value::CreateFunction("notifySeek", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifyPlaybackState", CefV8Value::CreateFunction("notifyPlaybackState", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifyArtwork", CefV8Value::CreateFunction("notifyArtwork", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifyQueueChange", CefV8Value::CreateFunction("notifyQueueChange", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
-    jmpNative->SetValue("notifyRateChange", CefV8Value::CreateFunction("notifyRateChange", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
     jmpNative->SetValue("setClipboard", CefV8Value::CreateFunction("setClipboard", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
     jmpNative->SetValue("getClipboard", CefV8Value::CreateFunction("getClipboard", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+    jmpNative->SetValue("setPushHandlers", CefV8Value::CreateFunction("setPushHandlers", handler), V8_PROPERTY_ATTRIBUTE_READONLY);
+    CefRefPtr<CefV8Value> playerState =
+        CefV8Value::CreateObject(new PlayerStateAccessor(stateMirror(player_state_mirror_)), nullptr);
+    for (const char* prop : kPlayerStateProperties) {
+        playerState->SetValue(prop, V8_PROPERTY_ATTRIBUTE_READONLY);
+    }
+    jmpNative->SetValue("playerState", playerState, V8_PROPERTY_ATTRIBUTE_READONLY);
     window->SetValue("jmpNative", jmpNative, V8_PROPERTY_ATTRIBUTE_READONLY);
 
     // Inject the JavaScript shim that creates window.api, window.NativeShell, etc.
@@ -165,12 +284,77 @@ void App::OnContextCreated(CefRefPtr<CefBrowser> browser,
     frame->ExecuteJavaScript(embedded_js.at("input-plugin.js"), frame->GetURL(), 0);
 }
 
+void App::OnContextReleased(CefRefPtr<CefBrowser> browser,
+                            CefRefPtr<CefFrame> frame,
+                            CefRefPtr<CefV8Context> context) {
+    auto it = s_push_targets.find(browser->GetIdentifier());
+    if (it != s_push_targets.end() && it->second.context->IsSame(context)) {
+        s_push_targets.erase(it);
+    }
+}
+
+// Call the page's handler for a browser push with the message's arguments
+// converted to V8 values
+static void dispatchJsPush(CefRefPtr<CefBrowser> browser, CefRefPtr<CefListValue> args) {
+    int op = args->GetInt(0);
+    if (op < 0 || op >= static_cast<int>(kJsPushOpCount)) return;
+    auto it = s_push_targets.find(browser->GetIdentifier());
+    if (it == s_push_targets.end()) return;  // Page hasn't registered yet
+    JsPushTarget& target = it->second;
+    CefRefPtr<CefV8Value> fn = target.handlers[op];
+    if (!fn) return;
+
+    if (!target.context->Enter()) return;
+    CefV8ValueList v8args;
+    switch (static_cast<JsPushOp>(op)) {
+    case JsPushOp::Error:
+    case JsPushOp::HostInput:
+        v8args.push_back(CefV8Value::CreateString(args->GetString(1)));
+        break;
+    case JsPushOp::RateChanged:
+    case JsPushOp::Position:
+    case JsPushOp::Duration:
+        v8args.push_back(CefV8Value::CreateDouble(args->GetDouble(1)));
+        break;
+    case JsPushOp::Seek:
+        v8args.push_back(CefV8Value::CreateInt(args->GetInt(1)));
+        break;
+    case JsPushOp::BufferedRanges: {
+        // [{start, end}, ...] as the page expects
+        int count = static_cast<int>((args->GetSize() - 1) / 2);
+        CefRefPtr<CefV8Value> ranges = CefV8Value::CreateArray(count);
+        for (int i = 0; i < count; i++) {
+            CefRefPtr<CefV8Value> range = CefV8Value::CreateObject(nullptr, nullptr);
+            range->SetValue("start", CefV8Value::CreateDouble(args->GetDouble(1 + i * 2)), V8_PROPERTY_ATTRIBUTE_NONE);
+            range->SetValue("end", CefV8Value::CreateDouble(args->GetDouble(2 + i * 2)), V8_PROPERTY_ATTRIBUTE_NONE);
+            ranges->SetValue(i, range);
+        }
+        v8args.push_back(ranges);
+        break;
+    }
+    default:
+        break;
+    }
+    fn->ExecuteFunction(nullptr, v8args);
+    if (fn->HasException()) {
+        LOG_WARN(LOG_CEF, "JS push handler %s threw: %s", kJsPushHandlerNames[op],
+                 fn->GetException()->GetMessage().ToString().c_str());
+        fn->ClearException();
+    }
+    target.context->Exit();
+}
+
 bool App::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
                                    CefRefPtr<CefFrame> frame,
                                    CefProcessId source_process,
                                    CefRefPtr<CefProcessMessage> message) {
     std::string name = message->GetName().ToString();
 
+    if (name == kJsPushMessage) {
+        dispatchJsPush(browser, message->GetArgumentList());
+        return true;
+    }
+
     if (name == "serverConnectivityResult") {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string url = args->GetString(0).ToString();
@@ -202,209 +386,165 @@ bool App::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
     return false;
 }
 
-// V8 handler implementation - sends IPC messages to browser process
-bool NativeV8Handler::Execute(const CefString& name,
-                              CefRefPtr<CefV8Value> object,
-                              const CefV8ValueList& arguments,
-                              CefRefPtr<CefV8Value>& retval,
-                              CefString& exception) {
-    LOG_DEBUG(LOG_CEF, "V8 Execute: %s", name.ToString().c_str());
-
-    // playerLoad(url, startMs, audioIdx, subIdx, metadataJson)
-    if (name == "playerLoad") {
-        if (arguments.size() >= 1 && arguments[0]->IsString()) {
-            std::string url = arguments[0]->GetStringValue().ToString();
-            int startMs = arguments.size() > 1 && arguments[1]->IsInt() ? arguments[1]->GetIntValue() : 0;
-            int audioIdx = arguments.size() > 2 && arguments[2]->IsInt() ? arguments[2]->GetIntValue() : -1;
-            int subIdx = arguments.size() > 3 && arguments[3]->IsInt() ? arguments[3]->GetIntValue() : -1;
-            std::string metadataJson = arguments.size() > 4 && arguments[4]->IsString() ? arguments[4]->GetStringValue().ToString() : "{}";
-
-            LOG_DEBUG(LOG_CEF, "V8 playerLoad: %s startMs=%d", url.c_str(), startMs);
-
-            // Send IPC message to browser process
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerLoad");
-            CefRefPtr<CefListValue> args = msg->GetArgumentList();
-            args->SetString(0, url);
-            args->SetInt(1, startMs);
-            args->SetInt(2, audioIdx);
-            args->SetInt(3, subIdx);
-            args->SetString(4, metadataJson);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
-    }
-
-    if (name == "playerStop") {
-        LOG_DEBUG(LOG_CEF, "V8 playerStop");
-        CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerStop");
-        browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        return true;
-    }
-
-    if (name == "playerPause") {
-        LOG_DEBUG(LOG_CEF, "V8 playerPause");
-        CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerPause");
-        browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        return true;
-    }
-
-    if (name == "playerPlay") {
-        LOG_DEBUG(LOG_CEF, "V8 playerPlay (unpause)");
-        CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerPlay");
-        browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        return true;
-    }
-
-    if (name == "playerSeek") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int64_t ms = arguments[0]->GetIntValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSeek: %ldms", (long)ms);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSeek");
-            msg->GetArgumentList()->SetInt(0, static_cast<int>(ms));
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
-    }
-
-    if (name == "playerSetVolume") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int vol = arguments[0]->GetIntValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSetVolume: %d", vol);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSetVolume");
-            msg->GetArgumentList()->SetInt(0, vol);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
+class PlayerIpcFlushTask : public CefTask {
+public:
+    explicit PlayerIpcFlushTask(CefRefPtr<PlayerIpcSender> sender) : sender_(sender) {}
+    void Execute() override { sender_->flush(); }
+
+private:
+    CefRefPtr<PlayerIpcSender> sender_;
+    IMPLEMENT_REFCOUNTING(PlayerIpcFlushTask);
+};
+
+void PlayerIpcSender::post(const PlayerCommand& cmd) {
+    batch_.add(cmd);
+    if (!flush_posted_) {
+        // Runs after the current JS task, so calls made together (e.g. a
+        // timeupdate handler reporting position, rate and state) share a message
+        flush_posted_ = CefPostTask(TID_RENDERER, new PlayerIpcFlushTask(this));
+        if (!flush_posted_) flush();
     }
+}
 
-    if (name == "playerSetMuted") {
-        if (arguments.size() >= 1 && arguments[0]->IsBool()) {
-            bool muted = arguments[0]->GetBoolValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSetMuted: %d", muted);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSetMuted");
-            msg->GetArgumentList()->SetBool(0, muted);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
+void PlayerIpcSender::flush() {
+    flush_posted_ = false;
+    if (batch_.empty()) return;
+
+    size_t size = batch_.size();
+    CefRefPtr<CefSharedProcessMessageBuilder> builder =
+        CefSharedProcessMessageBuilder::Create(kPlayerBatchMessage, size);
+    if (!builder || !builder->IsValid()) {
+        LOG_ERROR(LOG_CEF, "Player IPC: failed to allocate %zu byte batch, dropping %zu commands",
+                  size, batch_.count());
+        batch_.clear();
+        return;
     }
+    std::memcpy(builder->Memory(), batch_.data(), size);
+    batch_.clear();
 
-    if (name == "playerSetSpeed") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int rateX1000 = arguments[0]->GetIntValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSetSpeed: %d", rateX1000);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSetSpeed");
-            msg->GetArgumentList()->SetInt(0, rateX1000);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
+    CefRefPtr<CefFrame> frame = browser_->GetMainFrame();
+    if (frame) {
+        frame->SendProcessMessage(PID_BROWSER, builder->Build());
     }
+}
 
-    if (name == "playerSetSubtitle") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int sid = arguments[0]->GetIntValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSetSubtitle: %d", sid);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSetSubtitle");
-            msg->GetArgumentList()->SetInt(0, sid);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+// V8 handler for player functions - parses arguments into a PlayerCommand
+bool PlayerV8Handler::Execute(const CefString& name,
+                              CefRefPtr<CefV8Value> object,
+                              const CefV8ValueList& arguments,
+                              CefRefPtr<CefV8Value>& retval,
+                              CefString& exception) {
+    auto isInt = [&](size_t i) { return arguments.size() > i && arguments[i]->IsInt(); };
+    auto isBool = [&](size_t i) { return arguments.size() > i && arguments[i]->IsBool(); };
+    auto isDouble = [&](size_t i) { return arguments.size() > i && arguments[i]->IsDouble(); };
+    auto isString = [&](size_t i) { return arguments.size() > i && arguments[i]->IsString(); };
+    auto str = [&](size_t i) { return arguments[i]->GetStringValue().ToString(); };
+
+    switch (op_) {
+    case PlayerOp::Load: {
+        // playerLoad(url, startMs, audioIdx, subIdx, metadataJson)
+        if (!isString(0)) break;
+        std::string url = str(0);
+        int startMs = isInt(1) ? arguments[1]->GetIntValue() : 0;
+        int audioIdx = isInt(2) ? arguments[2]->GetIntValue() : -1;
+        int subIdx = isInt(3) ? arguments[3]->GetIntValue() : -1;
+        std::string metadata = isString(4) ? str(4) : "{}";
+        LOG_DEBUG(LOG_CEF, "V8 playerLoad: %s startMs=%d", url.c_str(), startMs);
+
+        // Encode track indices in metadata JSON
+        std::string prefix = "{";
+        if (audioIdx >= 0) prefix += "\"_audioIdx\":" + std::to_string(audioIdx) + ",";
+        if (subIdx >= 0) prefix += "\"_subIdx\":" + std::to_string(subIdx) + ",";
+        if (prefix.size() > 1 && metadata.size() > 1) {
+            metadata = prefix + metadata.substr(1);
         }
-        return true;
+        sender_->post(PlayerCommand::makeText(op_, std::move(url), startMs, std::move(metadata)));
+        break;
     }
-
-    if (name == "playerSetAudio") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int aid = arguments[0]->GetIntValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSetAudio: %d", aid);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSetAudio");
-            msg->GetArgumentList()->SetInt(0, aid);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+    case PlayerOp::Stop:
+    case PlayerOp::Pause:
+    case PlayerOp::Play:
+    case PlayerOp::PlayPause:
+        LOG_DEBUG(LOG_CEF, "V8 %s", name.ToString().c_str());
+        sender_->post(PlayerCommand::make(op_));
+        break;
+    case PlayerOp::Seek:
+    case PlayerOp::Volume:
+    case PlayerOp::Speed:       // rate * 1000
+    case PlayerOp::Subtitle:
+    case PlayerOp::Audio:
+    case PlayerOp::MediaPosition:
+    case PlayerOp::MediaSeeked:
+        if (isInt(0)) {
+            sender_->post(PlayerCommand::make(op_, arguments[0]->GetIntValue()));
         }
-        return true;
-    }
-
-    if (name == "playerSetAudioDelay") {
-        if (arguments.size() >= 1 && arguments[0]->IsDouble()) {
-            double delay = arguments[0]->GetDoubleValue();
-            LOG_DEBUG(LOG_CEF, "V8 playerSetAudioDelay: %.2f", delay);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("playerSetAudioDelay");
-            msg->GetArgumentList()->SetDouble(0, delay);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+        break;
+    case PlayerOp::Mute:
+        if (isBool(0)) {
+            sender_->post(PlayerCommand::make(op_, arguments[0]->GetBoolValue() ? 1 : 0));
         }
-        return true;
-    }
-
-    if (name == "notifyMetadata") {
-        if (arguments.size() >= 1 && arguments[0]->IsString()) {
-            std::string metadata = arguments[0]->GetStringValue().ToString();
-            LOG_DEBUG(LOG_CEF, "V8 notifyMetadata: %.100s...", metadata.c_str());
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifyMetadata");
-            msg->GetArgumentList()->SetString(0, metadata);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+        break;
+    case PlayerOp::AudioDelay:
+    case PlayerOp::MediaNotifyRate:
+        if (isDouble(0)) {
+            LOG_DEBUG(LOG_CEF, "V8 %s: %.2f", name.ToString().c_str(), arguments[0]->GetDoubleValue());
+            sender_->post(PlayerCommand::makeDouble(op_, arguments[0]->GetDoubleValue()));
         }
-        return true;
-    }
-
-    if (name == "notifyPosition") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int posMs = arguments[0]->GetIntValue();
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifyPosition");
-            msg->GetArgumentList()->SetInt(0, posMs);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
-    }
-
-    if (name == "notifySeek") {
-        if (arguments.size() >= 1 && arguments[0]->IsInt()) {
-            int posMs = arguments[0]->GetIntValue();
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifySeek");
-            msg->GetArgumentList()->SetInt(0, posMs);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+        break;
+    case PlayerOp::MediaMetadata:
+    case PlayerOp::MediaArtwork:
+        if (isString(0)) {
+            std::string text = str(0);
+            LOG_DEBUG(LOG_CEF, "V8 %s: %.50s...", name.ToString().c_str(), text.c_str());
+            sender_->post(PlayerCommand::makeText(op_, std::move(text)));
         }
-        return true;
-    }
-
-    if (name == "notifyPlaybackState") {
-        if (arguments.size() >= 1 && arguments[0]->IsString()) {
-            std::string state = arguments[0]->GetStringValue().ToString();
+        break;
+    case PlayerOp::MediaState:
+        if (isString(0)) {
+            std::string state = str(0);
             LOG_DEBUG(LOG_CEF, "V8 notifyPlaybackState: %s", state.c_str());
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifyPlaybackState");
-            msg->GetArgumentList()->SetString(0, state);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+            PlaybackState ps = state == "Playing" ? PlaybackState::Playing
+                             : state == "Paused" ? PlaybackState::Paused
+                             : PlaybackState::Stopped;
+            sender_->post(PlayerCommand::make(op_, static_cast<int>(ps)));
         }
-        return true;
-    }
-
-    if (name == "notifyArtwork") {
-        if (arguments.size() >= 1 && arguments[0]->IsString()) {
-            std::string artworkUri = arguments[0]->GetStringValue().ToString();
-            LOG_DEBUG(LOG_CEF, "V8 notifyArtwork: %.50s...", artworkUri.c_str());
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifyArtwork");
-            msg->GetArgumentList()->SetString(0, artworkUri);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+        break;
+    case PlayerOp::MediaQueue:
+        if (isBool(0) && isBool(1)) {
+            // bit 0 = canNext, bit 1 = canPrev
+            int flags = (arguments[0]->GetBoolValue() ? 1 : 0) | (arguments[1]->GetBoolValue() ? 2 : 0);
+            sender_->post(PlayerCommand::make(op_, flags));
         }
-        return true;
+        break;
+    default:
+        return false;
     }
+    return true;
+}
 
-    if (name == "notifyQueueChange") {
-        if (arguments.size() >= 2 && arguments[0]->IsBool() && arguments[1]->IsBool()) {
-            bool canNext = arguments[0]->GetBoolValue();
-            bool canPrev = arguments[1]->GetBoolValue();
-            LOG_DEBUG(LOG_CEF, "V8 notifyQueueChange: canNext=%d canPrev=%d", canNext, canPrev);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifyQueueChange");
-            msg->GetArgumentList()->SetBool(0, canNext);
-            msg->GetArgumentList()->SetBool(1, canPrev);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
-        }
-        return true;
-    }
+// V8 handler implementation - sends IPC messages to browser process
+bool NativeV8Handler::Execute(const CefString& name,
+                              CefRefPtr<CefV8Value> object,
+                              const CefV8ValueList& arguments,
+                              CefRefPtr<CefV8Value>& retval,
+                              CefString& exception) {
+    LOG_DEBUG(LOG_CEF, "V8 Execute: %s", name.ToString().c_str());
 
-    if (name == "notifyRateChange") {
-        if (arguments.size() >= 1 && arguments[0]->IsDouble()) {
-            double rate = arguments[0]->GetDoubleValue();
-            LOG_DEBUG(LOG_CEF, "V8 notifyRateChange: %.2f", rate);
-            CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create("notifyRateChange");
-            msg->GetArgumentList()->SetDouble(0, rate);
-            browser_->GetMainFrame()->SendProcessMessage(PID_BROWSER, msg);
+    // setPushHandlers({playing: fn, position: fn, ...}) - see js_push.h
+    if (name == "setPushHandlers") {
+        if (arguments.size() >= 1 && arguments[0]->IsObject()) {
+            JsPushTarget target;
+            target.context = CefV8Context::GetCurrentContext();
+            int bound = 0;
+            for (size_t i = 0; i < kJsPushOpCount; i++) {
+                CefRefPtr<CefV8Value> fn = arguments[0]->GetValue(kJsPushHandlerNames[i]);
+                if (fn && fn->IsFunction()) {
+                    target.handlers[i] = fn;
+                    bound++;
+                }
+            }
+            LOG_DEBUG(LOG_CEF, "V8 setPushHandlers: %d of %zu bound", bound, kJsPushOpCount);
+            s_push_targets[browser_->GetIdentifier()] = std::move(target);
         }
         return true;
     }
@@ -3,9 +3,12 @@
 #include "include/cef_app.h"
 #include "include/cef_render_process_handler.h"
 #include "include/cef_v8.h"
+#include "cef/player_ipc.h"
+#include "cef/js_push.h"
 #include <SDL3/SDL.h>
 #include <atomic>
 #include <functional>
+#include <string>
 
 class App : public CefApp,
             public CefBrowserProcessHandler,
@@ -20,6 +23,10 @@ public:
     // Must be called before CefInitialize
     static void SetWakeCallback(std::function<void()> callback) { wake_callback_ = std::move(callback); }
 
+    // Name of the player state mirror, passed to renderer processes
+    // (browser process, before CefInitialize)
+    static void SetPlayerStateMirror(const std::string& name) { player_state_mirror_ = name; }
+
     // External message pump interface (macOS)
     // Call when wake event received - pumps CEF work
     static void DoWork();
@@ -33,6 +40,7 @@ public:
 
     // CefBrowserProcessHandler
     void OnContextInitialized() override;
+    void OnBeforeChildProcessLaunch(CefRefPtr<CefCommandLine> command_line) override;
     void OnScheduleMessagePumpWork(int64_t delay_ms) override;
     bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
                                   CefRefPtr<CefFrame> frame,
@@ -43,6 +51,9 @@ public:
     void OnContextCreated(CefRefPtr<CefBrowser> browser,
                          CefRefPtr<CefFrame> frame,
                          CefRefPtr<CefV8Context> context) override;
+    void OnContextReleased(CefRefPtr<CefBrowser> browser,
+                           CefRefPtr<CefFrame> frame,
+                           CefRefPtr<CefV8Context> context) override;
 
 private:
     // External message pump state (macOS)
@@ -52,12 +63,49 @@ private:
     static inline SDL_TimerID timer_id_{0};  // For delayed work
     static Uint32 TimerCallback(void* userdata, SDL_TimerID id, Uint32 interval);
 
+    static inline std::string player_state_mirror_;
+
     float device_scale_factor_ = 1.0f;
 
     IMPLEMENT_REFCOUNTING(App);
     DISALLOW_COPY_AND_ASSIGN(App);
 };
 
+// Batches player commands from one renderer task into a single binary
+// process message (renderer thread only)
+class PlayerIpcSender : public CefBaseRefCounted {
+public:
+    explicit PlayerIpcSender(CefRefPtr<CefBrowser> browser) : browser_(browser) {}
+
+    // Queue a command; the batch is sent once the current task returns
+    void post(const PlayerCommand& cmd);
+    void flush();
+
+private:
+    CefRefPtr<CefBrowser> browser_;
+    PlayerIpcBatch batch_;
+    bool flush_posted_ = false;
+    IMPLEMENT_REFCOUNTING(PlayerIpcSender);
+};
+
+// V8 handler for one jmpNative player function, bound to its op at creation
+// so calls dispatch without comparing names
+class PlayerV8Handler : public CefV8Handler {
+public:
+    PlayerV8Handler(PlayerOp op, CefRefPtr<PlayerIpcSender> sender) : op_(op), sender_(sender) {}
+
+    bool Execute(const CefString& name,
+                CefRefPtr<CefV8Value> object,
+                const CefV8ValueList& arguments,
+                CefRefPtr<CefV8Value>& retval,
+                CefString& exception) override;
+
+private:
+    PlayerOp op_;
+    CefRefPtr<PlayerIpcSender> sender_;
+    IMPLEMENT_REFCOUNTING(PlayerV8Handler);
+};
+
 // V8 handler for native functions
 class NativeV8Handler : public CefV8Handler {
 public:
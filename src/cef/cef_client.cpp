@@ -1,18 +1,52 @@
 #include "cef/cef_client.h"
+#include "cef/player_ipc.h"
 #include "ui/menu_overlay.h"
 #include "settings.h"
+#include "json_reader.h"
+#include "trace.h"
 #include "input/sdl_to_vk.h"
 #include "include/cef_urlrequest.h"
 #include "include/cef_parser.h"
 #include <SDL3/SDL.h>
 #include "logging.h"
 #include <mutex>
+#include <cmath>
 #if !defined(__APPLE__) && !defined(_WIN32)
 #include <unistd.h>  // For dup()
+#include <drm_fourcc.h>
 #endif
 
 namespace {
 
+#if !defined(__APPLE__) && !defined(_WIN32)
+// Dup every plane of an accelerated paint (CEF closes its fds after the callback)
+bool dupDmabufFrame(const CefAcceleratedPaintInfo& info, DmabufFrame& frame) {
+    frame.width = info.extra.coded_size.width;
+    frame.height = info.extra.coded_size.height;
+    frame.modifier = info.modifier;
+    frame.fourcc = info.format == CEF_COLOR_TYPE_RGBA_8888 ? DRM_FORMAT_ABGR8888 : DRM_FORMAT_ARGB8888;
+    frame.plane_count = 0;
+    if (frame.width <= 0 || frame.height <= 0) {
+        return false;
+    }
+    for (int i = 0; i < info.plane_count && i < DmabufFrame::kMaxPlanes; i++) {
+        int fd = dup(info.planes[i].fd);
+        if (fd < 0) {
+            for (int j = 0; j < frame.plane_count; j++) {
+                close(frame.planes[j].fd);
+            }
+            frame.plane_count = 0;
+            return false;
+        }
+        frame.planes[i].fd = fd;
+        frame.planes[i].stride = info.planes[i].stride;
+        frame.planes[i].offset = info.planes[i].offset;
+        frame.plane_count = i + 1;
+    }
+    return frame.plane_count > 0;
+}
+#endif
+
 void doCopy(CefRefPtr<CefBrowser> browser, bool cut) {
     if (!browser) return;
     auto frame = browser->GetFocusedFrame();
@@ -143,6 +177,17 @@ void handleGetClipboard(CefRefPtr<CefBrowser> browser, CefRefPtr<CefListValue> a
 }
 } // namespace
 
+// A Jellyfin /System/Info/Public response
+static bool hasServerId(const std::string& body) {
+    JsonReader reader(body);
+    std::string_view key;
+    JsonValue value;
+    while (reader.nextMember(key, value)) {
+        if (key == "Id") return value.isString() && !value.raw.empty();
+    }
+    return false;
+}
+
 // URL request client for server connectivity checks
 class ConnectivityURLRequestClient : public CefURLRequestClient {
 public:
@@ -157,8 +202,8 @@ public:
         std::string resolved_url = original_url_;
 
         if (status == UR_SUCCESS && response && response->GetStatus() == 200) {
-            // Check if we got valid JSON with an "Id" field
-            if (response_body_.find("\"Id\"") != std::string::npos) {
+            // Check if we got a JSON object with a top-level "Id" string
+            if (hasServerId(response_body_)) {
                 success = true;
                 // Use the final URL after redirects
                 resolved_url = response->GetURL().ToString();
@@ -263,59 +308,12 @@ bool Client::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
 
     LOG_DEBUG(LOG_CEF, "IPC received message: %s", name.c_str());
 
-    if (name == "playerLoad") {
-        std::string url = args->GetString(0).ToString();
-        int startMs = args->GetSize() > 1 ? args->GetInt(1) : 0;
-        int audioIdx = args->GetSize() > 2 ? args->GetInt(2) : -1;
-        int subIdx = args->GetSize() > 3 ? args->GetInt(3) : -1;
-        std::string metadata = args->GetSize() > 4 ? args->GetString(4).ToString() : "{}";
-        // Encode track indices in metadata JSON
-        std::string prefix = "{";
-        if (audioIdx >= 0) prefix += "\"_audioIdx\":" + std::to_string(audioIdx) + ",";
-        if (subIdx >= 0) prefix += "\"_subIdx\":" + std::to_string(subIdx) + ",";
-        if (prefix.size() > 1 && metadata.size() > 1) {
-            metadata = prefix + metadata.substr(1);
+    if (name == kPlayerBatchMessage) {
+        CefRefPtr<CefSharedMemoryRegion> region = message->GetSharedMemoryRegion();
+        if (!region || !region->IsValid() ||
+            !decodePlayerBatch(region->Memory(), region->Size(), on_player_msg_)) {
+            LOG_WARN(LOG_CEF, "IPC: malformed player batch");
         }
-        on_player_msg_("load", url, startMs, metadata);
-        return true;
-    } else if (name == "playerStop") {
-        LOG_DEBUG(LOG_CEF, "Calling on_player_msg_ for stop");
-        on_player_msg_("stop", "", 0, "");
-        LOG_DEBUG(LOG_CEF, "on_player_msg_ returned for stop");
-        return true;
-    } else if (name == "playerPause") {
-        on_player_msg_("pause", "", 0, "");
-        return true;
-    } else if (name == "playerPlay") {
-        on_player_msg_("play", "", 0, "");
-        return true;
-    } else if (name == "playerSeek") {
-        int ms = args->GetInt(0);
-        on_player_msg_("seek", "", ms, "");
-        return true;
-    } else if (name == "playerSetVolume") {
-        int vol = args->GetInt(0);
-        on_player_msg_("volume", "", vol, "");
-        return true;
-    } else if (name == "playerSetMuted") {
-        bool muted = args->GetBool(0);
-        on_player_msg_("mute", "", muted ? 1 : 0, "");
-        return true;
-    } else if (name == "playerSetSpeed") {
-        int rateX1000 = args->GetInt(0);
-        on_player_msg_("speed", "", rateX1000, "");
-        return true;
-    } else if (name == "playerSetSubtitle") {
-        int sid = args->GetInt(0);
-        on_player_msg_("subtitle", "", sid, "");
-        return true;
-    } else if (name == "playerSetAudio") {
-        int aid = args->GetInt(0);
-        on_player_msg_("audio", "", aid, "");
-        return true;
-    } else if (name == "playerSetAudioDelay") {
-        double delay = args->GetDouble(0);
-        on_player_msg_("audioDelay", "", 0, std::to_string(delay));
         return true;
     } else if (name == "saveServerUrl") {
         std::string url = args->GetString(0).ToString();
@@ -323,39 +321,6 @@ bool Client::OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
         Settings::instance().setServerUrl(url);
         Settings::instance().saveAsync();
         return true;
-    } else if (name == "notifyMetadata") {
-        std::string metadata = args->GetString(0).ToString();
-        on_player_msg_("media_metadata", metadata, 0, "");
-        return true;
-    } else if (name == "notifyPosition") {
-        int posMs = args->GetInt(0);
-        on_player_msg_("media_position", "", posMs, "");
-        return true;
-    } else if (name == "notifySeek") {
-        int posMs = args->GetInt(0);
-        on_player_msg_("media_seeked", "", posMs, "");
-        return true;
-    } else if (name == "notifyPlaybackState") {
-        std::string state = args->GetString(0).ToString();
-        on_player_msg_("media_state", state, 0, "");
-        return true;
-    } else if (name == "notifyArtwork") {
-        std::string artworkUri = args->GetString(0).ToString();
-        on_player_msg_("media_artwork", artworkUri, 0, "");
-        return true;
-    } else if (name == "notifyQueueChange") {
-        bool canNext = args->GetBool(0);
-        bool canPrev = args->GetBool(1);
-        // Encode both bools in intArg: bit 0 = canNext, bit 1 = canPrev
-        int flags = (canNext ? 1 : 0) | (canPrev ? 2 : 0);
-        on_player_msg_("media_queue", "", flags, "");
-        return true;
-    } else if (name == "notifyRateChange") {
-        double rate = args->GetDouble(0);
-        // Use the rate * 1000000 to pass as int (microseconds precision equivalent)
-        // We'll decode this in main.cpp
-        on_player_msg_("media_notify_rate", "", static_cast<int>(rate * 1000000), "");
-        return true;
     } else if (name == "setClipboard") {
         return handleSetClipboard(args);
     } else if (name == "getClipboard") {
@@ -376,14 +341,17 @@ void Client::GetViewRect(CefRefPtr<CefBrowser> browser, CefRect& rect) {
     rect.Set(0, 0, width_, height_);
 }
 
-bool Client::GetScreenInfo(CefRefPtr<CefBrowser> browser, CefScreenInfo& screen_info) {
+float Client::deviceScale() const {
     // Compute scale from physical/logical - CEF paints at logical * scale = physical
     int physical_w = 0, physical_h = 0;
     if (physical_size_cb_) {
         physical_size_cb_(physical_w, physical_h);
     }
-    float scale = (physical_w > 0 && width_ > 0) ? static_cast<float>(physical_w) / width_ : 1.0f;
-    screen_info.device_scale_factor = scale;
+    return (physical_w > 0 && width_ > 0) ? static_cast<float>(physical_w) / width_ : 1.0f;
+}
+
+bool Client::GetScreenInfo(CefRefPtr<CefBrowser> browser, CefScreenInfo& screen_info) {
+    screen_info.device_scale_factor = deviceScale();
     screen_info.depth = 32;
     screen_info.depth_per_component = 8;
     screen_info.is_monochrome = false;
@@ -392,86 +360,64 @@ bool Client::GetScreenInfo(CefRefPtr<CefBrowser> browser, CefScreenInfo& screen_
     return true;
 }
 
+CefRect Client::popupPixelRect() const {
+    if (!popup_visible_ || popup_rect_.IsEmpty()) {
+        return CefRect();
+    }
+    // Popup rect is in view coordinates, the compositor works in paint buffer pixels
+    float scale = deviceScale();
+    return CefRect(static_cast<int>(std::lround(popup_rect_.x * scale)),
+                   static_cast<int>(std::lround(popup_rect_.y * scale)),
+                   static_cast<int>(std::lround(popup_rect_.width * scale)),
+                   static_cast<int>(std::lround(popup_rect_.height * scale)));
+}
+
 void Client::OnPopupShow(CefRefPtr<CefBrowser> browser, bool show) {
     popup_visible_ = show;
     if (!show) {
-        popup_buffer_.clear();
+        popup_rect_ = CefRect();
+    }
+    // The view underneath is never blended, so hiding needs no repaint
+    if (on_popup_) {
+        on_popup_(popupPixelRect(), nullptr, 0, 0);
     }
 }
 
 void Client::OnPopupSize(CefRefPtr<CefBrowser> browser, const CefRect& rect) {
     popup_rect_ = rect;
+    if (on_popup_ && popup_visible_) {
+        on_popup_(popupPixelRect(), nullptr, 0, 0);
+    }
 }
 
 void Client::OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
                      const RectList& dirtyRects, const void* buffer,
                      int width, int height) {
+    TRACE_SPAN("Client::OnPaint");
     static bool first = true;
     if (first) {
         LOG_INFO(LOG_CEF, "OnPaint: %dx%d type=%s", width, height,
                  type == PET_VIEW ? "VIEW" : "POPUP");
         first = false;
     }
-    if (!on_paint_) return;
 
     if (type == PET_POPUP) {
-        // Store popup buffer for compositing
-        size_t size = width * height * 4;
-        popup_buffer_.resize(size);
-        memcpy(popup_buffer_.data(), buffer, size);
-        // Request main view repaint to composite popup
-        if (browser) {
-            browser->GetHost()->Invalidate(PET_VIEW);
+        // Popup is its own compositor layer: upload just the popup, view untouched
+        if (on_popup_ && popup_visible_) {
+            on_popup_(popupPixelRect(), buffer, width, height);
         }
         return;
     }
 
-    // PET_VIEW - main view
-    // Fast path: no popup, pass buffer directly (zero extra copies)
-    if (!popup_visible_ || popup_buffer_.empty()) {
-        on_paint_(buffer, width, height);
-        return;
+    if (on_paint_) {
+        on_paint_(buffer, width, height, dirtyRects);
     }
-
-    // Slow path: blend popup onto view (only when dropdown is visible)
-    size_t size = width * height * 4;
-    composite_buffer_.resize(size);
-    memcpy(composite_buffer_.data(), buffer, size);
-
-    int px = popup_rect_.x;
-    int py = popup_rect_.y;
-    int pw = popup_rect_.width;
-    int ph = popup_rect_.height;
-    for (int y = 0; y < ph; y++) {
-        int dst_y = py + y;
-        if (dst_y < 0 || dst_y >= height) continue;
-        for (int x = 0; x < pw; x++) {
-            int dst_x = px + x;
-            if (dst_x < 0 || dst_x >= width) continue;
-            int src_i = (y * pw + x) * 4;
-            int dst_i = (dst_y * width + dst_x) * 4;
-            if (src_i + 3 >= static_cast<int>(popup_buffer_.size())) continue;
-            uint8_t alpha = popup_buffer_[src_i + 3];
-            if (alpha == 255) {
-                composite_buffer_[dst_i + 0] = popup_buffer_[src_i + 0];
-                composite_buffer_[dst_i + 1] = popup_buffer_[src_i + 1];
-                composite_buffer_[dst_i + 2] = popup_buffer_[src_i + 2];
-                composite_buffer_[dst_i + 3] = 255;
-            } else if (alpha > 0) {
-                uint8_t inv = 255 - alpha;
-                composite_buffer_[dst_i + 0] = (popup_buffer_[src_i + 0] * alpha + composite_buffer_[dst_i + 0] * inv) / 255;
-                composite_buffer_[dst_i + 1] = (popup_buffer_[src_i + 1] * alpha + composite_buffer_[dst_i + 1] * inv) / 255;
-                composite_buffer_[dst_i + 2] = (popup_buffer_[src_i + 2] * alpha + composite_buffer_[dst_i + 2] * inv) / 255;
-                composite_buffer_[dst_i + 3] = 255;
-            }
-        }
-    }
-    on_paint_(composite_buffer_.data(), width, height);
 }
 
 void Client::OnAcceleratedPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
                                  const RectList& dirtyRects,
                                  const CefAcceleratedPaintInfo& info) {
+    TRACE_SPAN("Client::OnAcceleratedPaint");
 #ifdef __APPLE__
     static bool first = true;
     if (first) {
@@ -493,25 +439,19 @@ void Client::OnAcceleratedPaint(CefRefPtr<CefBrowser> browser, PaintElementType
     if (first) {
         LOG_INFO(LOG_CEF, "OnAcceleratedPaint: planes=%d modifier=0x%lx format=%d",
                  info.plane_count, info.modifier, info.format);
-        if (info.plane_count > 0) {
-            LOG_INFO(LOG_CEF, "  plane[0]: fd=%d stride=%u offset=%lu size=%lu",
-                     info.planes[0].fd, info.planes[0].stride,
-                     info.planes[0].offset, info.planes[0].size);
+        for (int i = 0; i < info.plane_count; i++) {
+            LOG_INFO(LOG_CEF, "  plane[%d]: fd=%d stride=%u offset=%lu size=%lu", i,
+                     info.planes[i].fd, info.planes[i].stride,
+                     info.planes[i].offset, info.planes[i].size);
         }
         first = false;
     }
 
-    // Import dmabuf for zero-copy rendering
+    // Import dmabuf for zero-copy rendering (CEF's actual dimensions, not window size)
     if (on_accel_paint_ && type == PET_VIEW && info.plane_count > 0) {
-        // Use CEF's actual dmabuf dimensions, not window size
-        int w = info.extra.coded_size.width;
-        int h = info.extra.coded_size.height;
-        if (w > 0 && h > 0) {
-            // Dup the fd since CEF may close it after this callback
-            int fd = dup(info.planes[0].fd);
-            if (fd >= 0) {
-                on_accel_paint_(fd, info.planes[0].stride, info.modifier, w, h);
-            }
+        DmabufFrame frame;
+        if (dupDmabufFrame(info, frame)) {
+            on_accel_paint_(frame);
         }
     }
 #endif
@@ -717,36 +657,81 @@ void Client::exitFullscreen() {
     browser_->GetHost()->ExitFullscreen(true);
 }
 
+CefRefPtr<CefProcessMessage> Client::createPush(JsPushOp op) {
+    CefRefPtr<CefProcessMessage> msg = CefProcessMessage::Create(kJsPushMessage);
+    msg->GetArgumentList()->SetInt(0, static_cast<int>(op));
+    return msg;
+}
+
+void Client::sendPush(CefRefPtr<CefProcessMessage> msg) {
+    if (!browser_) return;
+    CefRefPtr<CefFrame> frame = browser_->GetMainFrame();
+    if (frame) {
+        frame->SendProcessMessage(PID_RENDERER, msg);
+    }
+}
+
 void Client::emitPlaying() {
-    executeJS("if(window._nativeEmit) window._nativeEmit('playing');");
+    sendPush(createPush(JsPushOp::Playing));
 }
 
 void Client::emitPaused() {
-    executeJS("if(window._nativeEmit) window._nativeEmit('paused');");
+    sendPush(createPush(JsPushOp::Paused));
 }
 
 void Client::emitFinished() {
-    executeJS("if(window._nativeEmit) window._nativeEmit('finished');");
+    sendPush(createPush(JsPushOp::Finished));
 }
 
 void Client::emitCanceled() {
-    executeJS("if(window._nativeEmit) window._nativeEmit('canceled');");
+    sendPush(createPush(JsPushOp::Canceled));
 }
 
 void Client::emitError(const std::string& msg) {
-    executeJS("if(window._nativeEmit) window._nativeEmit('error', '" + msg + "');");
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::Error);
+    push->GetArgumentList()->SetString(1, msg);
+    sendPush(push);
 }
 
 void Client::emitRateChanged(double rate) {
-    executeJS("if(window._nativeSetRate) window._nativeSetRate(" + std::to_string(rate) + ");");
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::RateChanged);
+    push->GetArgumentList()->SetDouble(1, rate);
+    sendPush(push);
+}
+
+void Client::emitHostInput(const char* action) {
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::HostInput);
+    push->GetArgumentList()->SetString(1, action);
+    sendPush(push);
+}
+
+void Client::emitSeek(int positionMs) {
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::Seek);
+    push->GetArgumentList()->SetInt(1, positionMs);
+    sendPush(push);
 }
 
 void Client::updatePosition(double positionMs) {
-    executeJS("if(window._nativeUpdatePosition) window._nativeUpdatePosition(" + std::to_string(positionMs) + ");");
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::Position);
+    push->GetArgumentList()->SetDouble(1, positionMs);
+    sendPush(push);
 }
 
 void Client::updateDuration(double durationMs) {
-    executeJS("if(window._nativeUpdateDuration) window._nativeUpdateDuration(" + std::to_string(durationMs) + ");");
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::Duration);
+    push->GetArgumentList()->SetDouble(1, durationMs);
+    sendPush(push);
+}
+
+void Client::updateBufferedRanges(const std::pair<int64_t, int64_t>* ranges, int count) {
+    CefRefPtr<CefProcessMessage> push = createPush(JsPushOp::BufferedRanges);
+    CefRefPtr<CefListValue> args = push->GetArgumentList();
+    args->SetSize(1 + static_cast<size_t>(count) * 2);
+    for (int i = 0; i < count; i++) {
+        args->SetDouble(1 + i * 2, static_cast<double>(ranges[i].first));
+        args->SetDouble(2 + i * 2, static_cast<double>(ranges[i].second));
+    }
+    sendPush(push);
 }
 
 bool Client::RunContextMenu(CefRefPtr<CefBrowser> browser,
@@ -903,19 +888,21 @@ bool OverlayClient::GetScreenInfo(CefRefPtr<CefBrowser> browser, CefScreenInfo&
 void OverlayClient::OnPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
                              const RectList& dirtyRects, const void* buffer,
                              int width, int height) {
+    TRACE_SPAN("OverlayClient::OnPaint");
     static bool first = true;
     if (first) {
         LOG_INFO(LOG_CEF, "Overlay OnPaint: %dx%d", width, height);
         first = false;
     }
     if (on_paint_ && type == PET_VIEW) {
-        on_paint_(buffer, width, height);
+        on_paint_(buffer, width, height, dirtyRects);
     }
 }
 
 void OverlayClient::OnAcceleratedPaint(CefRefPtr<CefBrowser> browser, PaintElementType type,
                                         const RectList& dirtyRects,
                                         const CefAcceleratedPaintInfo& info) {
+    TRACE_SPAN("OverlayClient::OnAcceleratedPaint");
 #ifdef __APPLE__
     static bool first = true;
     if (first) {
@@ -940,16 +927,11 @@ void OverlayClient::OnAcceleratedPaint(CefRefPtr<CefBrowser> browser, PaintEleme
         first = false;
     }
 
-    // Import dmabuf for zero-copy rendering
+    // Import dmabuf for zero-copy rendering (CEF's actual dimensions, not window size)
     if (on_accel_paint_ && type == PET_VIEW && info.plane_count > 0) {
-        // Use CEF's actual dmabuf dimensions, not window size
-        int w = info.extra.coded_size.width;
-        int h = info.extra.coded_size.height;
-        if (w > 0 && h > 0) {
-            int fd = dup(info.planes[0].fd);
-            if (fd >= 0) {
-                on_accel_paint_(fd, info.planes[0].stride, info.modifier, w, h);
-            }
+        DmabufFrame frame;
+        if (dupDmabufFrame(info, frame)) {
+            on_accel_paint_(frame);
         }
     }
 #endif
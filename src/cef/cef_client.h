@@ -8,6 +8,9 @@
 #include <atomic>
 #include <functional>
 #include <vector>
+#include "compositor/dmabuf_frame.h"
+#include "player/player_command.h"
+#include "cef/js_push.h"
 
 class MenuOverlay;
 
@@ -33,8 +36,7 @@ public:
 };
 
 // Message callback for player commands from renderer
-// metadata is JSON string for "load" command, empty otherwise
-using PlayerMessageCallback = std::function<void(const std::string& cmd, const std::string& arg, int intArg, const std::string& metadata)>;
+using PlayerMessageCallback = std::function<void(PlayerCommand&& cmd)>;
 
 // Cursor change callback (passes CEF cursor type)
 using CursorChangeCallback = std::function<void(cef_cursor_type_t type)>;
@@ -46,9 +48,8 @@ using FullscreenChangeCallback = std::function<void(bool fullscreen)>;
 using PhysicalSizeCallback = std::function<void(int& width, int& height)>;
 
 // Accelerated paint callback (dmabuf on Linux)
-// fd: dmabuf file descriptor, stride/offset/size: plane info, modifier: for EGL
-using AcceleratedPaintCallback = std::function<void(int fd, uint32_t stride, uint64_t modifier,
-                                                     int width, int height)>;
+// frame: every plane CEF provided, fds dup'd and owned by the receiver
+using AcceleratedPaintCallback = std::function<void(const DmabufFrame& frame)>;
 
 #ifdef __APPLE__
 // IOSurface paint callback (macOS accelerated paint)
@@ -58,7 +59,10 @@ using IOSurfacePaintCallback = std::function<void(void* surface, int format, int
 
 class Client : public CefClient, public CefRenderHandler, public CefLifeSpanHandler, public CefDisplayHandler, public CefLoadHandler, public CefContextMenuHandler, public InputReceiver {
 public:
-    using PaintCallback = std::function<void(const void* buffer, int width, int height)>;
+    // dirtyRects: damaged regions in buffer pixels (empty = whole frame)
+    using PaintCallback = std::function<void(const void* buffer, int width, int height, const RectList& dirtyRects)>;
+    // Popup layer: rect in paint buffer pixels (empty = hidden), buffer null = geometry only
+    using PopupCallback = std::function<void(const CefRect& rect, const void* buffer, int width, int height)>;
 
     Client(int width, int height, PaintCallback on_paint, PlayerMessageCallback on_player_msg = nullptr,
            AcceleratedPaintCallback on_accel_paint = nullptr, MenuOverlay* menu = nullptr,
@@ -142,6 +146,9 @@ public:
     void forceRepaint();
     void loadUrl(const std::string& url);
 
+    // Route PET_POPUP paints to a separate compositor layer (set before browser creation)
+    void setPopupCallback(PopupCallback on_popup) { on_popup_ = std::move(on_popup); }
+
     // Override scale factor (0 = use physical/logical ratio)
     void setScaleOverride(float scale) { scale_override_ = scale; }
 
@@ -151,20 +158,29 @@ public:
     // Exit browser fullscreen mode (call when window exits fullscreen)
     void exitFullscreen();
 
-    // Player signal helpers
+    // Player signal helpers (pushed to the page's registered handlers)
     void emitPlaying();
     void emitPaused();
     void emitFinished();
     void emitCanceled();
     void emitError(const std::string& msg);
     void emitRateChanged(double rate);
+    void emitHostInput(const char* action);
+    void emitSeek(int positionMs);
     void updatePosition(double positionMs);
     void updateDuration(double durationMs);
+    void updateBufferedRanges(const std::pair<int64_t, int64_t>* ranges, int count);
 
 private:
+    float deviceScale() const;
+    CefRefPtr<CefProcessMessage> createPush(JsPushOp op);
+    void sendPush(CefRefPtr<CefProcessMessage> msg);
+    CefRect popupPixelRect() const;
+
     int width_;
     int height_;
     PaintCallback on_paint_;
+    PopupCallback on_popup_;
     PlayerMessageCallback on_player_msg_;
     AcceleratedPaintCallback on_accel_paint_;
 #ifdef __APPLE__
@@ -180,9 +196,7 @@ private:
 
     // Popup (dropdown) state
     bool popup_visible_ = false;
-    CefRect popup_rect_;
-    std::vector<uint8_t> popup_buffer_;
-    std::vector<uint8_t> composite_buffer_;  // Main view + popup blended
+    CefRect popup_rect_;  // View (logical) coordinates from OnPopupSize
 
     IMPLEMENT_REFCOUNTING(Client);
     DISALLOW_COPY_AND_ASSIGN(Client);
@@ -191,7 +205,7 @@ private:
 // Simplified client for overlay browser (no player, no menu)
 class OverlayClient : public CefClient, public CefRenderHandler, public CefLifeSpanHandler, public CefDisplayHandler, public InputReceiver {
 public:
-    using PaintCallback = std::function<void(const void* buffer, int width, int height)>;
+    using PaintCallback = std::function<void(const void* buffer, int width, int height, const RectList& dirtyRects)>;
     using LoadServerCallback = std::function<void(const std::string& url)>;
 
     OverlayClient(int width, int height, PaintCallback on_paint, LoadServerCallback on_load_server,
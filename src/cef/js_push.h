@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+// Browser -> renderer push channel. The browser process sends a
+// kJsPushMessage whose argument list is [op, args...]; the renderer calls
+// the matching handler the page registered through
+// jmpNative.setPushHandlers() with V8 values, so no script is compiled per
+// update.
+enum class JsPushOp : int {
+    Playing,
+    Paused,
+    Finished,
+    Canceled,
+    Error,           // string message
+    RateChanged,     // double rate
+    Position,        // double ms
+    Duration,        // double ms
+    BufferedRanges,  // doubles: start0, end0, start1, end1, ... (100 ns ticks)
+    HostInput,       // string action
+    Seek,            // int ms
+
+    Count
+};
+
+constexpr size_t kJsPushOpCount = static_cast<size_t>(JsPushOp::Count);
+
+constexpr const char* kJsPushMessage = "jsPush";
+
+// Property names of the object passed to jmpNative.setPushHandlers(),
+// indexed by JsPushOp
+constexpr const char* kJsPushHandlerNames[kJsPushOpCount] = {
+    "playing", "paused", "finished", "canceled", "error", "rateChanged",
+    "position", "duration", "bufferedRanges", "hostInput", "seek",
+};
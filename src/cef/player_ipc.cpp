@@ -0,0 +1,113 @@
+#include "cef/player_ipc.h"
+#include <cstring>
+
+namespace {
+
+struct BatchHeader {
+    uint32_t bytes;  // Total batch size including this header
+    uint32_t count;
+};
+
+struct RecordHeader {
+    uint8_t op;
+    uint8_t reserved[3];
+    int32_t int_arg;
+    double double_arg;
+    uint32_t text_len;
+    uint32_t metadata_len;
+};
+
+static_assert(sizeof(BatchHeader) % 8 == 0, "BatchHeader must keep records aligned");
+static_assert(sizeof(RecordHeader) % 8 == 0, "RecordHeader must keep records aligned");
+
+size_t pad8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+}  // namespace
+
+void PlayerIpcBatch::add(const PlayerCommand& cmd) {
+    if (buf_.empty()) {
+        buf_.resize(sizeof(BatchHeader));
+    }
+
+    if (count_ && playerOpCoalesces(cmd.op)) {
+        RecordHeader* last = reinterpret_cast<RecordHeader*>(buf_.data() + last_record_);
+        if (last->op == static_cast<uint8_t>(cmd.op)) {
+            last->int_arg = cmd.int_arg;
+            last->double_arg = cmd.double_arg;
+            return;
+        }
+    }
+
+    RecordHeader rec{};
+    rec.op = static_cast<uint8_t>(cmd.op);
+    rec.int_arg = cmd.int_arg;
+    rec.double_arg = cmd.double_arg;
+    rec.text_len = static_cast<uint32_t>(cmd.text.size());
+    rec.metadata_len = static_cast<uint32_t>(cmd.metadata.size());
+
+    size_t offset = buf_.size();
+    buf_.resize(offset + pad8(sizeof(rec) + cmd.text.size() + cmd.metadata.size()));
+    uint8_t* p = buf_.data() + offset;
+    std::memcpy(p, &rec, sizeof(rec));
+    p += sizeof(rec);
+    if (!cmd.text.empty()) std::memcpy(p, cmd.text.data(), cmd.text.size());
+    p += cmd.text.size();
+    if (!cmd.metadata.empty()) std::memcpy(p, cmd.metadata.data(), cmd.metadata.size());
+
+    last_record_ = offset;
+    count_++;
+}
+
+const uint8_t* PlayerIpcBatch::data() {
+    if (buf_.empty()) return nullptr;
+    BatchHeader header{static_cast<uint32_t>(buf_.size()), static_cast<uint32_t>(count_)};
+    std::memcpy(buf_.data(), &header, sizeof(header));
+    return buf_.data();
+}
+
+void PlayerIpcBatch::clear() {
+    buf_.clear();
+    count_ = 0;
+    last_record_ = 0;
+}
+
+bool decodePlayerBatch(const void* data, size_t size,
+                       const std::function<void(PlayerCommand&&)>& fn) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    BatchHeader header;
+    if (!bytes || size < sizeof(header)) return false;
+    std::memcpy(&header, bytes, sizeof(header));
+    // The shared memory mapping may be larger than the batch
+    if (header.bytes < sizeof(header) || header.bytes > size) return false;
+    size = header.bytes;
+
+    size_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.count; i++) {
+        RecordHeader rec;
+        if (size - offset < sizeof(rec)) return false;
+        std::memcpy(&rec, bytes + offset, sizeof(rec));
+        if (rec.op >= kPlayerOpCount) return false;
+
+        size_t payload = static_cast<size_t>(rec.text_len) + rec.metadata_len;
+        if (size - offset - sizeof(rec) < payload) return false;
+
+        const char* text = reinterpret_cast<const char*>(bytes + offset + sizeof(rec));
+        PlayerCommand cmd;
+        cmd.op = static_cast<PlayerOp>(rec.op);
+        cmd.int_arg = rec.int_arg;
+        cmd.double_arg = rec.double_arg;
+        cmd.text.assign(text, rec.text_len);
+        cmd.metadata.assign(text + rec.text_len, rec.metadata_len);
+        fn(std::move(cmd));
+
+        size_t record = pad8(sizeof(rec) + payload);
+        if (size - offset < record) {
+            offset = size;
+        } else {
+            offset += record;
+        }
+    }
+    return true;
+}
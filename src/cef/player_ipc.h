@@ -0,0 +1,45 @@
+#pragma once
+
+#include "player/player_command.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Binary wire format for player commands sent from the renderer process to
+// the browser process. Commands issued during one renderer task are packed
+// into a single batch and delivered as one shared-memory process message
+// instead of one named CefProcessMessage per call.
+//
+// Layout (both processes are the same binary, so native byte order):
+//   BatchHeader, then per command a RecordHeader followed by text and
+//   metadata bytes, padded to 8 bytes.
+
+constexpr const char* kPlayerBatchMessage = "playerBatch";
+
+class PlayerIpcBatch {
+public:
+    // Append a command. A latest-wins command directly following one of the
+    // same op overwrites it in place.
+    void add(const PlayerCommand& cmd);
+
+    bool empty() const { return count_ == 0; }
+    size_t count() const { return count_; }
+    size_t size() const { return buf_.size(); }
+
+    // Finalizes the header; valid until the next add() or clear()
+    const uint8_t* data();
+
+    // Keeps capacity for the next batch
+    void clear();
+
+private:
+    std::vector<uint8_t> buf_;
+    size_t count_ = 0;
+    size_t last_record_ = 0;  // Offset of the newest record (valid if count_)
+};
+
+// Calls fn for each command in a batch, in order. Returns false (after
+// delivering the well-formed prefix) if the batch is truncated or corrupt.
+bool decodePlayerBatch(const void* data, size_t size,
+                       const std::function<void(PlayerCommand&&)>& fn);
@@ -0,0 +1,162 @@
+#include "cef/trace_session.h"
+#include "trace.h"
+#include "logging.h"
+
+#include "include/cef_task.h"
+#include "include/cef_trace.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// Reads Chromium's trace (often tens of MB), merges and writes the output
+// off the browser UI thread
+class TraceFinishTask : public CefTask {
+public:
+    TraceFinishTask(TraceSession* session, std::string chromium_path)
+        : session_(session), chromium_path_(std::move(chromium_path)) {}
+    void Execute() override {
+        session_->finish(chromium_path_);
+    }
+
+private:
+    TraceSession* session_;
+    std::string chromium_path_;
+    IMPLEMENT_REFCOUNTING(TraceFinishTask);
+};
+
+static void postFinish(TraceSession* session, const std::string& chromium_path) {
+    CefRefPtr<TraceFinishTask> task = new TraceFinishTask(session, chromium_path);
+    if (!CefPostTask(TID_FILE_USER_BLOCKING, task)) {
+        task->Execute();  // Shutting down: write it here rather than lose it
+    }
+}
+
+class TraceEndCallback : public CefEndTracingCallback {
+public:
+    explicit TraceEndCallback(TraceSession* session) : session_(session) {}
+    void OnEndTracingComplete(const CefString& tracing_file) override {
+        postFinish(session_, tracing_file.ToString());
+    }
+
+private:
+    TraceSession* session_;
+    IMPLEMENT_REFCOUNTING(TraceEndCallback);
+};
+
+class TraceBeginTask : public CefTask {
+public:
+    void Execute() override {
+        // Empty category list = Chromium's default set
+        if (!CefBeginTracing(CefString(), nullptr)) {
+            LOG_WARN(LOG_CEF, "Trace: CefBeginTracing failed, recording native spans only");
+        }
+    }
+    IMPLEMENT_REFCOUNTING(TraceBeginTask);
+};
+
+class TraceEndTask : public CefTask {
+public:
+    TraceEndTask(TraceSession* session, std::string chromium_path)
+        : session_(session), chromium_path_(std::move(chromium_path)) {}
+    void Execute() override {
+        if (!CefEndTracing(chromium_path_, new TraceEndCallback(session_))) {
+            postFinish(session_, {});
+        }
+    }
+
+private:
+    TraceSession* session_;
+    std::string chromium_path_;
+    IMPLEMENT_REFCOUNTING(TraceEndTask);
+};
+
+TraceSession::TraceSession(std::string path) : path_(std::move(path)) {}
+
+std::string TraceSession::nextPath() {
+    int n = ++sessions_;
+    if (path_.empty()) {
+#ifdef _WIN32
+        unsigned long pid = GetCurrentProcessId();
+#else
+        unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+        std::error_code ec;
+        std::filesystem::path dir = std::filesystem::temp_directory_path(ec);
+        std::string name = "jellyfin-desktop-trace-" + std::to_string(pid) + "-" + std::to_string(n) + ".json";
+        return (dir / name).string();
+    }
+    if (n == 1) return path_;
+    std::filesystem::path p(path_);
+    std::filesystem::path numbered = p.parent_path() /
+        (p.stem().string() + "-" + std::to_string(n) + p.extension().string());
+    return numbered.string();
+}
+
+bool TraceSession::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_ || busy_) {
+        LOG_WARN(LOG_MAIN, "Trace: previous trace is still being written");
+        return false;
+    }
+    output_path_ = nextPath();
+    TraceRecorder::start();
+    CefPostTask(TID_UI, new TraceBeginTask());
+    active_ = true;
+    LOG_INFO(LOG_MAIN, "Trace: recording (stop to write %s)", output_path_.c_str());
+    return true;
+}
+
+void TraceSession::stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!active_) return;
+    TraceRecorder::stop();
+    active_ = false;
+    busy_ = true;
+    if (!CefPostTask(TID_UI, new TraceEndTask(this, output_path_ + ".chromium"))) {
+        // CEF is gone: keep what we have
+        busy_ = false;
+        writeMergedTrace(output_path_, {}, TraceRecorder::collectJson());
+    }
+}
+
+void TraceSession::toggle() {
+    if (active()) {
+        stop();
+    } else {
+        start();
+    }
+}
+
+void TraceSession::finish(const std::string& chromium_path) {
+    std::string chromium_trace;
+    if (!chromium_path.empty()) {
+        std::ifstream file(chromium_path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        chromium_trace = buffer.str();
+        std::remove(chromium_path.c_str());
+    }
+
+    size_t dropped = 0;
+    std::string native_events = TraceRecorder::collectJson(&dropped);
+    if (dropped) {
+        LOG_WARN(LOG_MAIN, "Trace: %zu native spans dropped (thread buffers full)", dropped);
+    }
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        path = output_path_;
+    }
+    if (writeMergedTrace(path, chromium_trace, native_events)) {
+        LOG_INFO(LOG_MAIN, "Trace: wrote %s", path.c_str());
+    }
+    busy_ = false;
+}
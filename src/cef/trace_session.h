@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+// One recording that covers both our spans (TraceRecorder) and Chromium's
+// trace (CefBeginTracing/CefEndTracing), written as a single Chrome trace
+// JSON file. Start/stop from any thread once CEF is initialized; the CEF
+// calls are posted to the browser UI thread. When Chromium hands its trace
+// back, the merge and write run on CEF's blocking file thread.
+class TraceSession {
+public:
+    // path: output file; empty = jellyfin-desktop-trace-<pid>-<n>.json in
+    // the temp directory. Later sessions get -<n> before the extension.
+    explicit TraceSession(std::string path = {});
+
+    bool active() const { return active_.load(); }
+    // A stopped session is still being written
+    bool busy() const { return busy_.load(); }
+
+    bool start();
+    void stop();
+    void toggle();
+
+private:
+    friend class TraceEndCallback;
+    friend class TraceEndTask;
+    friend class TraceFinishTask;
+    std::string nextPath();
+    // Blocking IO: merge Chromium's trace file with our spans, clear busy_
+    void finish(const std::string& chromium_path);
+
+    std::string path_;
+    std::string output_path_;  // Current session
+    int sessions_ = 0;
+    std::mutex mutex_;
+    std::atomic<bool> active_{false};
+    std::atomic<bool> busy_{false};
+};
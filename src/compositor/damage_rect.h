@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Rectangle in paint buffer pixels (origin top-left, like CefRect)
+struct DamageRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    bool empty() const { return width <= 0 || height <= 0; }
+    int64_t area() const { return empty() ? 0 : static_cast<int64_t>(width) * height; }
+};
+
+// Clip rect to a w x h surface
+inline DamageRect clipDamageRect(const DamageRect& r, int w, int h) {
+    int x0 = std::max(r.x, 0);
+    int y0 = std::max(r.y, 0);
+    int x1 = std::min(r.x + r.width, w);
+    int y1 = std::min(r.y + r.height, h);
+    if (x1 <= x0 || y1 <= y0) return {};
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+// Bounding box of two rects (empty rects are ignored)
+inline DamageRect unionDamageRect(const DamageRect& a, const DamageRect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    int x0 = std::min(a.x, b.x);
+    int y0 = std::min(a.y, b.y);
+    int x1 = std::max(a.x + a.width, b.x + b.width);
+    int y1 = std::max(a.y + a.height, b.y + b.height);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+// Accumulated damage for one surface. Keeps a short rect list and collapses
+// to the bounding box when it grows, so storage never reallocates after the
+// first few frames. "full" means the whole surface must be treated as dirty.
+class DamageRegion {
+public:
+    static constexpr size_t kMaxRects = 8;
+
+    DamageRegion() { rects_.reserve(kMaxRects); }
+
+    void add(const DamageRect& r) {
+        if (full_ || r.empty()) return;
+        // Drop rects already covered by an existing one
+        for (const auto& e : rects_) {
+            if (r.x >= e.x && r.y >= e.y &&
+                r.x + r.width <= e.x + e.width && r.y + r.height <= e.y + e.height) {
+                return;
+            }
+        }
+        if (rects_.size() >= kMaxRects) {
+            DamageRect bounds = r;
+            for (const auto& e : rects_) bounds = unionDamageRect(bounds, e);
+            rects_.clear();
+            rects_.push_back(bounds);
+            return;
+        }
+        rects_.push_back(r);
+    }
+
+    void merge(const DamageRegion& other) {
+        if (other.full_) {
+            setFull();
+            return;
+        }
+        for (const auto& r : other.rects_) add(r);
+    }
+
+    void setFull() { full_ = true; rects_.clear(); }
+    void clear() { full_ = false; rects_.clear(); }
+
+    bool full() const { return full_; }
+    bool empty() const { return !full_ && rects_.empty(); }
+    const std::vector<DamageRect>& rects() const { return rects_; }
+
+    // Bounding box of all rects, or the whole w x h surface when full
+    DamageRect bounds(int w, int h) const {
+        if (full_) return {0, 0, w, h};
+        DamageRect box;
+        for (const auto& r : rects_) box = unionDamageRect(box, r);
+        return box;
+    }
+
+    // Covered pixel count (overlaps counted twice), or w*h when full
+    int64_t area(int w, int h) const {
+        if (full_) return static_cast<int64_t>(w) * h;
+        int64_t total = 0;
+        for (const auto& r : rects_) total += r.area();
+        return total;
+    }
+
+private:
+    std::vector<DamageRect> rects_;
+    bool full_ = false;
+};
+
+// Opacity estimate for r in a tightly packed BGRA buffer: alpha 255 on a
+// grid of every step-th row and column (plus the last row and column), so
+// a 4K frame costs ~1/step^2 of a full scan. Transparent regions in a UI
+// (video cutouts, rounded panels) span many grid cells; a hole smaller
+// than the grid would be missed.
+inline bool isOpaqueRectSampled(const uint8_t* src, int width, const DamageRect& r, int step = 16) {
+    if (r.empty()) return true;
+    size_t stride = static_cast<size_t>(width) * 4;
+    const uint8_t* base = src + static_cast<size_t>(r.y) * stride + static_cast<size_t>(r.x) * 4;
+    for (int y = 0;; y = std::min(y + step, r.height - 1)) {
+        const uint8_t* row = base + static_cast<size_t>(y) * stride;
+        for (int x = 0;; x = std::min(x + step, r.width - 1)) {
+            if (row[x * 4 + 3] != 0xFF) return false;
+            if (x == r.width - 1) break;
+        }
+        if (y == r.height - 1) break;
+    }
+    return true;
+}
+
+// Copy one damaged rect between two tightly packed 32bpp buffers of equal size
+inline void copyDamageRect(uint8_t* dst, const uint8_t* src, int width, const DamageRect& r) {
+    size_t stride = static_cast<size_t>(width) * 4;
+    size_t row_bytes = static_cast<size_t>(r.width) * 4;
+    size_t offset = static_cast<size_t>(r.y) * stride + static_cast<size_t>(r.x) * 4;
+    if (r.x == 0 && r.width == width) {
+        // Full-width band is contiguous
+        std::memcpy(dst + offset, src + offset, row_bytes * r.height);
+        return;
+    }
+    for (int row = 0; row < r.height; row++) {
+        std::memcpy(dst + offset, src + offset, row_bytes);
+        offset += stride;
+    }
+}
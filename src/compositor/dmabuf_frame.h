@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// CEF accelerated paint buffer (Linux dmabuf), one entry per plane.
+// Plane fds are dup'd by the sender and owned by whoever holds the frame.
+struct DmabufFrame {
+    static constexpr int kMaxPlanes = 4;
+
+    struct Plane {
+        int fd = -1;
+        uint32_t stride = 0;
+        uint64_t offset = 0;
+    };
+
+    Plane planes[kMaxPlanes];
+    int plane_count = 0;
+    uint32_t fourcc = 0;    // DRM_FORMAT_*
+    uint64_t modifier = 0;  // DRM_FORMAT_MOD_INVALID = no explicit modifier
+    int width = 0;
+    int height = 0;
+};
@@ -0,0 +1,177 @@
+#include "compositor/dmabuf_selftest.h"
+#include "compositor/opengl_compositor.h"
+#include "logging.h"
+
+#include <drm_fourcc.h>
+#include <fcntl.h>
+#include <linux/udmabuf.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 64;
+
+// BGRA bytes (DRM ARGB8888) for pixel x,y
+void patternPixel(int x, int y, uint8_t out[4]) {
+    out[0] = static_cast<uint8_t>(x * 4);        // B
+    out[1] = static_cast<uint8_t>(y * 4);        // G
+    out[2] = static_cast<uint8_t>((x ^ y) * 4);  // R
+    out[3] = 255;
+}
+
+// Returns a dmabuf fd backed by a memfd filled with the test pattern
+int createPatternDmabuf() {
+    size_t size = static_cast<size_t>(kWidth) * kHeight * 4;
+    long page = sysconf(_SC_PAGESIZE);
+    size = (size + page - 1) / page * page;
+
+    int dev = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+    if (dev < 0) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest: /dev/udmabuf not available");
+        return -1;
+    }
+    int memfd = memfd_create("dmabuf-selftest", MFD_ALLOW_SEALING | MFD_CLOEXEC);
+    if (memfd < 0 || ftruncate(memfd, static_cast<off_t>(size)) != 0 ||
+        fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK) != 0) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest: memfd setup failed");
+        if (memfd >= 0) close(memfd);
+        close(dev);
+        return -1;
+    }
+
+    auto* pixels = static_cast<uint8_t*>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0));
+    if (pixels == MAP_FAILED) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest: mmap failed");
+        close(memfd);
+        close(dev);
+        return -1;
+    }
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            patternPixel(x, y, pixels + (static_cast<size_t>(y) * kWidth + x) * 4);
+        }
+    }
+    munmap(pixels, size);
+
+    struct udmabuf_create create = {};
+    create.memfd = static_cast<uint32_t>(memfd);
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = 0;
+    create.size = size;
+    int buf = ioctl(dev, UDMABUF_CREATE, &create);
+    close(memfd);
+    close(dev);
+    if (buf < 0) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest: UDMABUF_CREATE failed");
+    }
+    return buf;
+}
+
+DmabufFrame makeFrame(int fd) {
+    DmabufFrame frame;
+    frame.planes[0].fd = fd;
+    frame.planes[0].stride = kWidth * 4;
+    frame.planes[0].offset = 0;
+    frame.plane_count = 1;
+    frame.fourcc = DRM_FORMAT_ARGB8888;
+    frame.modifier = DRM_FORMAT_MOD_LINEAR;
+    frame.width = kWidth;
+    frame.height = kHeight;
+    return frame;
+}
+
+// Import + composite one frame into the bound FBO and compare the readback
+bool importAndCheck(OpenGLCompositor& compositor, int fd, const char* pass) {
+    uint64_t ticket = compositor.queueDmabuf(makeFrame(fd));
+    if (!compositor.importQueuedDmabuf()) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest (%s): import failed", pass);
+        return false;
+    }
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    compositor.composite(kWidth, kHeight, 1.0f);
+
+    if (!compositor.waitDmabufReleased(ticket, 0)) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest (%s): buffer not released after composite", pass);
+        return false;
+    }
+
+    std::vector<uint8_t> readback(static_cast<size_t>(kWidth) * kHeight * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, kWidth, kHeight, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+
+    // Readback is bottom-up, the compositor anchors row 0 to the top
+    int mismatches = 0;
+    for (int row = 0; row < kHeight; row++) {
+        int y = kHeight - 1 - row;
+        for (int x = 0; x < kWidth; x++) {
+            uint8_t bgra[4];
+            patternPixel(x, y, bgra);
+            const uint8_t* rgba = readback.data() + (static_cast<size_t>(row) * kWidth + x) * 4;
+            if (std::abs(rgba[0] - bgra[2]) > 1 || std::abs(rgba[1] - bgra[1]) > 1 ||
+                std::abs(rgba[2] - bgra[0]) > 1 || std::abs(rgba[3] - bgra[3]) > 1) {
+                if (mismatches++ == 0) {
+                    LOG_ERROR(LOG_TEST, "dmabuf selftest (%s): pixel %d,%d = %u,%u,%u,%u, expected %u,%u,%u,%u",
+                              pass, x, y, rgba[0], rgba[1], rgba[2], rgba[3],
+                              bgra[2], bgra[1], bgra[0], bgra[3]);
+                }
+            }
+        }
+    }
+    if (mismatches) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest (%s): %d mismatched pixels", pass, mismatches);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool runDmabufSelfTest(OpenGLCompositor& compositor) {
+    LOG_INFO(LOG_TEST, "dmabuf selftest: EGL import %s", compositor.dmabufImportSupported() ? "supported" : "NOT supported");
+
+    int buf = createPatternDmabuf();
+    if (buf < 0) {
+        return false;
+    }
+
+    // Offscreen target at the test size
+    GLuint fbo = 0, target = 0;
+    glGenTextures(1, &target);
+    glBindTexture(GL_TEXTURE_2D, target);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, kWidth, kHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+
+    bool ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!ok) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest: offscreen framebuffer incomplete");
+    }
+
+    // First pass imports, second must come from the cache (same buffer, new fd)
+    uint64_t misses = compositor.dmabufCacheMisses();
+    uint64_t hits = compositor.dmabufCacheHits();
+    ok = ok && importAndCheck(compositor, dup(buf), "import");
+    ok = ok && importAndCheck(compositor, dup(buf), "cached");
+    if (ok && (compositor.dmabufCacheMisses() - misses != 1 || compositor.dmabufCacheHits() - hits != 1)) {
+        LOG_ERROR(LOG_TEST, "dmabuf selftest: expected 1 miss + 1 hit, got %llu + %llu",
+                  static_cast<unsigned long long>(compositor.dmabufCacheMisses() - misses),
+                  static_cast<unsigned long long>(compositor.dmabufCacheHits() - hits));
+        ok = false;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &target);
+    close(buf);
+
+    LOG_INFO(LOG_TEST, "dmabuf selftest: %s", ok ? "PASS" : "FAIL");
+    return ok;
+}
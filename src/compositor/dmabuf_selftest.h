@@ -0,0 +1,9 @@
+#pragma once
+
+class OpenGLCompositor;
+
+// Exercise the dmabuf import path end to end without CEF: build a udmabuf
+// with a known pattern, import and composite it into an FBO, read it back,
+// then import it again to check the cache and the buffer release.
+// Works on software EGL (e.g. LIBGL_ALWAYS_SOFTWARE=1). Needs a current context.
+bool runDmabufSelfTest(OpenGLCompositor& compositor);
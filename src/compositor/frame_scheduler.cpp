@@ -0,0 +1,43 @@
+#include "compositor/frame_scheduler.h"
+#include "logging.h"
+
+uint32_t FrameScheduler::take() {
+    uint32_t reasons = pending_.exchange(0, std::memory_order_acq_rel);
+    for (int i = 0; i < kReasonCount; i++) {
+        if (reasons & (1u << i)) reason_counts_[i]++;
+    }
+    return reasons;
+}
+
+void FrameScheduler::noteIteration(bool drawn) {
+    wakeups_++;
+    if (drawn) {
+        drawn_++;
+    } else {
+        skipped_++;
+    }
+}
+
+void FrameScheduler::logStats() {
+    auto now = Clock::now();
+    double secs = std::chrono::duration<double>(now - last_log_).count();
+    if (secs < 5.0) {
+        return;
+    }
+    if (wakeups_ > 0) {
+        LOG_DEBUG(LOG_MAIN, "frames: %.1f/s drawn, %.1f/s skipped, %.1f wakeups/s "
+                  "(requests: paint %llu, input %llu, anim %llu, resize %llu, video %llu, cmd %llu)",
+                  drawn_ / secs, skipped_ / secs, wakeups_ / secs,
+                  static_cast<unsigned long long>(reason_counts_[0]),
+                  static_cast<unsigned long long>(reason_counts_[1]),
+                  static_cast<unsigned long long>(reason_counts_[2]),
+                  static_cast<unsigned long long>(reason_counts_[3]),
+                  static_cast<unsigned long long>(reason_counts_[4]),
+                  static_cast<unsigned long long>(reason_counts_[5]));
+    }
+    wakeups_ = 0;
+    drawn_ = 0;
+    skipped_ = 0;
+    for (auto& count : reason_counts_) count = 0;
+    last_log_ = now;
+}
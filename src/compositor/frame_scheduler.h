@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Render-on-demand bookkeeping for the main loop. Anything that changes what
+// the window shows requests a frame (from any thread) and wakes the loop;
+// the loop draws only when a request is pending and otherwise sleeps in
+// SDL_WaitEvent instead of re-compositing an unchanged window every vsync.
+class FrameScheduler {
+public:
+    // Why a frame was requested (bit flags)
+    enum Reason : uint32_t {
+        kPaint     = 1u << 0,  // CEF paint, popup, or accelerated paint arrived
+        kInput     = 1u << 1,  // User input (CEF repaints follow, but keep latency low)
+        kAnimation = 1u << 2,  // Overlay fade in progress
+        kResize    = 1u << 3,  // Window size or scale changed
+        kVideo     = 1u << 4,  // Video frame composited into the window, or video state changed
+        kCommand   = 1u << 5,  // Player command or playback state change
+    };
+    static constexpr int kReasonCount = 6;
+
+    // Request a frame (thread-safe; caller wakes the main loop if needed)
+    void request(uint32_t reasons) { pending_.fetch_or(reasons, std::memory_order_release); }
+
+    // A frame is waiting to be drawn (main loop uses this to poll instead of wait)
+    bool pending() const { return pending_.load(std::memory_order_acquire) != 0; }
+
+    // Take the pending reasons for this iteration (0 = nothing changed)
+    uint32_t take();
+
+    // Record one main loop iteration and whether it drew a frame
+    void noteIteration(bool drawn);
+
+    // Log drawn/skipped frames and wakeups per second every few seconds
+    void logStats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::atomic<uint32_t> pending_{0};
+
+    // Main thread only
+    uint64_t wakeups_ = 0;
+    uint64_t drawn_ = 0;
+    uint64_t skipped_ = 0;
+    uint64_t reason_counts_[kReasonCount] = {};
+    Clock::time_point last_log_ = Clock::now();
+};
@@ -0,0 +1,207 @@
+#include "compositor/frame_telemetry.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+const char* const kStageNames[FrameTelemetry::kStageCount] = {
+    "events", "commands", "paintFlush", "import", "composite", "swap",
+};
+
+uint32_t clampUs(uint64_t ns) {
+    return static_cast<uint32_t>(std::min<uint64_t>(ns / 1000, UINT32_MAX));
+}
+
+uint32_t toUs(std::chrono::steady_clock::duration d) {
+    return clampUs(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+}
+
+int bucketFor(uint32_t us) {
+    int bucket = 0;
+    for (uint32_t bound = 64; bucket < FrameTelemetry::kBuckets - 1 && us >= bound; bound <<= 1) {
+        bucket++;
+    }
+    return bucket;
+}
+
+// Nearest-rank percentile of sorted values
+uint32_t percentile(const std::vector<uint32_t>& sorted, int pct) {
+    if (sorted.empty()) return 0;
+    size_t rank = (sorted.size() * pct + 99) / 100;
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+void appendf(std::string& out, const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n > 0) out.append(buf, std::min<size_t>(n, sizeof(buf) - 1));
+}
+
+// {"p50_us":..,"p95_us":..,"p99_us":..,"max_us":..,"mean_us":..,"histogram":[..]}
+void appendMetric(std::string& out, std::vector<uint32_t>& values) {
+    std::sort(values.begin(), values.end());
+    uint64_t sum = 0;
+    uint32_t histogram[FrameTelemetry::kBuckets] = {};
+    for (uint32_t v : values) {
+        sum += v;
+        histogram[bucketFor(v)]++;
+    }
+    appendf(out, "{\"p50_us\":%u,\"p95_us\":%u,\"p99_us\":%u,\"max_us\":%u,\"mean_us\":%llu,\"histogram\":[",
+            percentile(values, 50), percentile(values, 95), percentile(values, 99),
+            values.empty() ? 0u : values.back(),
+            static_cast<unsigned long long>(values.empty() ? 0 : sum / values.size()));
+    for (int i = 0; i < FrameTelemetry::kBuckets; i++) {
+        appendf(out, i ? ",%u" : "%u", histogram[i]);
+    }
+    out += "]}";
+}
+
+}  // namespace
+
+void FrameTelemetry::endIteration(bool drawn) {
+    auto now = Clock::now();
+    if (!drawn) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        last_frame_ = {};  // Idle gaps aren't frame intervals
+    } else {
+        Record record;
+        for (int i = 0; i < kStageCount; i++) {
+            record.stage_us[i] = clampUs(stage_ns_[i]);
+        }
+        record.frame_us = toUs(now - woke_);
+        record.interval_us = last_frame_ == Clock::time_point{} ? 0 : toUs(now - last_frame_);
+        record.uploaded = static_cast<uint32_t>(std::min<uint64_t>(uploaded_, UINT32_MAX));
+        last_frame_ = now;
+
+        uint64_t frame = frames_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[frame % kCapacity];
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.record, &record, sizeof(record));
+        slot.seq.store(seq + 2, std::memory_order_release);
+        frames_.store(frame + 1, std::memory_order_release);
+    }
+
+    for (auto& ns : stage_ns_) ns = 0;
+    uploaded_ = 0;
+}
+
+std::vector<FrameTelemetry::Record> FrameTelemetry::snapshot(uint64_t& frames) const {
+    static_assert(std::is_trivially_copyable<Record>::value, "Record is copied byte-wise");
+
+    // Newest kCapacity frames; slots the writer is busy with (or laps during
+    // the copy) are left out
+    frames = frames_.load(std::memory_order_acquire);
+    uint64_t count = std::min<uint64_t>(frames, kCapacity);
+    std::vector<Record> records;
+    records.reserve(count);
+    for (uint64_t i = frames - count; i < frames; i++) {
+        const Slot& slot = slots_[i % kCapacity];
+        uint32_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        Record record;
+        std::memcpy(&record, &slot.record, sizeof(record));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != before) continue;
+        records.push_back(record);
+    }
+    return records;
+}
+
+std::string FrameTelemetry::dumpJson() const {
+    uint64_t frames = 0;
+    std::vector<Record> records = snapshot(frames);
+
+    std::vector<uint32_t> values;
+    values.reserve(records.size());
+    auto collect = [&](auto field) -> std::vector<uint32_t>& {
+        values.clear();
+        for (const auto& record : records) values.push_back(field(record));
+        return values;
+    };
+
+    uint64_t window_us = 0;
+    uint64_t uploaded = 0;
+    for (const auto& record : records) {
+        window_us += record.interval_us;
+        uploaded += record.uploaded;
+    }
+
+    std::string out;
+    out.reserve(4096);
+    appendf(out, "{\"uptime_s\":%.1f,\"frames\":%llu,\"skipped_iterations\":%llu,"
+            "\"window\":{\"frames\":%zu,\"seconds\":%.2f},\"bucket_upper_us\":[",
+            std::chrono::duration<double>(Clock::now() - start_).count(),
+            static_cast<unsigned long long>(frames),
+            static_cast<unsigned long long>(skipped_.load(std::memory_order_relaxed)),
+            records.size(), window_us / 1e6);
+    for (int i = 0; i < kBuckets - 1; i++) {
+        appendf(out, i ? ",%u" : "%u", 64u << i);
+    }
+    out += "],\"stages\":{";
+    for (int s = 0; s < kStageCount; s++) {
+        appendf(out, "%s\"%s\":", s ? "," : "", kStageNames[s]);
+        appendMetric(out, collect([s](const Record& r) { return r.stage_us[s]; }));
+    }
+    out += "},\"frame\":";
+    appendMetric(out, collect([](const Record& r) { return r.frame_us; }));
+    out += ",\"interval\":";
+    // Frames drawn after an idle iteration have no interval
+    auto& intervals = collect([](const Record& r) { return r.interval_us; });
+    intervals.erase(std::remove(intervals.begin(), intervals.end(), 0u), intervals.end());
+    appendMetric(out, intervals);
+
+    auto& bytes = collect([](const Record& r) { return r.uploaded; });
+    std::sort(bytes.begin(), bytes.end());
+    appendf(out, ",\"uploaded_bytes\":{\"p50\":%u,\"p95\":%u,\"p99\":%u,\"max\":%u,\"total\":%llu}}\n",
+            percentile(bytes, 50), percentile(bytes, 95), percentile(bytes, 99),
+            bytes.empty() ? 0u : bytes.back(), static_cast<unsigned long long>(uploaded));
+    return out;
+}
+
+bool FrameTelemetry::writeJson(const std::string& path) const {
+    std::string json = dumpJson();
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        LOG_WARN(LOG_COMPOSITOR, "Frame telemetry: can't write %s: %s", path.c_str(), strerror(errno));
+        return false;
+    }
+    bool ok = fwrite(json.data(), 1, json.size(), f) == json.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        LOG_WARN(LOG_COMPOSITOR, "Frame telemetry: writing %s failed", path.c_str());
+    }
+    return ok;
+}
+
+void FrameTelemetry::logSummary() const {
+    uint64_t frames = 0;
+    std::vector<Record> records = snapshot(frames);
+    std::vector<uint32_t> frame_us;
+    std::vector<uint32_t> interval_us;
+    for (const auto& record : records) {
+        frame_us.push_back(record.frame_us);
+        if (record.interval_us) interval_us.push_back(record.interval_us);
+    }
+    std::sort(frame_us.begin(), frame_us.end());
+    std::sort(interval_us.begin(), interval_us.end());
+    LOG_INFO(LOG_COMPOSITOR, "frame telemetry (last %zu of %llu frames): frame p50/p95/p99 %.2f/%.2f/%.2f ms, "
+             "interval p50/p95/p99 %.2f/%.2f/%.2f ms (max %.2f)",
+             frame_us.size(), static_cast<unsigned long long>(frames),
+             percentile(frame_us, 50) / 1000.0, percentile(frame_us, 95) / 1000.0,
+             percentile(frame_us, 99) / 1000.0,
+             percentile(interval_us, 50) / 1000.0, percentile(interval_us, 95) / 1000.0,
+             percentile(interval_us, 99) / 1000.0,
+             interval_us.empty() ? 0.0 : interval_us.back() / 1000.0);
+}
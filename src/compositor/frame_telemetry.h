@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Always-on per-frame timings for the main loop. Each drawn frame becomes a
+// record in a fixed ring (the last kCapacity frames); dumpJson() turns the
+// ring into p50/p95/p99/max and log2 histograms per stage, for jank reports
+// from a running instance (SIGUSR1 / control socket, see main.cpp).
+//
+// One writer, the main thread: recording is a few clock reads and stores,
+// no locks or allocation. Each slot is a seqlock, so dumpJson() can run on
+// any thread and skips a slot that is being overwritten.
+class FrameTelemetry {
+public:
+    enum Stage {
+        kEvents,      // mpv event dispatch + SDL event drain
+        kCommands,    // Player command dispatch
+        kPaintFlush,  // flushPaintBuffer + flushOverlay
+        kImport,      // importQueuedDmabuf / importQueuedIOSurface
+        kComposite,   // Video + browser layers into the frame
+        kSwap,        // Buffer swap / present (Windows/Linux)
+    };
+    static constexpr int kStageCount = 6;
+    static constexpr int kCapacity = 2048;
+    static constexpr int kBuckets = 16;  // 64us << i upper bounds, last open-ended
+
+    // Main thread. Stage times and upload bytes accumulate until
+    // endIteration(), which records them if the iteration drew a frame.
+    void add(Stage stage, uint64_t ns) { stage_ns_[stage] += ns; }
+    void addUploaded(uint64_t bytes) { uploaded_ += bytes; }
+    // The loop is done waiting for events; frame time counts from here
+    void woke() { woke_ = Clock::now(); }
+    void endIteration(bool drawn);
+
+    // Any thread
+    std::string dumpJson() const;
+    bool writeJson(const std::string& path) const;
+    void logSummary() const;
+
+    // Adds the time until end() (or destruction) to a stage
+    class Timer {
+    public:
+        Timer(FrameTelemetry& telemetry, Stage stage)
+            : telemetry_(telemetry), stage_(stage), start_(Clock::now()) {}
+        ~Timer() { end(); }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        void end() {
+            if (done_) return;
+            done_ = true;
+            telemetry_.add(stage_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start_).count());
+        }
+
+    private:
+        FrameTelemetry& telemetry_;
+        Stage stage_;
+        std::chrono::steady_clock::time_point start_;
+        bool done_ = false;
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Record {
+        uint32_t stage_us[kStageCount];
+        uint32_t frame_us;     // From woke() to the end of the iteration
+        uint32_t interval_us;  // Since the previous frame, if the loop drew back to back (else 0)
+        uint32_t uploaded;     // Paint bytes uploaded
+    };
+    struct Slot {
+        std::atomic<uint32_t> seq{0};  // Odd while being written
+        Record record{};
+    };
+
+    // Readable records of the ring; frames: total written so far
+    std::vector<Record> snapshot(uint64_t& frames) const;
+
+    // Main thread only
+    uint64_t stage_ns_[kStageCount] = {};
+    uint64_t uploaded_ = 0;
+    Clock::time_point woke_{};
+    Clock::time_point last_frame_{};
+
+    std::atomic<uint64_t> frames_{0};   // Records written (next slot = frames_ % kCapacity)
+    std::atomic<uint64_t> skipped_{0};  // Iterations that drew nothing
+    Clock::time_point start_ = Clock::now();
+    std::unique_ptr<Slot[]> slots_{new Slot[kCapacity]};
+};
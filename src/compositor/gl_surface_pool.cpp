@@ -0,0 +1,287 @@
+#include "compositor/gl_surface_pool.h"
+#include "logging.h"
+
+#ifdef _WIN32
+#include "context/gl_loader.h"
+#endif
+
+#include <algorithm>
+
+static size_t textureBytes(int width, int height) {
+    return static_cast<size_t>(width) * height * 4;
+}
+
+// Immutable storage where the driver has it (always on GLES 3.0)
+static void allocTextureStorage(int width, int height) {
+#ifdef _WIN32
+    if (glTexStorage2D) {
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+        return;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);  // nullptr must not mean "offset 0 of a bound PBO"
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+#else
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+#endif
+}
+
+int GLSurfacePool::bucket(int size) {
+    if (size <= 0) return 0;
+    return (size + kBucketStep - 1) / kBucketStep * kBucketStep;
+}
+
+size_t GLSurfacePool::bucketBytes(size_t size) {
+    if (size == 0) return 0;
+    return (size + kBufferBucketStep - 1) / kBufferBucketStep * kBufferBucketStep;
+}
+
+bool GLSurfacePool::fits(int have_w, int have_h, int width, int height) {
+    if (width > have_w || height > have_h) return false;
+    // Give storage back once the surface needs under a quarter of it
+    int64_t need = static_cast<int64_t>(bucket(width)) * bucket(height);
+    return need * 4 > static_cast<int64_t>(have_w) * have_h;
+}
+
+bool GLSurfacePool::fitsBytes(size_t have, size_t size) {
+    return size <= have && bucketBytes(size) * 4 > have;
+}
+
+int GLSurfacePool::maxTextureSize() {
+    if (!max_texture_size_) {
+        GLint max_size = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+        max_texture_size_ = max_size > 0 ? max_size : 4096;
+    }
+    return max_texture_size_;
+}
+
+bool GLSurfacePool::take(Kind kind, int width, int height, size_t bytes, Entry& out) {
+    int best = -1;
+    for (size_t i = 0; i < pool_.size(); i++) {
+        const Entry& e = pool_[i];
+        if (e.kind != kind) continue;
+        bool ok = kind == Kind::Buffer ? fitsBytes(e.bytes, bytes) : fits(e.width, e.height, width, height);
+        if (ok && (best < 0 || e.bytes < pool_[best].bytes)) {
+            best = static_cast<int>(i);
+        }
+    }
+    if (best < 0) return false;
+
+    out = pool_[best];
+    pool_.erase(pool_.begin() + best);
+    pooled_bytes_ -= out.bytes;
+    reused_++;
+    return true;
+}
+
+void GLSurfacePool::put(const Entry& e) {
+    pool_.push_back(e);
+    pool_.back().released = Clock::now();
+    pooled_bytes_ += e.bytes;
+    enforceBudget();
+}
+
+void GLSurfacePool::destroy(const Entry& e) {
+    if (e.fbo) glDeleteFramebuffers(1, &e.fbo);
+    if (e.depth_rb) glDeleteRenderbuffers(1, &e.depth_rb);
+    if (e.texture) glDeleteTextures(1, &e.texture);
+    if (e.buffer) glDeleteBuffers(1, &e.buffer);
+}
+
+void GLSurfacePool::enforceBudget() {
+    // Pool is in release order, so the front is the oldest
+    while (pooled_bytes_ > kMaxPooledBytes && !pool_.empty()) {
+        destroy(pool_.front());
+        pooled_bytes_ -= pool_.front().bytes;
+        pool_.erase(pool_.begin());
+    }
+}
+
+GLSurfacePool::Texture GLSurfacePool::acquireTexture(int width, int height, GLint filter) {
+    Texture tex;
+    if (width <= 0 || height <= 0) return tex;
+
+    Entry e;
+    if (take(Kind::Texture, width, height, 0, e)) {
+        glBindTexture(GL_TEXTURE_2D, e.texture);
+    } else {
+        int max_size = maxTextureSize();
+        e.kind = Kind::Texture;
+        e.width = std::max(width, std::min(bucket(width), max_size));
+        e.height = std::max(height, std::min(bucket(height), max_size));
+        e.bytes = textureBytes(e.width, e.height);
+
+        while (glGetError() != GL_NO_ERROR) {}
+        glGenTextures(1, &e.texture);
+        glBindTexture(GL_TEXTURE_2D, e.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        allocTextureStorage(e.width, e.height);
+        GLenum err = glGetError();
+        if (err != GL_NO_ERROR) {
+            LOG_ERROR(LOG_GL, "pool: texture %dx%d allocation failed: 0x%x", e.width, e.height, err);
+            glDeleteTextures(1, &e.texture);
+            return tex;
+        }
+        allocated_++;
+        LOG_DEBUG(LOG_GL, "pool: new texture %dx%d for %dx%d (reused %llu, allocated %llu)",
+                  e.width, e.height, width, height,
+                  static_cast<unsigned long long>(reused_), static_cast<unsigned long long>(allocated_));
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+    tex.id = e.texture;
+    tex.width = e.width;
+    tex.height = e.height;
+    return tex;
+}
+
+GLSurfacePool::Buffer GLSurfacePool::acquireBuffer(size_t size) {
+    Buffer buf;
+    if (size == 0) return buf;
+
+    Entry e;
+    if (!take(Kind::Buffer, 0, 0, size, e)) {
+        e.kind = Kind::Buffer;
+        e.bytes = bucketBytes(size);
+
+        while (glGetError() != GL_NO_ERROR) {}
+        glGenBuffers(1, &e.buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, e.buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, e.bytes, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        GLenum err = glGetError();
+        if (err != GL_NO_ERROR) {
+            LOG_ERROR(LOG_GL, "pool: buffer of %zu bytes allocation failed: 0x%x", e.bytes, err);
+            glDeleteBuffers(1, &e.buffer);
+            return buf;
+        }
+        allocated_++;
+        LOG_DEBUG(LOG_GL, "pool: new buffer %zu KB for %zu KB", e.bytes / 1024, size / 1024);
+    }
+
+    buf.id = e.buffer;
+    buf.size = e.bytes;
+    return buf;
+}
+
+GLSurfacePool::Framebuffer GLSurfacePool::acquireFramebuffer(int width, int height) {
+    Framebuffer fb;
+    if (width <= 0 || height <= 0) return fb;
+
+    Entry e;
+    if (!take(Kind::Framebuffer, width, height, 0, e)) {
+        int max_size = maxTextureSize();
+        e.kind = Kind::Framebuffer;
+        e.width = std::max(width, std::min(bucket(width), max_size));
+        e.height = std::max(height, std::min(bucket(height), max_size));
+        e.bytes = textureBytes(e.width, e.height) + static_cast<size_t>(e.width) * e.height * 2;
+
+        glGenTextures(1, &e.texture);
+        glBindTexture(GL_TEXTURE_2D, e.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        allocTextureStorage(e.width, e.height);
+
+        glGenRenderbuffers(1, &e.depth_rb);
+        glBindRenderbuffer(GL_RENDERBUFFER, e.depth_rb);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, e.width, e.height);
+
+        glGenFramebuffers(1, &e.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, e.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, e.texture, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, e.depth_rb);
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            LOG_ERROR(LOG_GL, "pool: framebuffer %dx%d incomplete: 0x%x", e.width, e.height, status);
+            destroy(e);
+            return fb;
+        }
+        allocated_++;
+        LOG_DEBUG(LOG_GL, "pool: new framebuffer %dx%d for %dx%d (reused %llu, allocated %llu)",
+                  e.width, e.height, width, height,
+                  static_cast<unsigned long long>(reused_), static_cast<unsigned long long>(allocated_));
+    }
+
+    fb.fbo = e.fbo;
+    fb.texture = e.texture;
+    fb.depth_rb = e.depth_rb;
+    fb.width = e.width;
+    fb.height = e.height;
+    return fb;
+}
+
+void GLSurfacePool::release(Texture& tex) {
+    if (!tex.id) return;
+    Entry e;
+    e.kind = Kind::Texture;
+    e.texture = tex.id;
+    e.width = tex.width;
+    e.height = tex.height;
+    e.bytes = textureBytes(tex.width, tex.height);
+    put(e);
+    tex = Texture{};
+}
+
+void GLSurfacePool::release(Buffer& buf) {
+    if (!buf.id) return;
+    Entry e;
+    e.kind = Kind::Buffer;
+    e.buffer = buf.id;
+    e.bytes = buf.size;
+    put(e);
+    buf = Buffer{};
+}
+
+void GLSurfacePool::release(Framebuffer& fb) {
+    if (!fb.fbo) return;
+    Entry e;
+    e.kind = Kind::Framebuffer;
+    e.texture = fb.texture;
+    e.fbo = fb.fbo;
+    e.depth_rb = fb.depth_rb;
+    e.width = fb.width;
+    e.height = fb.height;
+    e.bytes = textureBytes(fb.width, fb.height) + static_cast<size_t>(fb.width) * fb.height * 2;
+    put(e);
+    fb = Framebuffer{};
+}
+
+int GLSurfacePool::trim() {
+    if (pool_.empty()) return -1;
+
+    auto now = Clock::now();
+    auto timeout = std::chrono::milliseconds(kIdleTimeoutMs);
+    size_t freed = 0;
+    int next_ms = -1;
+    for (size_t i = 0; i < pool_.size();) {
+        auto idle = now - pool_[i].released;
+        if (idle >= timeout) {
+            destroy(pool_[i]);
+            freed += pool_[i].bytes;
+            pooled_bytes_ -= pool_[i].bytes;
+            pool_.erase(pool_.begin() + i);
+            continue;
+        }
+        int left = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(timeout - idle).count());
+        if (next_ms < 0 || left < next_ms) next_ms = left;
+        i++;
+    }
+    if (freed) {
+        LOG_DEBUG(LOG_GL, "pool: trimmed %zu KB idle, %zu KB still pooled", freed / 1024, pooled_bytes_ / 1024);
+    }
+    return next_ms;
+}
+
+void GLSurfacePool::clear() {
+    for (const auto& e : pool_) {
+        destroy(e);
+    }
+    pool_.clear();
+    pooled_bytes_ = 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#include <GL/gl.h>
+#else
+#include <GLES3/gl3.h>
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Size-bucketed pool of GL textures, pixel buffers and framebuffers.
+// Sizes are rounded up to buckets so a live resize keeps landing in storage
+// that already exists: a surface reallocates only when it outgrows its bucket
+// (or shrinks far below it). Released objects stay pooled for reuse and are
+// deleted once they have been idle for kIdleTimeout.
+// Not thread-safe: each GL context owns its pool (framebuffers can't be shared)
+// and uses it only on the thread that has that context current.
+class GLSurfacePool {
+public:
+    static constexpr int kBucketStep = 256;                 // Texture width/height granularity (px)
+    static constexpr size_t kBufferBucketStep = 1u << 20;   // Buffer size granularity (bytes)
+    static constexpr int kIdleTimeoutMs = 3000;             // Pooled objects older than this are freed
+    static constexpr size_t kMaxPooledBytes = 256u << 20;   // Oldest pooled objects go first beyond this
+
+    // RGBA8 texture with immutable storage; width/height are the allocated bucket
+    struct Texture {
+        GLuint id = 0;
+        int width = 0;
+        int height = 0;
+    };
+    // Pixel unpack buffer
+    struct Buffer {
+        GLuint id = 0;
+        size_t size = 0;
+    };
+    // FBO with an RGBA8 color texture and a 16-bit depth renderbuffer
+    struct Framebuffer {
+        GLuint fbo = 0;
+        GLuint texture = 0;
+        GLuint depth_rb = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // Allocation size for a dimension / byte count
+    static int bucket(int size);
+    static size_t bucketBytes(size_t size);
+    // Storage of have_w x have_h can keep serving a width x height surface
+    // (large enough, and not so large that it should be given back)
+    static bool fits(int have_w, int have_h, int width, int height);
+    static bool fitsBytes(size_t have, size_t size);
+
+    // Pooled or new storage covering width x height; left bound to GL_TEXTURE_2D
+    // on the active unit with the given min/mag filter. id 0 on failure.
+    Texture acquireTexture(int width, int height, GLint filter);
+    // Pooled or new buffer of at least size bytes (contents undefined). id 0 on failure.
+    Buffer acquireBuffer(size_t size);
+    // Pooled or new complete framebuffer covering width x height. fbo 0 on failure.
+    Framebuffer acquireFramebuffer(int width, int height);
+
+    // Return objects to the pool (handles are reset; empty handles are ignored)
+    void release(Texture& tex);
+    void release(Buffer& buf);
+    void release(Framebuffer& fb);
+
+    // Free objects idle past kIdleTimeoutMs. Returns ms until the next pooled
+    // object expires, or -1 if the pool is empty.
+    int trim();
+
+    // Free every pooled object (context must be current)
+    void clear();
+
+    size_t pooledBytes() const { return pooled_bytes_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Kind { Texture, Buffer, Framebuffer };
+    struct Entry {
+        Kind kind = Kind::Texture;
+        GLuint texture = 0;   // Texture, or Framebuffer color attachment
+        GLuint buffer = 0;
+        GLuint fbo = 0;
+        GLuint depth_rb = 0;
+        int width = 0;
+        int height = 0;
+        size_t bytes = 0;
+        Clock::time_point released;
+    };
+
+    // Remove the smallest pooled object that fits; false if there is none
+    bool take(Kind kind, int width, int height, size_t bytes, Entry& out);
+    void put(const Entry& e);
+    void destroy(const Entry& e);
+    void enforceBudget();
+    int maxTextureSize();
+
+    std::vector<Entry> pool_;
+    size_t pooled_bytes_ = 0;
+    int max_texture_size_ = 0;
+
+    // Reuse counters for the debug log
+    uint64_t reused_ = 0;
+    uint64_t allocated_ = 0;
+};
@@ -5,6 +5,8 @@
 #include <cstdint>
 #include <mutex>
 #include <atomic>
+#include <vector>
+#include "compositor/damage_rect.h"
 
 // Forward declarations for ObjC types
 #ifdef __OBJC__
@@ -26,7 +28,9 @@ public:
     void updateOverlay(const void* data, int width, int height);
 
     // Update overlay with arbitrary size (recreates texture if needed)
-    void updateOverlayPartial(const void* data, int src_width, int src_height);
+    // Only damaged rects are copied when the size is unchanged; returns bytes copied
+    size_t updateOverlayPartial(const void* data, int src_width, int src_height,
+                                const DamageRegion* damage = nullptr);
 
     // Queue IOSurface for import on main thread (called from CEF thread)
     void queueIOSurface(void* ioSurface, int format, int width, int height);
@@ -38,9 +42,21 @@ public:
     void* getStagingBuffer(int width, int height);
     void markStagingDirty();
 
+    // Popup (PET_POPUP) layer, drawn over the view in the composite pass
+    // rect: position in view texture pixels (empty = hidden)
+    void setPopupRect(const DamageRect& rect);
+    // Stage popup pixels (BGRA) for upload; returns number of bytes copied
+    size_t updatePopup(const void* data, int width, int height);
+
     // Render frame
     void composite(uint32_t width, uint32_t height, float alpha);
 
+    // Core Animation composites the layers, so opacity isn't used for culling
+    void setOpaque(bool opaque) { (void)opaque; }
+
+    // Each browser presents its own layer, so there is no shared window damage
+    void collectDamage(float alpha, DamageRegion& out) { (void)alpha; out.setFull(); }
+
     // Resize
     void resize(uint32_t width, uint32_t height);
 
@@ -80,6 +96,16 @@ private:
     bool staging_dirty_ = false;
     bool has_content_ = false;
 
+    // Popup layer (uploaded from popup_staging_ in composite)
+    void* popup_texture_ = nullptr;
+    int popup_width_ = 0;
+    int popup_height_ = 0;
+    std::vector<uint8_t> popup_staging_;
+    int popup_staging_width_ = 0;
+    int popup_staging_height_ = 0;
+    bool popup_dirty_ = false;
+    DamageRect popup_rect_;
+
     // IOSurface queue for zero-copy rendering
     struct QueuedIOSurface {
         void* surface = nullptr;  // IOSurfaceRef (retained)
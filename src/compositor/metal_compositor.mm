@@ -13,6 +13,7 @@
 #define CMD_QUEUE ((__bridge id<MTLCommandQueue>)command_queue_)
 #define TEXTURE ((__bridge id<MTLTexture>)texture_)
 #define PIPELINE ((__bridge id<MTLRenderPipelineState>)pipeline_state_)
+#define POPUP_TEXTURE ((__bridge id<MTLTexture>)popup_texture_)
 
 // Simple vertex/fragment shaders for textured quad
 static NSString* const shaderSource = @R"(
@@ -220,6 +221,10 @@ void MetalCompositor::cleanup() {
         CFBridgingRelease(texture_);
         texture_ = nullptr;
     }
+    if (popup_texture_) {
+        CFBridgingRelease(popup_texture_);
+        popup_texture_ = nullptr;
+    }
     if (pipeline_state_) {
         CFBridgingRelease(pipeline_state_);
         pipeline_state_ = nullptr;
@@ -250,21 +255,38 @@ void MetalCompositor::updateOverlay(const void* data, int width, int height) {
     staging_dirty_ = true;
 }
 
-void MetalCompositor::updateOverlayPartial(const void* data, int src_width, int src_height) {
+size_t MetalCompositor::updateOverlayPartial(const void* data, int src_width, int src_height,
+                                             const DamageRegion* damage) {
     if (!data || src_width <= 0 || src_height <= 0) {
-        return;
+        return 0;
     }
 
+    bool full_copy = !damage || damage->full() || !has_content_;
+
     // Resize if dimensions don't match
     if (src_width != (int)width_ || src_height != (int)height_) {
         resize(src_width, src_height);
+        full_copy = true;
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
-    if (staging_buffer_) {
-        memcpy(staging_buffer_, data, src_width * src_height * 4);
-        staging_dirty_ = true;
+    if (!staging_buffer_) {
+        return 0;
+    }
+    size_t copied = 0;
+    if (full_copy) {
+        copied = static_cast<size_t>(src_width) * src_height * 4;
+        memcpy(staging_buffer_, data, copied);
+    } else {
+        for (const auto& rect : damage->rects()) {
+            DamageRect r = clipDamageRect(rect, src_width, src_height);
+            if (r.empty()) continue;
+            copyDamageRect(static_cast<uint8_t*>(staging_buffer_), static_cast<const uint8_t*>(data), src_width, r);
+            copied += static_cast<size_t>(r.area()) * 4;
+        }
     }
+    staging_dirty_ = true;
+    return copied;
 }
 
 void MetalCompositor::queueIOSurface(void* ioSurface, int format, int width, int height) {
@@ -380,6 +402,25 @@ bool MetalCompositor::importQueuedIOSurface() {
     return true;
 }
 
+void MetalCompositor::setPopupRect(const DamageRect& rect) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    popup_rect_ = rect;
+}
+
+size_t MetalCompositor::updatePopup(const void* data, int width, int height) {
+    if (!data || width <= 0 || height <= 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t size = static_cast<size_t>(width) * height * 4;
+    popup_staging_.resize(size);
+    memcpy(popup_staging_.data(), data, size);
+    popup_staging_width_ = width;
+    popup_staging_height_ = height;
+    popup_dirty_ = true;
+    return size;
+}
+
 bool MetalCompositor::hasPendingContent() const {
     return staging_dirty_ || iosurface_pending_.load(std::memory_order_acquire);
 }
@@ -425,6 +466,32 @@ void MetalCompositor::composite(uint32_t width, uint32_t height, float alpha) {
         }
     }
 
+    // Upload popup layer if repainted (only the popup, never the view)
+    if (popup_dirty_) {
+        if (!popup_texture_ || popup_staging_width_ != popup_width_ || popup_staging_height_ != popup_height_) {
+            if (popup_texture_) {
+                CFBridgingRelease(popup_texture_);
+                popup_texture_ = nullptr;
+            }
+            MTLTextureDescriptor* desc = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:MTLPixelFormatBGRA8Unorm
+                                                                                            width:popup_staging_width_
+                                                                                           height:popup_staging_height_
+                                                                                        mipmapped:NO];
+            desc.usage = MTLTextureUsageShaderRead;
+            id<MTLTexture> popup = [DEVICE newTextureWithDescriptor:desc];
+            if (popup) {
+                popup_texture_ = (void*)CFBridgingRetain(popup);
+                popup_width_ = popup_staging_width_;
+                popup_height_ = popup_staging_height_;
+            }
+        }
+        if (popup_texture_) {
+            MTLRegion region = MTLRegionMake2D(0, 0, popup_width_, popup_height_);
+            [POPUP_TEXTURE replaceRegion:region mipmapLevel:0 withBytes:popup_staging_.data() bytesPerRow:popup_width_ * 4];
+        }
+        popup_dirty_ = false;
+    }
+
     if (!has_content_) {
         return;
     }
@@ -456,6 +523,15 @@ void MetalCompositor::composite(uint32_t width, uint32_t height, float alpha) {
         [encoder setFragmentTexture:TEXTURE atIndex:0];
         [encoder setFragmentBytes:&alpha length:sizeof(float) atIndex:0];
         [encoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:3];
+
+        // Popup layer: same pipeline, viewport restricted to the popup rect
+        if (popup_texture_ && !popup_rect_.empty()) {
+            MTLViewport viewport = {static_cast<double>(popup_rect_.x), static_cast<double>(popup_rect_.y),
+                                    static_cast<double>(popup_width_), static_cast<double>(popup_height_), 0.0, 1.0};
+            [encoder setViewport:viewport];
+            [encoder setFragmentTexture:POPUP_TEXTURE atIndex:0];
+            [encoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:3];
+        }
         [encoder endEncoding];
 
         // With presentsWithTransaction=YES, wait for GPU then present in CA transaction
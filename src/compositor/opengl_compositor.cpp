@@ -1,16 +1,65 @@
 #include "compositor/opengl_compositor.h"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <vector>
 #include "logging.h"
 
 #if !defined(__APPLE__) && !defined(_WIN32)
-#include <drm_fourcc.h>  // For DRM_FORMAT_ARGB8888
+#include <drm_fourcc.h>  // For DRM_FORMAT_MOD_INVALID
+#include <linux/dma-buf.h>  // For sync_file export/import
+#include <sys/ioctl.h>
+#include <sys/stat.h>    // For fstat() (dmabuf identity)
 #include <unistd.h>      // For close()
 // EGL function pointers for dmabuf import
 static PFNGLEGLIMAGETARGETTEXTURE2DOESPROC glEGLImageTargetTexture2DOES = nullptr;
 static PFNEGLCREATEIMAGEKHRPROC eglCreateImageKHR = nullptr;
 static PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR = nullptr;
+// EGL function pointers for explicit dmabuf sync (EGL_ANDROID_native_fence_sync)
+static PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR = nullptr;
+static PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = nullptr;
+static PFNEGLWAITSYNCKHRPROC eglWaitSyncKHR = nullptr;
+static PFNEGLDUPNATIVEFENCEFDANDROIDPROC eglDupNativeFenceFDANDROID = nullptr;
+static bool s_dmabuf_import = false;      // EGL_EXT_image_dma_buf_import(_modifiers)
+static bool s_native_fence_sync = false;  // sync_file fences usable as EGL syncs
+
+static void closeDmabufFrame(DmabufFrame& frame) {
+    for (int i = 0; i < frame.plane_count; i++) {
+        if (frame.planes[i].fd >= 0) {
+            close(frame.planes[i].fd);
+            frame.planes[i].fd = -1;
+        }
+    }
+}
+
+// Fences CEF's pending writes as a sync_file (-1 if the kernel can't export)
+static int exportDmabufSyncFile(int dmabuf_fd) {
+#ifdef DMA_BUF_IOCTL_EXPORT_SYNC_FILE
+    struct dma_buf_export_sync_file arg = {};
+    arg.flags = DMA_BUF_SYNC_READ;
+    arg.fd = -1;
+    if (ioctl(dmabuf_fd, DMA_BUF_IOCTL_EXPORT_SYNC_FILE, &arg) == 0) {
+        return arg.fd;
+    }
+#else
+    (void)dmabuf_fd;
+#endif
+    return -1;
+}
+
+// Adds our read fence to the buffer so the next writer waits for it
+static bool importDmabufSyncFile(int dmabuf_fd, int sync_fd) {
+#ifdef DMA_BUF_IOCTL_IMPORT_SYNC_FILE
+    struct dma_buf_import_sync_file arg = {};
+    arg.flags = DMA_BUF_SYNC_READ;
+    arg.fd = sync_fd;
+    return ioctl(dmabuf_fd, DMA_BUF_IOCTL_IMPORT_SYNC_FILE, &arg) == 0;
+#else
+    (void)dmabuf_fd; (void)sync_fd;
+    return false;
+#endif
+}
 #endif
 
 #ifdef __APPLE__
@@ -47,6 +96,9 @@ static PFNGLUNIFORM1FPROC glUniform1f = nullptr;
 static PFNGLUNIFORM2FPROC glUniform2f = nullptr;
 static PFNGLUNIFORM1IPROC glUniform1i = nullptr;
 static PFNGLACTIVETEXTUREPROC glActiveTexture = nullptr;
+static PFNGLFENCESYNCPROC glFenceSync = nullptr;
+static PFNGLCLIENTWAITSYNCPROC glClientWaitSync = nullptr;
+static PFNGLDELETESYNCPROC glDeleteSync = nullptr;
 
 static bool s_wglExtensionsLoaded = false;
 
@@ -79,10 +131,19 @@ static void loadWGLExtensions() {
     glUniform2f = (PFNGLUNIFORM2FPROC)wglGetProcAddress("glUniform2f");
     glUniform1i = (PFNGLUNIFORM1IPROC)wglGetProcAddress("glUniform1i");
     glActiveTexture = (PFNGLACTIVETEXTUREPROC)wglGetProcAddress("glActiveTexture");
+    glFenceSync = (PFNGLFENCESYNCPROC)wglGetProcAddress("glFenceSync");
+    glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)wglGetProcAddress("glClientWaitSync");
+    glDeleteSync = (PFNGLDELETESYNCPROC)wglGetProcAddress("glDeleteSync");
     s_wglExtensionsLoaded = true;
 }
 #endif
 
+static OpenGLCompositor::UploadMode s_upload_mode = OpenGLCompositor::UploadMode::Sync;
+
+// Texture/PBO storage shared by all compositors (they share the main GL context)
+static GLSurfacePool s_surface_pool;
+static int s_live_compositors = 0;  // Last one out frees the pool
+
 static auto _log_start = std::chrono::steady_clock::now();
 static long _comp_ms() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _log_start).count(); }
 
@@ -122,11 +183,20 @@ static const char* frag_src = R"(#version 130
 in vec2 texCoord;
 out vec4 fragColor;
 uniform sampler2D overlayTex;
+uniform sampler2D popupTex;
 uniform float alpha;
+uniform vec2 texSize;
+uniform vec2 texScale;   // Painted size / allocated size (pooled storage can be larger)
+uniform vec4 popupRect;  // x, y, width, height in texture pixels (width 0 = no popup)
 void main() {
-    vec4 color = texture(overlayTex, texCoord);
     // CEF provides BGRA - swizzle to RGBA
-    fragColor = color.bgra * alpha;
+    vec4 color = texture(overlayTex, texCoord * texScale).bgra;
+    vec2 pp = texCoord * texSize - popupRect.xy;
+    if (popupRect.z > 0.0 && pp.x >= 0.0 && pp.y >= 0.0 && pp.x < popupRect.z && pp.y < popupRect.w) {
+        vec4 popup = texture(popupTex, pp / popupRect.zw).bgra;
+        color = popup + color * (1.0 - popup.a);
+    }
+    fragColor = color * alpha;
 }
 )";
 #else
@@ -148,6 +218,8 @@ uniform float alpha;
 uniform float swizzleBgra;
 uniform vec2 texSize;
 uniform vec2 viewSize;
+uniform sampler2D popupTex;
+uniform highp vec4 popupRect;  // x, y, width, height in texture pixels (width 0 = no popup)
 void main() {
     int px = int(gl_FragCoord.x);
     // Flip Y using viewport height so texture anchors to TOP
@@ -163,26 +235,205 @@ void main() {
     if (swizzleBgra > 0.5) {
         color = color.bgra;
     }
+
+    // Popup layer (software BGRA), premultiplied over the view
+    ivec2 pp = ivec2(px, tex_y) - ivec2(popupRect.xy);
+    if (popupRect.z > 0.0 && pp.x >= 0 && pp.y >= 0 && pp.x < int(popupRect.z) && pp.y < int(popupRect.w)) {
+        vec4 popup = texelFetch(popupTex, pp, 0).bgra;
+        color = popup + color * (1.0 - popup.a);
+    }
     fragColor = color * alpha;
 }
 )";
+
+// Single-pass composite of up to four browser layers (back to front).
+// GLSL ES 3.00 only allows constant sampler indices, so layers are unrolled.
+static const char* batch_frag_src = R"(#version 300 es
+precision mediump float;
+out vec4 fragColor;
+uniform sampler2D layerTex0;
+uniform sampler2D layerTex1;
+uniform sampler2D layerTex2;
+uniform sampler2D layerTex3;
+uniform sampler2D popupTex0;
+uniform sampler2D popupTex1;
+uniform sampler2D popupTex2;
+uniform sampler2D popupTex3;
+uniform int layerCount;
+uniform vec2 viewSize;
+uniform float layerAlpha[4];
+uniform float layerSwizzle[4];
+uniform vec2 layerTexSize[4];
+uniform highp vec4 layerPopup[4];  // x, y, width, height in texture pixels (width 0 = no popup)
+
+vec4 sampleLayer(sampler2D tex, sampler2D popupTex, int i, ivec2 p) {
+    if (p.x >= int(layerTexSize[i].x) || p.y >= int(layerTexSize[i].y)) {
+        return vec4(0.0);
+    }
+    vec4 color = texelFetch(tex, p, 0);
+    if (layerSwizzle[i] > 0.5) {
+        color = color.bgra;
+    }
+    ivec2 pp = p - ivec2(layerPopup[i].xy);
+    if (layerPopup[i].z > 0.0 && pp.x >= 0 && pp.y >= 0 &&
+        pp.x < int(layerPopup[i].z) && pp.y < int(layerPopup[i].w)) {
+        vec4 popup = texelFetch(popupTex, pp, 0).bgra;
+        color = popup + color * (1.0 - popup.a);
+    }
+    return color * layerAlpha[i];
+}
+
+void main() {
+    // Texture anchors to the top of the window at 1:1 pixels
+    ivec2 p = ivec2(int(gl_FragCoord.x), int(viewSize.y) - 1 - int(gl_FragCoord.y));
+    vec4 color = vec4(0.0);
+    vec4 layer;
+    if (layerCount > 0) { layer = sampleLayer(layerTex0, popupTex0, 0, p); color = layer + color * (1.0 - layer.a); }
+    if (layerCount > 1) { layer = sampleLayer(layerTex1, popupTex1, 1, p); color = layer + color * (1.0 - layer.a); }
+    if (layerCount > 2) { layer = sampleLayer(layerTex2, popupTex2, 2, p); color = layer + color * (1.0 - layer.a); }
+    if (layerCount > 3) { layer = sampleLayer(layerTex3, popupTex3, 3, p); color = layer + color * (1.0 - layer.a); }
+    if (color.a <= 0.0) {
+        discard;
+    }
+    fragColor = color;
+}
+)";
+#endif
+
+static GLuint compileShader(GLenum type, const char* src) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+
+    GLint status;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status) {
+        char log[512];
+        glGetShaderInfoLog(shader, 512, nullptr, log);
+        LOG_ERROR(LOG_COMPOSITOR, "%s shader error: %s",
+                  type == GL_VERTEX_SHADER ? "Vertex" : "Fragment", log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+static GLuint linkProgram(const char* vs, const char* fs) {
+    GLuint vert = compileShader(GL_VERTEX_SHADER, vs);
+    if (!vert) return 0;
+    GLuint frag = compileShader(GL_FRAGMENT_SHADER, fs);
+    if (!frag) {
+        glDeleteShader(vert);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vert);
+    glAttachShader(program, frag);
+    glLinkProgram(program);
+    glDeleteShader(vert);
+    glDeleteShader(frag);
+
+    GLint status;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status) {
+        char log[512];
+        glGetProgramInfoLog(program, 512, nullptr, log);
+        LOG_ERROR(LOG_COMPOSITOR, "Program link error: %s", log);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+// Program shared by every compositor for compositeLayers (main GL context)
+static struct {
+    GLuint program = 0;
+    GLuint vao = 0;
+    bool failed = false;  // Don't retry a shader the driver rejected
+    int users = 0;        // Initialized compositors
+    GLint count_loc = -1;
+    GLint view_size_loc = -1;
+    GLint tex_loc[OpenGLCompositor::kMaxBatchLayers] = {};
+    GLint popup_tex_loc[OpenGLCompositor::kMaxBatchLayers] = {};
+    GLint alpha_loc[OpenGLCompositor::kMaxBatchLayers] = {};
+    GLint swizzle_loc[OpenGLCompositor::kMaxBatchLayers] = {};
+    GLint tex_size_loc[OpenGLCompositor::kMaxBatchLayers] = {};
+    GLint popup_rect_loc[OpenGLCompositor::kMaxBatchLayers] = {};
+} s_batch;
+
+static bool createBatchProgram() {
+    s_batch.program = linkProgram(vert_src, batch_frag_src);
+    if (!s_batch.program) {
+        LOG_WARN(LOG_COMPOSITOR, "Batch composite shader unavailable, drawing layers separately");
+        return false;
+    }
+    s_batch.count_loc = glGetUniformLocation(s_batch.program, "layerCount");
+    s_batch.view_size_loc = glGetUniformLocation(s_batch.program, "viewSize");
+    char name[32];
+    for (int i = 0; i < OpenGLCompositor::kMaxBatchLayers; i++) {
+        snprintf(name, sizeof(name), "layerTex%d", i);
+        s_batch.tex_loc[i] = glGetUniformLocation(s_batch.program, name);
+        snprintf(name, sizeof(name), "popupTex%d", i);
+        s_batch.popup_tex_loc[i] = glGetUniformLocation(s_batch.program, name);
+        snprintf(name, sizeof(name), "layerAlpha[%d]", i);
+        s_batch.alpha_loc[i] = glGetUniformLocation(s_batch.program, name);
+        snprintf(name, sizeof(name), "layerSwizzle[%d]", i);
+        s_batch.swizzle_loc[i] = glGetUniformLocation(s_batch.program, name);
+        snprintf(name, sizeof(name), "layerTexSize[%d]", i);
+        s_batch.tex_size_loc[i] = glGetUniformLocation(s_batch.program, name);
+        snprintf(name, sizeof(name), "layerPopup[%d]", i);
+        s_batch.popup_rect_loc[i] = glGetUniformLocation(s_batch.program, name);
+    }
+    glGenVertexArrays(1, &s_batch.vao);
+    LOG_INFO(LOG_COMPOSITOR, "Batch composite shader ready (%d layers per draw)",
+             OpenGLCompositor::kMaxBatchLayers);
+    return true;
+}
+
+static void destroyBatchProgram() {
+    if (s_batch.program) {
+        glDeleteProgram(s_batch.program);
+        s_batch.program = 0;
+    }
+    if (s_batch.vao) {
+        glDeleteVertexArrays(1, &s_batch.vao);
+        s_batch.vao = 0;
+    }
+    s_batch.failed = false;
+}
 #endif
 
 OpenGLCompositor::OpenGLCompositor() = default;
 
+int OpenGLCompositor::trimSurfacePool() {
+    return s_surface_pool.trim();
+}
+
+void OpenGLCompositor::setUploadMode(UploadMode mode) {
+    s_upload_mode = mode;
+}
+
+OpenGLCompositor::UploadMode OpenGLCompositor::uploadMode() {
+    return s_upload_mode;
+}
+
 OpenGLCompositor::~OpenGLCompositor() {
     cleanup();
 }
 
 bool OpenGLCompositor::init(GLContext* ctx, uint32_t width, uint32_t height) {
     ctx_ = ctx;
+    s_live_compositors++;  // Paired with cleanup (which runs whenever ctx_ is set)
     width_ = width;
     height_ = height;
 
-    // Assign unique texture unit to this compositor instance
+    // Assign unique texture units (view + popup) to this compositor instance
     static int next_texture_unit = 0;
     texture_unit_ = next_texture_unit++;
-    LOG_INFO(LOG_COMPOSITOR, "Compositor initialized with texture unit %d", texture_unit_);
+    popup_texture_unit_ = next_texture_unit++;
+    LOG_INFO(LOG_COMPOSITOR, "Compositor initialized with texture units %d/%d", texture_unit_, popup_texture_unit_);
 
 #ifdef _WIN32
     loadWGLExtensions();
@@ -202,8 +453,24 @@ bool OpenGLCompositor::init(GLContext* ctx, uint32_t width, uint32_t height) {
         eglDestroyImageKHR = (PFNEGLDESTROYIMAGEKHRPROC)
             eglGetProcAddress("eglDestroyImageKHR");
     }
-    if (glEGLImageTargetTexture2DOES && eglCreateImageKHR && eglDestroyImageKHR) {
-        LOG_INFO(LOG_COMPOSITOR, "EGL dmabuf import extensions loaded");
+    if (!eglCreateSyncKHR) {
+        eglCreateSyncKHR = (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+        eglDestroySyncKHR = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress("eglDestroySyncKHR");
+        eglWaitSyncKHR = (PFNEGLWAITSYNCKHRPROC)eglGetProcAddress("eglWaitSyncKHR");
+        eglDupNativeFenceFDANDROID = (PFNEGLDUPNATIVEFENCEFDANDROIDPROC)
+            eglGetProcAddress("eglDupNativeFenceFDANDROID");
+    }
+    if (ctx_) {
+        EGLDisplay display = ctx_->display();
+        s_dmabuf_import = hasEglExtension(display, "EGL_EXT_image_dma_buf_import");
+        s_native_fence_sync = hasEglExtension(display, "EGL_ANDROID_native_fence_sync") &&
+                              hasEglExtension(display, "EGL_KHR_wait_sync") &&
+                              eglCreateSyncKHR && eglDestroySyncKHR && eglWaitSyncKHR &&
+                              eglDupNativeFenceFDANDROID;
+    }
+    if (glEGLImageTargetTexture2DOES && eglCreateImageKHR && eglDestroyImageKHR && s_dmabuf_import) {
+        LOG_INFO(LOG_COMPOSITOR, "EGL dmabuf import extensions loaded (explicit sync: %s)",
+                 s_native_fence_sync ? "yes" : "no");
     } else {
         LOG_WARN(LOG_COMPOSITOR, "EGL dmabuf import extensions not available");
     }
@@ -211,6 +478,9 @@ bool OpenGLCompositor::init(GLContext* ctx, uint32_t width, uint32_t height) {
 
     if (!createTexture()) return false;
     if (!createShader()) return false;
+#if !defined(__APPLE__) && !defined(_WIN32)
+    s_batch.users++;
+#endif
 
     // Create VAO (required for GLES 3.0 / OpenGL core)
     glGenVertexArrays(1, &vao_);
@@ -219,54 +489,27 @@ bool OpenGLCompositor::init(GLContext* ctx, uint32_t width, uint32_t height) {
 }
 
 bool OpenGLCompositor::createTexture() {
-    glGenTextures(1, &texture_);
-    glBindTexture(GL_TEXTURE_2D, texture_);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-#ifdef __APPLE__
-    // Software path: allocate texture storage and PBOs
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width_, height_, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
-#elif defined(_WIN32)
-    // Windows: Software path only
-    // Use GL_RGBA (universally supported) - shader swizzles BGRA->RGBA
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    GLenum texErr = glGetError();
-    if (texErr != GL_NO_ERROR) {
-        LOG_ERROR(LOG_COMPOSITOR, "glTexImage2D failed: %d", texErr);
-        return false;
-    }
-#else
-    // Software path: allocate texture storage and PBOs
-    // Use GL_RGBA (universally supported) - shader swizzles BGRA->RGBA
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    GLenum texErr = glGetError();
-    if (texErr != GL_NO_ERROR) {
-        LOG_ERROR(LOG_COMPOSITOR, "glTexImage2D failed: %d", texErr);
+    // Storage comes from the surface pool: a resize that stays within the
+    // current bucket gets the same texture and PBOs straight back
+    texture_ = s_surface_pool.acquireTexture(width_, height_, GL_NEAREST);
+    if (!texture_.id) {
+        LOG_ERROR(LOG_COMPOSITOR, "Legacy texture allocation failed (%ux%u)", width_, height_);
         return false;
     }
-#endif
 
-    // Create double-buffered PBOs for async upload
+    // Double-buffered PBOs for async upload
     size_t pbo_size = width_ * height_ * 4;
-    glGenBuffers(2, pbos_);
-    for (int i = 0; i < 2; i++) {
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[i]);
-        glBufferData(GL_PIXEL_UNPACK_BUFFER, pbo_size, nullptr, GL_STREAM_DRAW);
-    }
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-
-    GLenum pboErr = glGetError();
-    if (pboErr != GL_NO_ERROR) {
-        LOG_ERROR(LOG_COMPOSITOR, "PBO creation failed: %d", pboErr);
-        return false;
+    for (auto& pbo : pbos_) {
+        pbo = s_surface_pool.acquireBuffer(pbo_size);
+        if (!pbo.id) {
+            LOG_ERROR(LOG_COMPOSITOR, "PBO creation failed (%zu bytes)", pbo_size);
+            return false;
+        }
     }
 
     // Map the first PBO for writing
     current_pbo_ = 0;
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_]);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_].id);
     pbo_mapped_ = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, pbo_size,
                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
@@ -281,63 +524,20 @@ bool OpenGLCompositor::createTexture() {
 }
 
 bool OpenGLCompositor::createShader() {
-    // Compile vertex shader
-    GLuint vert = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vert, 1, &vert_src, nullptr);
-    glCompileShader(vert);
-
-    GLint status;
-    glGetShaderiv(vert, GL_COMPILE_STATUS, &status);
-    if (!status) {
-        char log[512];
-        glGetShaderInfoLog(vert, 512, nullptr, log);
-        LOG_ERROR(LOG_COMPOSITOR, "Vertex shader error: %s", log);
-        glDeleteShader(vert);
-        return false;
-    }
-
-    // Compile fragment shader
-    GLuint frag = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(frag, 1, &frag_src, nullptr);
-    glCompileShader(frag);
-
-    glGetShaderiv(frag, GL_COMPILE_STATUS, &status);
-    if (!status) {
-        char log[512];
-        glGetShaderInfoLog(frag, 512, nullptr, log);
-        LOG_ERROR(LOG_COMPOSITOR, "Fragment shader error: %s", log);
-        glDeleteShader(vert);
-        glDeleteShader(frag);
+    program_ = linkProgram(vert_src, frag_src);
+    if (!program_) {
         return false;
     }
 
-    // Link program
-    program_ = glCreateProgram();
-    glAttachShader(program_, vert);
-    glAttachShader(program_, frag);
-    glLinkProgram(program_);
-
-    glGetProgramiv(program_, GL_LINK_STATUS, &status);
-    if (!status) {
-        char log[512];
-        glGetProgramInfoLog(program_, 512, nullptr, log);
-        LOG_ERROR(LOG_COMPOSITOR, "Program link error: %s", log);
-        glDeleteShader(vert);
-        glDeleteShader(frag);
-        glDeleteProgram(program_);
-        program_ = 0;
-        return false;
-    }
-
-    glDeleteShader(vert);
-    glDeleteShader(frag);
-
     // Get uniform locations
     alpha_loc_ = glGetUniformLocation(program_, "alpha");
     swizzle_loc_ = glGetUniformLocation(program_, "swizzleBgra");
     tex_size_loc_ = glGetUniformLocation(program_, "texSize");
     view_size_loc_ = glGetUniformLocation(program_, "viewSize");
+    tex_scale_loc_ = glGetUniformLocation(program_, "texScale");
     sampler_loc_ = glGetUniformLocation(program_, "overlayTex");
+    popup_sampler_loc_ = glGetUniformLocation(program_, "popupTex");
+    popup_rect_loc_ = glGetUniformLocation(program_, "popupRect");
 
     return true;
 }
@@ -361,58 +561,297 @@ void* OpenGLCompositor::getStagingBuffer(int width, int height) {
     return pbo_mapped_;
 }
 
-void OpenGLCompositor::updateOverlayPartial(const void* data, int src_width, int src_height) {
+size_t OpenGLCompositor::updateOverlayPartial(const void* data, int src_width, int src_height,
+                                              const DamageRegion* damage) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (!data || src_width <= 0 || src_height <= 0) return;
+    if (!data || src_width <= 0 || src_height <= 0) return 0;
+
+    bool full_upload = !damage || damage->full();
 
-    // Recreate CEF texture if size changed or texture doesn't exist
-    if (cef_texture_ == 0 || src_width != cef_texture_width_ || src_height != cef_texture_height_) {
+    // New storage only when the frame outgrows the pooled texture (or shrinks far below it)
+    if (!cef_texture_.id || !GLSurfacePool::fits(cef_texture_.width, cef_texture_.height, src_width, src_height)) {
         LOG_DEBUG(LOG_COMPOSITOR, "updateOverlayPartial: RECREATE %dx%d -> %dx%d (viewport=%ux%u)",
                   cef_texture_width_, cef_texture_height_, src_width, src_height, width_, height_);
-        if (cef_texture_) {
-            glDeleteTextures(1, &cef_texture_);
+        s_surface_pool.release(cef_texture_);
+        cef_texture_ = s_surface_pool.acquireTexture(src_width, src_height, GL_NEAREST);  // No interpolation for 1:1
+        cef_texture_width_ = 0;
+        cef_texture_height_ = 0;
+        texture_valid_ = false;  // Need valid data before rendering
+        if (!cef_texture_.id) {
+            return 0;
         }
-        glGenTextures(1, &cef_texture_);
-        glBindTexture(GL_TEXTURE_2D, cef_texture_);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // No interpolation for 1:1
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        // Reset pixel unpack state before texture allocation
+        LOG_DEBUG(LOG_COMPOSITOR, "Created CEF texture %dx%d (storage %dx%d)",
+                  src_width, src_height, cef_texture_.width, cef_texture_.height);
+    }
+    if (src_width != cef_texture_width_ || src_height != cef_texture_height_) {
+        cef_texture_width_ = src_width;
+        cef_texture_height_ = src_height;
+        full_upload = true;  // Texels of the new size were never written at this layout
+    }
+
+    // Partial damage can't produce a valid texture from scratch
+    if (!texture_valid_) {
+        full_upload = true;
+    }
+
+    auto upload_start = std::chrono::steady_clock::now();
+
+    glBindTexture(GL_TEXTURE_2D, cef_texture_.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    size_t uploaded = 0;
+    bool via_ring = false;
+#ifndef _WIN32
+    via_ring = s_upload_mode == UploadMode::Ring;
+#else
+    via_ring = s_upload_mode == UploadMode::Ring && glFenceSync && glClientWaitSync && glDeleteSync;
+#endif
+    if (via_ring) {
+        via_ring = uploadThroughRing(static_cast<const uint8_t*>(data), src_width, src_height,
+                                     damage, full_upload, uploaded);
+    }
+    if (!via_ring && full_upload) {
+        // Reset pixel unpack state to ensure no offset/stride issues
         glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
         glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
         glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, src_width, src_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        cef_texture_width_ = src_width;
-        cef_texture_height_ = src_height;
-        texture_valid_ = false;  // Need valid data before rendering
-        LOG_DEBUG(LOG_COMPOSITOR, "Created CEF texture %dx%d", src_width, src_height);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, src_width, src_height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        uploaded = static_cast<size_t>(src_width) * src_height * 4;
+    } else if (!via_ring) {
+        // Upload each damaged rect straight out of the full-size source buffer
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, src_width);
+        for (const auto& rect : damage->rects()) {
+            DamageRect r = clipDamageRect(rect, src_width, src_height);
+            if (r.empty()) continue;
+            glPixelStorei(GL_UNPACK_SKIP_PIXELS, r.x);
+            glPixelStorei(GL_UNPACK_SKIP_ROWS, r.y);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y, r.width, r.height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            uploaded += static_cast<size_t>(r.area()) * 4;
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    }
+    texture_valid_ = true;
+    has_content_ = true;
+    if (full_upload) {
+        frame_damage_.setFull();
+    } else {
+        frame_damage_.merge(*damage);
+    }
+
+    if (!via_ring) {
+        // Ensure GPU finishes reading source data before returning.
+        // Without this, driver may still be reading from 'data' when caller
+        // releases buffer, causing heap corruption if buffer is resized.
+        glFinish();
+    }
+
+    auto upload_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - upload_start).count());
+    upload_count_++;
+    upload_time_us_ += upload_us;
+    upload_max_us_ = std::max(upload_max_us_, upload_us);
+    if (upload_count_ % 300 == 0) {
+        LOG_DEBUG(LOG_COMPOSITOR, "upload stats (%s): %llu uploads, avg %.0fus, max %lluus, orphaned %llu",
+                  via_ring ? "ring" : "sync", static_cast<unsigned long long>(upload_count_),
+                  static_cast<double>(upload_time_us_) / upload_count_,
+                  static_cast<unsigned long long>(upload_max_us_),
+                  static_cast<unsigned long long>(upload_orphans_));
+        upload_max_us_ = 0;
+    }
+    return uploaded;
+}
+
+bool OpenGLCompositor::uploadThroughRing(const uint8_t* data, int src_width, int src_height,
+                                         const DamageRegion* damage, bool full_upload, size_t& uploaded) {
+    uploaded = 0;
+    size_t stride = static_cast<size_t>(src_width) * 4;
+    size_t frame_size = stride * src_height;
+
+    // Rows touched by this upload - only that range of the slot is mapped
+    int min_y = 0;
+    int max_y = src_height;
+    if (!full_upload) {
+        min_y = src_height;
+        max_y = 0;
+        for (const auto& rect : damage->rects()) {
+            DamageRect r = clipDamageRect(rect, src_width, src_height);
+            if (r.empty()) continue;
+            min_y = std::min(min_y, r.y);
+            max_y = std::max(max_y, r.y + r.height);
+        }
+        if (max_y <= min_y) {
+            return true;  // Damage lies entirely outside the frame
+        }
+    }
+
+    // Take the first slot the GPU is done with (zero-timeout poll, never blocks)
+    int slot_idx = -1;
+    for (int i = 0; i < kUploadRingSize; i++) {
+        int idx = (upload_slot_ + i) % kUploadRingSize;
+        UploadSlot& candidate = upload_ring_[idx];
+        if (!candidate.fence) {
+            slot_idx = idx;
+            break;
+        }
+        GLenum status = glClientWaitSync(candidate.fence, 0, 0);
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+            glDeleteSync(candidate.fence);
+            candidate.fence = nullptr;
+            slot_idx = idx;
+            break;
+        }
+    }
+    bool orphan = false;
+    if (slot_idx < 0) {
+        // Every slot still in flight: orphan the oldest so the driver hands us
+        // fresh storage instead of stalling until the GPU releases it
+        slot_idx = upload_slot_;
+        orphan = true;
+        upload_orphans_++;
+    }
+    upload_slot_ = (slot_idx + 1) % kUploadRingSize;
+    UploadSlot& slot = upload_ring_[slot_idx];
+
+    if (!slot.pbo) {
+        glGenBuffers(1, &slot.pbo);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+    if (orphan || !GLSurfacePool::fitsBytes(slot.size, frame_size)) {
+        // Grow-only in buffer buckets, so resizing doesn't reallocate every frame
+        size_t alloc = GLSurfacePool::fitsBytes(slot.size, frame_size) ? slot.size
+                                                                        : GLSurfacePool::bucketBytes(frame_size);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, alloc, nullptr, GL_STREAM_DRAW);
+        slot.size = alloc;
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+    }
+
+    // Slot is idle (or freshly orphaned), so an unsynchronized map is safe
+    size_t map_offset = static_cast<size_t>(min_y) * stride;
+    size_t map_length = static_cast<size_t>(max_y - min_y) * stride;
+    auto* mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, map_offset, map_length,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    if (!mapped) {
+        LOG_WARN(LOG_COMPOSITOR, "upload ring: glMapBufferRange failed (0x%x), using sync upload", glGetError());
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
     }
 
-    // Upload CEF frame directly to texture
-    // Reset pixel unpack state to ensure no offset/stride issues
+    // Stage into the slot at the same layout as the source, then unpack from it
+    if (full_upload) {
+        std::memcpy(mapped, data, frame_size);
+        uploaded = frame_size;
+    } else {
+        for (const auto& rect : damage->rects()) {
+            DamageRect r = clipDamageRect(rect, src_width, src_height);
+            if (r.empty()) continue;
+            copyDamageRect(mapped - map_offset, data, src_width, r);
+            uploaded += static_cast<size_t>(r.area()) * 4;
+        }
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    if (full_upload) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, src_width, src_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    } else {
+        // With PBO bound, last arg is offset into PBO, not pointer
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, src_width);
+        for (const auto& rect : damage->rects()) {
+            DamageRect r = clipDamageRect(rect, src_width, src_height);
+            if (r.empty()) continue;
+            size_t offset = static_cast<size_t>(r.y) * stride + static_cast<size_t>(r.x) * 4;
+            glTexSubImage2D(GL_TEXTURE_2D, 0, r.x, r.y, r.width, r.height, GL_RGBA, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(offset));
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    // Fence marks when the GPU has consumed this slot
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    return true;
+}
+
+size_t OpenGLCompositor::updatePopup(const void* data, int width, int height) {
+    if (!data || width <= 0 || height <= 0) return 0;
+
+    // Popups are small and uploaded whole; the view texture is left untouched
+    glActiveTexture(GL_TEXTURE0 + popup_texture_unit_);
+    if (!popup_texture_) {
+        glGenTextures(1, &popup_texture_);
+        glBindTexture(GL_TEXTURE_2D, popup_texture_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // No interpolation for 1:1
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, popup_texture_);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
     glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (width != popup_width_ || height != popup_height_) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        popup_width_ = width;
+        popup_height_ = height;
+        LOG_DEBUG(LOG_COMPOSITOR, "Created popup texture %dx%d", width, height);
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    }
+    glActiveTexture(GL_TEXTURE0 + texture_unit_);
+    if (!popup_rect_.empty()) {
+        frame_damage_.add({popup_rect_.x, popup_rect_.y, popup_width_, popup_height_});
+    }
+    return static_cast<size_t>(width) * height * 4;
+}
 
-    glBindTexture(GL_TEXTURE_2D, cef_texture_);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, src_width, src_height, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    texture_valid_ = true;
-    has_content_ = true;
+void OpenGLCompositor::setPopupRect(const DamageRect& rect) {
+    if (rect.x == popup_rect_.x && rect.y == popup_rect_.y &&
+        rect.width == popup_rect_.width && rect.height == popup_rect_.height) {
+        return;
+    }
+    // Both where the popup was drawn and where it will be drawn change
+    if (popup_texture_) {
+        if (!popup_rect_.empty()) {
+            frame_damage_.add({popup_rect_.x, popup_rect_.y, popup_width_, popup_height_});
+        }
+        if (!rect.empty()) {
+            frame_damage_.add({rect.x, rect.y, popup_width_, popup_height_});
+        }
+    }
+    popup_rect_ = rect;
+}
 
-    // Ensure GPU finishes reading source data before returning.
-    // Without this, driver may still be reading from 'data' when caller
-    // releases buffer, causing heap corruption if buffer is resized.
-    glFinish();
+void OpenGLCompositor::destroyUploadRing() {
+    for (auto& slot : upload_ring_) {
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.pbo) {
+            glDeleteBuffers(1, &slot.pbo);
+            slot.pbo = 0;
+        }
+        slot.size = 0;
+    }
+    upload_slot_ = 0;
 }
 
 bool OpenGLCompositor::flushOverlay() {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    if (!staging_pending_ || !texture_) {
+    if (!staging_pending_ || !texture_.id) {
         return false;
     }
 
@@ -421,46 +860,107 @@ bool OpenGLCompositor::flushOverlay() {
     size_t pbo_size = width_ * height_ * 4;
 
     // Unmap current PBO and start async DMA transfer to texture
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_]);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_].id);
     glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
 
-    glBindTexture(GL_TEXTURE_2D, texture_);
+    glBindTexture(GL_TEXTURE_2D, texture_.id);
     // With PBO bound, last arg is offset into PBO, not pointer
     // Upload as RGBA - shader swizzles BGRA->RGBA
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
     // Swap to next PBO and map it for next frame's writes
     current_pbo_ = 1 - current_pbo_;
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_]);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_].id);
     pbo_mapped_ = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, pbo_size,
                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     staging_pending_ = false;
     has_content_ = true;
+    frame_damage_.setFull();
     return true;
 }
 
-void OpenGLCompositor::queueDmabuf(int fd, uint32_t stride, uint64_t modifier, int w, int h) {
+uint64_t OpenGLCompositor::queueDmabuf(const DmabufFrame& frame) {
 #if !defined(__APPLE__) && !defined(_WIN32)
     std::lock_guard<std::mutex> lock(mutex_);
 
-    // Close any previously queued fd that wasn't imported
-    if (dmabuf_pending_.load(std::memory_order_relaxed) && queued_dmabuf_.fd >= 0) {
-        close(queued_dmabuf_.fd);
+    // Drop any previously queued frame that wasn't imported - nothing will sample it
+    if (dmabuf_pending_.load(std::memory_order_relaxed)) {
+        closeDmabufFrame(queued_dmabuf_);
+        dmabuf_released_ticket_ = std::max(dmabuf_released_ticket_, queued_ticket_);
+        dmabuf_release_cv_.notify_all();
     }
 
-    queued_dmabuf_.fd = fd;
-    queued_dmabuf_.stride = stride;
-    queued_dmabuf_.modifier = modifier;
-    queued_dmabuf_.width = w;
-    queued_dmabuf_.height = h;
+    queued_dmabuf_ = frame;
+    queued_ticket_ = ++dmabuf_next_ticket_;
     dmabuf_pending_.store(true, std::memory_order_release);
+    return queued_ticket_;
+#else
+    (void)frame;
+    return 0;
+#endif
+}
+
+bool OpenGLCompositor::waitDmabufReleased(uint64_t ticket, int timeout_ms) {
+#if !defined(__APPLE__) && !defined(_WIN32)
+    std::unique_lock<std::mutex> lock(mutex_);
+    return dmabuf_release_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                       [&]() { return dmabuf_released_ticket_ >= ticket; });
 #else
-    (void)fd; (void)stride; (void)modifier; (void)w; (void)h;
+    (void)ticket; (void)timeout_ms;
+    return true;
 #endif
 }
 
+bool OpenGLCompositor::dmabufImportSupported() const {
+#if !defined(__APPLE__) && !defined(_WIN32)
+    return glEGLImageTargetTexture2DOES && eglCreateImageKHR && eglDestroyImageKHR &&
+           s_dmabuf_import && s_native_fence_sync;
+#else
+    return false;
+#endif
+}
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+void OpenGLCompositor::releaseDmabuf(uint64_t ticket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ticket > dmabuf_released_ticket_) {
+        dmabuf_released_ticket_ = ticket;
+        dmabuf_release_cv_.notify_all();
+    }
+}
+
+void OpenGLCompositor::fenceCompositedDmabuf() {
+    // Put our reads into the buffer's reservation, so CEF's next write to it
+    // waits on the GPU instead of on us. Drivers with implicit sync already
+    // track the read once submitted, hence the plain flush fallback.
+    bool fenced = false;
+    if (s_native_fence_sync && dmabuf_current_fd_ >= 0) {
+        EGLDisplay display = ctx_->display();
+        EGLSyncKHR sync = eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID, nullptr);
+        glFlush();  // Native fence fd only exists once the fence is flushed
+        if (sync != EGL_NO_SYNC_KHR) {
+            int fence_fd = eglDupNativeFenceFDANDROID(display, sync);
+            eglDestroySyncKHR(display, sync);
+            if (fence_fd >= 0) {
+                fenced = importDmabufSyncFile(dmabuf_current_fd_, fence_fd);
+                close(fence_fd);
+            }
+        }
+    } else {
+        glFlush();
+    }
+    if (log_count_ < 3) {
+        LOG_DEBUG(LOG_COMPOSITOR, "dmabuf release #%llu (%s)",
+                  static_cast<unsigned long long>(dmabuf_current_ticket_),
+                  fenced ? "release fence attached" : "implicit sync");
+    }
+    releaseDmabuf(dmabuf_current_ticket_);
+    dmabuf_current_ticket_ = 0;
+}
+#endif
+
 bool OpenGLCompositor::importQueuedDmabuf() {
 #if !defined(__APPLE__) && !defined(_WIN32)
     // Fast-path: check atomic without lock
@@ -473,96 +973,196 @@ bool OpenGLCompositor::importQueuedDmabuf() {
     }
 
     // Get queued dmabuf under lock
-    int fd;
-    uint32_t stride;
-    uint64_t modifier;
-    int w, h;
+    DmabufFrame frame;
+    uint64_t ticket;
     {
         std::lock_guard<std::mutex> lock(mutex_);
         if (!dmabuf_pending_.load(std::memory_order_relaxed)) {
             return false;  // Another thread got it
         }
-        fd = queued_dmabuf_.fd;
-        stride = queued_dmabuf_.stride;
-        modifier = queued_dmabuf_.modifier;
-        w = queued_dmabuf_.width;
-        h = queued_dmabuf_.height;
+        frame = queued_dmabuf_;
+        ticket = queued_ticket_;
         dmabuf_pending_.store(false, std::memory_order_relaxed);
-        queued_dmabuf_.fd = -1;
+        queued_dmabuf_ = DmabufFrame();
     }
 
-    if (fd < 0) {
+    if (frame.plane_count <= 0 || frame.planes[0].fd < 0) {
+        closeDmabufFrame(frame);
+        releaseDmabuf(ticket);
         return false;
     }
 
+    // A frame imported but never composited is superseded by this one
+    if (dmabuf_current_ticket_) {
+        releaseDmabuf(dmabuf_current_ticket_);
+        dmabuf_current_ticket_ = 0;
+    }
+
+    int w = frame.width;
+    int h = frame.height;
     EGLDisplay display = ctx_->display();
 
-    // Destroy previous EGLImage if exists
-    if (egl_image_) {
-        eglDestroyImageKHR(display, static_cast<EGLImageKHR>(egl_image_));
-        egl_image_ = nullptr;
+    // Wait (on the GPU, not the CPU) for CEF's writes before sampling.
+    // Without sync_file export the driver's implicit sync applies.
+    int acquire_fd = exportDmabufSyncFile(frame.planes[0].fd);
+    if (acquire_fd >= 0) {
+        bool waited = false;
+        if (s_native_fence_sync) {
+            EGLint sync_attrs[] = {EGL_SYNC_NATIVE_FENCE_FD_ANDROID, acquire_fd, EGL_NONE};
+            EGLSyncKHR sync = eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID, sync_attrs);
+            if (sync != EGL_NO_SYNC_KHR) {
+                // EGL owns acquire_fd now
+                waited = eglWaitSyncKHR(display, sync, 0) == EGL_TRUE;
+                eglDestroySyncKHR(display, sync);
+                acquire_fd = -1;
+            }
+        }
+        if (acquire_fd >= 0) {
+            close(acquire_fd);
+        }
+        if (!waited && log_count_ < 3) {
+            LOG_DEBUG(LOG_COMPOSITOR, "dmabuf acquire fence not waited, relying on implicit sync");
+        }
     }
 
-    // Create dmabuf texture if needed
-    if (!dmabuf_texture_) {
-        glGenTextures(1, &dmabuf_texture_);
-        glBindTexture(GL_TEXTURE_2D, dmabuf_texture_);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    // The dup'd fd differs every paint; dev/inode identify the buffer itself
+    struct stat st;
+    if (fstat(frame.planes[0].fd, &st) != 0) {
+        LOG_ERROR(LOG_COMPOSITOR, "fstat on dmabuf fd failed");
+        closeDmabufFrame(frame);
+        releaseDmabuf(ticket);
+        return false;
+    }
+    DmabufKey key;
+    key.dev = static_cast<uint64_t>(st.st_dev);
+    key.ino = static_cast<uint64_t>(st.st_ino);
+    key.fourcc = frame.fourcc;
+    key.modifier = frame.modifier;
+    key.plane_count = frame.plane_count;
+    for (int i = 0; i < frame.plane_count; i++) {
+        key.strides[i] = frame.planes[i].stride;
+        key.offsets[i] = frame.planes[i].offset;
     }
 
-    // Create EGLImage from dmabuf
-    // CEF uses DRM_FORMAT_ARGB8888 - EGL import handles format conversion
-    // DRM_FORMAT_MOD_INVALID means no modifier - don't include modifier attrs
-    EGLImageKHR image;
-    if (modifier == DRM_FORMAT_MOD_INVALID) {
-        EGLint attrs[] = {
-            EGL_WIDTH, w,
-            EGL_HEIGHT, h,
-            EGL_LINUX_DRM_FOURCC_EXT, DRM_FORMAT_ARGB8888,
-            EGL_DMA_BUF_PLANE0_FD_EXT, fd,
-            EGL_DMA_BUF_PLANE0_OFFSET_EXT, 0,
-            EGL_DMA_BUF_PLANE0_PITCH_EXT, static_cast<EGLint>(stride),
-            EGL_NONE
-        };
-        image = eglCreateImageKHR(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attrs);
+    // Resized view means CEF reallocated its pool - none of the old buffers return
+    if (w != dmabuf_width_ || h != dmabuf_height_) {
+        if (!dmabuf_cache_.empty()) {
+            LOG_DEBUG(LOG_COMPOSITOR, "dmabuf cache: flush %zu entries on resize %dx%d -> %dx%d",
+                      dmabuf_cache_.size(), dmabuf_width_, dmabuf_height_, w, h);
+        }
+        destroyDmabufCache();
+    }
+
+    dmabuf_imports_++;
+    DmabufCacheEntry* entry = nullptr;
+    for (auto& e : dmabuf_cache_) {
+        if (e.key == key) {
+            entry = &e;
+            break;
+        }
+    }
+
+    if (entry) {
+        dmabuf_cache_hits_++;
+        // EGLImage and the cached fd hold their own references to the buffer
+        closeDmabufFrame(frame);
     } else {
-        EGLint attrs[] = {
+        dmabuf_cache_misses_++;
+
+        // Create EGLImage from every plane CEF provided
+        // DRM_FORMAT_MOD_INVALID means no modifier - don't include modifier attrs
+        static const EGLint plane_attrs[DmabufFrame::kMaxPlanes][5] = {
+            {EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE0_PITCH_EXT,
+             EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT},
+            {EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT,
+             EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT},
+            {EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT,
+             EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT},
+            {EGL_DMA_BUF_PLANE3_FD_EXT, EGL_DMA_BUF_PLANE3_OFFSET_EXT, EGL_DMA_BUF_PLANE3_PITCH_EXT,
+             EGL_DMA_BUF_PLANE3_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE3_MODIFIER_HI_EXT},
+        };
+        std::vector<EGLint> attrs = {
             EGL_WIDTH, w,
             EGL_HEIGHT, h,
-            EGL_LINUX_DRM_FOURCC_EXT, DRM_FORMAT_ARGB8888,
-            EGL_DMA_BUF_PLANE0_FD_EXT, fd,
-            EGL_DMA_BUF_PLANE0_OFFSET_EXT, 0,
-            EGL_DMA_BUF_PLANE0_PITCH_EXT, static_cast<EGLint>(stride),
-            EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, static_cast<EGLint>(modifier & 0xFFFFFFFF),
-            EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT, static_cast<EGLint>(modifier >> 32),
-            EGL_NONE
+            EGL_LINUX_DRM_FOURCC_EXT, static_cast<EGLint>(frame.fourcc),
         };
-        image = eglCreateImageKHR(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attrs);
-    }
+        for (int i = 0; i < frame.plane_count; i++) {
+            attrs.push_back(plane_attrs[i][0]);
+            attrs.push_back(frame.planes[i].fd);
+            attrs.push_back(plane_attrs[i][1]);
+            attrs.push_back(static_cast<EGLint>(frame.planes[i].offset));
+            attrs.push_back(plane_attrs[i][2]);
+            attrs.push_back(static_cast<EGLint>(frame.planes[i].stride));
+            if (frame.modifier != DRM_FORMAT_MOD_INVALID) {
+                attrs.push_back(plane_attrs[i][3]);
+                attrs.push_back(static_cast<EGLint>(frame.modifier & 0xFFFFFFFF));
+                attrs.push_back(plane_attrs[i][4]);
+                attrs.push_back(static_cast<EGLint>(frame.modifier >> 32));
+            }
+        }
+        attrs.push_back(EGL_NONE);
+        EGLImageKHR image = eglCreateImageKHR(display, EGL_NO_CONTEXT, EGL_LINUX_DMA_BUF_EXT, nullptr, attrs.data());
+
+        // Keep plane 0 for release fences, close the rest (EGL keeps its own references)
+        int keep_fd = frame.planes[0].fd;
+        frame.planes[0].fd = -1;
+        closeDmabufFrame(frame);
+
+        if (!image) {
+            EGLint err = eglGetError();
+            LOG_ERROR(LOG_COMPOSITOR, "eglCreateImageKHR failed: 0x%x (fourcc=0x%x planes=%d modifier=0x%lx)",
+                      err, frame.fourcc, frame.plane_count, frame.modifier);
+            close(keep_fd);
+            releaseDmabuf(ticket);
+            return false;
+        }
 
-    // Close the fd after creating the EGLImage (EGL keeps its own reference)
-    close(fd);
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, image);
+
+        GLenum glErr = glGetError();
+        if (glErr != GL_NO_ERROR) {
+            LOG_ERROR(LOG_COMPOSITOR, "glEGLImageTargetTexture2DOES failed: 0x%x", glErr);
+            glDeleteTextures(1, &texture);
+            eglDestroyImageKHR(display, image);
+            close(keep_fd);
+            releaseDmabuf(ticket);
+            return false;
+        }
 
-    if (!image) {
-        EGLint err = eglGetError();
-        LOG_ERROR(LOG_COMPOSITOR, "eglCreateImageKHR failed: 0x%x", err);
-        return false;
-    }
-    egl_image_ = image;
+        // Pool changed (more distinct buffers than CEF keeps): drop least recently used
+        if (dmabuf_cache_.size() >= kDmabufCacheMax) {
+            auto lru = std::min_element(dmabuf_cache_.begin(), dmabuf_cache_.end(),
+                [](const DmabufCacheEntry& a, const DmabufCacheEntry& b) { return a.last_used < b.last_used; });
+            glDeleteTextures(1, &lru->texture);
+            eglDestroyImageKHR(display, static_cast<EGLImageKHR>(lru->egl_image));
+            close(lru->fd);
+            dmabuf_cache_.erase(lru);
+        }
 
-    // Bind to texture
-    glBindTexture(GL_TEXTURE_2D, dmabuf_texture_);
-    glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, image);
+        DmabufCacheEntry fresh;
+        fresh.key = key;
+        fresh.egl_image = image;
+        fresh.texture = texture;
+        fresh.fd = keep_fd;
+        dmabuf_cache_.push_back(fresh);
+        entry = &dmabuf_cache_.back();
+    }
 
-    GLenum glErr = glGetError();
-    if (glErr != GL_NO_ERROR) {
-        LOG_ERROR(LOG_COMPOSITOR, "glEGLImageTargetTexture2DOES failed: 0x%x", glErr);
-        eglDestroyImageKHR(display, image);
-        egl_image_ = nullptr;
-        return false;
+    entry->last_used = dmabuf_imports_;
+    dmabuf_texture_ = entry->texture;
+    dmabuf_current_fd_ = entry->fd;
+    dmabuf_current_ticket_ = ticket;
+    if (dmabuf_imports_ % 300 == 0) {
+        LOG_DEBUG(LOG_COMPOSITOR, "dmabuf import cache: %llu hits, %llu misses, %zu cached",
+                  static_cast<unsigned long long>(dmabuf_cache_hits_),
+                  static_cast<unsigned long long>(dmabuf_cache_misses_), dmabuf_cache_.size());
     }
 
     dmabuf_width_ = w;
@@ -570,11 +1170,14 @@ bool OpenGLCompositor::importQueuedDmabuf() {
     use_dmabuf_ = true;
     has_content_ = true;
     texture_valid_ = true;
+    content_opaque_ = false;  // Can't inspect GPU pixels
+    frame_damage_.setFull();  // CEF reports no damage for accelerated paints
 
     static bool first = true;
     if (first) {
-        LOG_INFO(LOG_COMPOSITOR, "dmabuf imported: %dx%d stride=%u modifier=0x%lx",
-                 w, h, stride, modifier);
+        LOG_INFO(LOG_COMPOSITOR, "dmabuf imported: %dx%d fourcc=0x%x planes=%d stride=%u offset=%lu modifier=0x%lx",
+                 w, h, frame.fourcc, frame.plane_count, frame.planes[0].stride, frame.planes[0].offset,
+                 frame.modifier);
         first = false;
     }
 
@@ -584,6 +1187,41 @@ bool OpenGLCompositor::importQueuedDmabuf() {
 #endif
 }
 
+uint64_t OpenGLCompositor::dmabufCacheHits() const {
+#if !defined(__APPLE__) && !defined(_WIN32)
+    return dmabuf_cache_hits_;
+#else
+    return 0;
+#endif
+}
+
+uint64_t OpenGLCompositor::dmabufCacheMisses() const {
+#if !defined(__APPLE__) && !defined(_WIN32)
+    return dmabuf_cache_misses_;
+#else
+    return 0;
+#endif
+}
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+void OpenGLCompositor::destroyDmabufCache() {
+    for (auto& e : dmabuf_cache_) {
+        if (e.texture) {
+            glDeleteTextures(1, &e.texture);
+        }
+        if (e.egl_image && ctx_ && eglDestroyImageKHR) {
+            eglDestroyImageKHR(ctx_->display(), static_cast<EGLImageKHR>(e.egl_image));
+        }
+        if (e.fd >= 0) {
+            close(e.fd);
+        }
+    }
+    dmabuf_cache_.clear();
+    dmabuf_texture_ = 0;
+    dmabuf_current_fd_ = -1;
+}
+#endif
+
 void OpenGLCompositor::composite(uint32_t width, uint32_t height, float alpha) {
     if (!has_content_ || !program_) {
         return;
@@ -604,53 +1242,187 @@ void OpenGLCompositor::composite(uint32_t width, uint32_t height, float alpha) {
     if (sampler_loc_ >= 0) glUniform1i(sampler_loc_, texture_unit_);
 
 #if !defined(__APPLE__) && !defined(_WIN32)
-    // Bind texture and get dimensions under lock to prevent race with updateOverlayPartial
-    GLuint tex_to_use = 0;
     int tex_w = 0, tex_h = 0;
-    bool use_cef = false;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (use_dmabuf_ && dmabuf_texture_) {
-            tex_to_use = dmabuf_texture_;
-            tex_w = dmabuf_width_;
-            tex_h = dmabuf_height_;
-            glBindTexture(GL_TEXTURE_2D, tex_to_use);
-            if (swizzle_loc_ >= 0) glUniform1f(swizzle_loc_, 0.0f);
-            if (log_count_++ < 3) LOG_INFO(LOG_COMPOSITOR, "composite: DMABUF tex=%u size=%dx%d view=%ux%u", tex_to_use, tex_w, tex_h, width, height);
-        } else if (cef_texture_) {
-            tex_to_use = cef_texture_;
-            tex_w = cef_texture_width_;
-            tex_h = cef_texture_height_;
-            use_cef = true;
-            glBindTexture(GL_TEXTURE_2D, tex_to_use);
-            if (swizzle_loc_ >= 0) glUniform1f(swizzle_loc_, 1.0f);
-        } else {
-            tex_to_use = texture_;
-            tex_w = width_;
-            tex_h = height_;
-            glBindTexture(GL_TEXTURE_2D, tex_to_use);
-            if (swizzle_loc_ >= 0) glUniform1f(swizzle_loc_, 1.0f);
-            if (log_count_++ < 3) LOG_INFO(LOG_COMPOSITOR, "composite: LEGACY tex=%u size=%dx%d view=%ux%u", tex_to_use, tex_w, tex_h, width, height);
-        }
-    }
+    bool swizzle = true;
+    bool used_dmabuf = bindContentTexture(width, height, tex_w, tex_h, swizzle);
+    if (swizzle_loc_ >= 0) glUniform1f(swizzle_loc_, swizzle ? 1.0f : 0.0f);
     if (tex_size_loc_ >= 0) glUniform2f(tex_size_loc_, static_cast<float>(tex_w), static_cast<float>(tex_h));
 #else
     // Windows/macOS: prefer cef_texture_ (from updateOverlayPartial) over legacy texture_
-    if (cef_texture_) {
-        glBindTexture(GL_TEXTURE_2D, cef_texture_);
+    // Pooled storage can be larger than the frame, so only the painted part is stretched
+    if (cef_texture_.id) {
+        glBindTexture(GL_TEXTURE_2D, cef_texture_.id);
         if (tex_size_loc_ >= 0) glUniform2f(tex_size_loc_, static_cast<float>(cef_texture_width_), static_cast<float>(cef_texture_height_));
+        if (tex_scale_loc_ >= 0) glUniform2f(tex_scale_loc_, static_cast<float>(cef_texture_width_) / cef_texture_.width,
+                                             static_cast<float>(cef_texture_height_) / cef_texture_.height);
         if (swizzle_loc_ >= 0) glUniform1f(swizzle_loc_, 1.0f);  // BGRA swizzle for CEF
     } else {
-        glBindTexture(GL_TEXTURE_2D, texture_);
+        glBindTexture(GL_TEXTURE_2D, texture_.id);
         if (tex_size_loc_ >= 0) glUniform2f(tex_size_loc_, static_cast<float>(width_), static_cast<float>(height_));
+        if (tex_scale_loc_ >= 0 && texture_.id) {
+            glUniform2f(tex_scale_loc_, static_cast<float>(width_) / texture_.width,
+                        static_cast<float>(height_) / texture_.height);
+        }
     }
 #endif
 
+    // Popup layer is blended in the same draw
+    if (popup_rect_loc_ >= 0) {
+        if (popup_texture_ && !popup_rect_.empty()) {
+            glActiveTexture(GL_TEXTURE0 + popup_texture_unit_);
+            glBindTexture(GL_TEXTURE_2D, popup_texture_);
+            if (popup_sampler_loc_ >= 0) glUniform1i(popup_sampler_loc_, popup_texture_unit_);
+            glUniform4f(popup_rect_loc_, static_cast<float>(popup_rect_.x), static_cast<float>(popup_rect_.y),
+                        static_cast<float>(popup_width_), static_cast<float>(popup_height_));
+        } else {
+            glUniform4f(popup_rect_loc_, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+    }
+
     glBindVertexArray(vao_);
     glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
 
     glDisable(GL_BLEND);
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // The draw above is the last read of the buffer CEF is holding for us
+    if (used_dmabuf && dmabuf_current_ticket_) {
+        fenceCompositedDmabuf();
+    }
+#endif
+}
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+bool OpenGLCompositor::bindContentTexture(uint32_t view_w, uint32_t view_h, int& tex_w, int& tex_h, bool& swizzle) {
+    // Bind under lock to prevent race with updateOverlayPartial
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (use_dmabuf_ && dmabuf_texture_) {
+        tex_w = dmabuf_width_;
+        tex_h = dmabuf_height_;
+        swizzle = false;
+        glBindTexture(GL_TEXTURE_2D, dmabuf_texture_);
+        if (log_count_++ < 3) LOG_INFO(LOG_COMPOSITOR, "composite: DMABUF tex=%u size=%dx%d view=%ux%u", dmabuf_texture_, tex_w, tex_h, view_w, view_h);
+        return true;
+    }
+    swizzle = true;
+    if (cef_texture_.id) {
+        tex_w = cef_texture_width_;
+        tex_h = cef_texture_height_;
+        glBindTexture(GL_TEXTURE_2D, cef_texture_.id);
+    } else {
+        tex_w = width_;
+        tex_h = height_;
+        glBindTexture(GL_TEXTURE_2D, texture_.id);
+        if (log_count_++ < 3) LOG_INFO(LOG_COMPOSITOR, "composite: LEGACY tex=%u size=%dx%d view=%ux%u", texture_.id, tex_w, tex_h, view_w, view_h);
+    }
+    return false;
+}
+#endif
+
+bool OpenGLCompositor::coversView(float alpha, uint32_t width, uint32_t height) const {
+    if (alpha < 1.0f || !content_opaque_ || !has_content_ || !texture_valid_) {
+        return false;
+    }
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // Drawn 1:1 from the top-left, so the texture must reach every window pixel
+    return cef_texture_.id && cef_texture_width_ >= static_cast<int>(width) &&
+           cef_texture_height_ >= static_cast<int>(height);
+#else
+    (void)width; (void)height;
+    return cef_texture_.id != 0;  // Stretched over the whole viewport
+#endif
+}
+
+void OpenGLCompositor::skipComposite() {
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // Nothing read the imported buffer this frame, so no fence is needed to hand it back
+    if (dmabuf_current_ticket_) {
+        releaseDmabuf(dmabuf_current_ticket_);
+        dmabuf_current_ticket_ = 0;
+    }
+#endif
+}
+
+int OpenGLCompositor::compositeLayers(const Layer* layers, int count, uint32_t width, uint32_t height) {
+    int draws = 0;
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // One attempt: if the driver rejects the batch shader, stay on per-layer draws
+    if (!s_batch.program && !s_batch.failed && !createBatchProgram()) {
+        s_batch.failed = true;
+    }
+    if (!s_batch.failed) {
+        glViewport(0, 0, width, height);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        glUseProgram(s_batch.program);
+        glUniform2f(s_batch.view_size_loc, static_cast<float>(width), static_cast<float>(height));
+
+        for (int base = 0; base < count; base += kMaxBatchLayers) {
+            int n = std::min(count - base, kMaxBatchLayers);
+            bool used_dmabuf[kMaxBatchLayers] = {};
+            for (int i = 0; i < n; i++) {
+                OpenGLCompositor* c = layers[base + i].compositor;
+                int tex_w = 0, tex_h = 0;
+                bool swizzle = true;
+                glActiveTexture(GL_TEXTURE0 + c->texture_unit_);
+                used_dmabuf[i] = c->bindContentTexture(width, height, tex_w, tex_h, swizzle);
+                glUniform1i(s_batch.tex_loc[i], c->texture_unit_);
+                glUniform1f(s_batch.alpha_loc[i], layers[base + i].alpha);
+                glUniform1f(s_batch.swizzle_loc[i], swizzle ? 1.0f : 0.0f);
+                glUniform2f(s_batch.tex_size_loc[i], static_cast<float>(tex_w), static_cast<float>(tex_h));
+                glUniform1i(s_batch.popup_tex_loc[i], c->popup_texture_unit_);
+                if (c->popup_texture_ && !c->popup_rect_.empty()) {
+                    glActiveTexture(GL_TEXTURE0 + c->popup_texture_unit_);
+                    glBindTexture(GL_TEXTURE_2D, c->popup_texture_);
+                    glUniform4f(s_batch.popup_rect_loc[i], static_cast<float>(c->popup_rect_.x),
+                                static_cast<float>(c->popup_rect_.y), static_cast<float>(c->popup_width_),
+                                static_cast<float>(c->popup_height_));
+                } else {
+                    glUniform4f(s_batch.popup_rect_loc[i], 0.0f, 0.0f, 0.0f, 0.0f);
+                }
+            }
+            glUniform1i(s_batch.count_loc, n);
+
+            glBindVertexArray(s_batch.vao);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            glBindVertexArray(0);
+            draws++;
+
+            // The draw above is the last read of any buffer CEF is holding for us
+            for (int i = 0; i < n; i++) {
+                OpenGLCompositor* c = layers[base + i].compositor;
+                if (used_dmabuf[i] && c->dmabuf_current_ticket_) {
+                    c->fenceCompositedDmabuf();
+                }
+            }
+        }
+        glDisable(GL_BLEND);
+        return draws;
+    }
+#endif
+    // One draw per layer
+    for (int i = 0; i < count; i++) {
+        layers[i].compositor->composite(width, height, layers[i].alpha);
+        draws++;
+    }
+    return draws;
+}
+
+void OpenGLCompositor::collectDamage(float alpha, DamageRegion& out) {
+    // Opacity changes (fades) touch every pixel the layer covers
+    if (alpha != damage_alpha_) {
+        frame_damage_.setFull();
+        damage_alpha_ = alpha;
+    }
+#if defined(__APPLE__) || defined(_WIN32)
+    // The texture is stretched to the viewport here, so texel damage isn't window damage
+    if (!frame_damage_.empty()) {
+        frame_damage_.setFull();
+    }
+#endif
+    out.merge(frame_damage_);
+    frame_damage_.clear();
 }
 
 void OpenGLCompositor::resize(uint32_t width, uint32_t height) {
@@ -661,13 +1433,25 @@ void OpenGLCompositor::resize(uint32_t width, uint32_t height) {
         return;
     }
 
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // destroyTexture() below drops the dmabuf on screen; hand CEF its buffer
+    // back now rather than after the release timeout. Before taking mutex_,
+    // which releaseDmabuf() locks.
+    if (dmabuf_current_ticket_) {
+        releaseDmabuf(dmabuf_current_ticket_);
+        dmabuf_current_ticket_ = 0;
+    }
+#endif
+
     std::lock_guard<std::mutex> lock(mutex_);
 
     // Just update viewport dimensions - CEF texture is independent
     width_ = width;
     height_ = height;
+    frame_damage_.setFull();
 
-    // Recreate legacy texture/PBOs at new size (needed for flushOverlay compatibility)
+    // Swap legacy texture/PBOs for ones covering the new size (needed for flushOverlay
+    // compatibility); within the current bucket the pool hands back the same storage
     destroyTexture();
     if (!createTexture()) {
         LOG_ERROR(LOG_COMPOSITOR, "createTexture failed during resize");
@@ -675,33 +1459,23 @@ void OpenGLCompositor::resize(uint32_t width, uint32_t height) {
 }
 
 void OpenGLCompositor::destroyTexture() {
-    // Unmap and delete PBOs
+    // Unmap and release PBOs
     if (pbo_mapped_) {
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_]);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[current_pbo_].id);
         glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
         pbo_mapped_ = nullptr;
     }
-    if (pbos_[0]) {
-        glDeleteBuffers(2, pbos_);
-        pbos_[0] = pbos_[1] = 0;
+    // Back to the pool (resize re-acquires them right away)
+    for (auto& pbo : pbos_) {
+        s_surface_pool.release(pbo);
     }
     current_pbo_ = 0;
-
-    if (texture_) {
-        glDeleteTextures(1, &texture_);
-        texture_ = 0;
-    }
+    s_surface_pool.release(texture_);
 
 #if !defined(__APPLE__) && !defined(_WIN32)
     // Clean up dmabuf resources
-    if (egl_image_ && ctx_ && eglDestroyImageKHR) {
-        eglDestroyImageKHR(ctx_->display(), static_cast<EGLImageKHR>(egl_image_));
-        egl_image_ = nullptr;
-    }
-    if (dmabuf_texture_) {
-        glDeleteTextures(1, &dmabuf_texture_);
-        dmabuf_texture_ = 0;
-    }
+    destroyDmabufCache();
     use_dmabuf_ = false;
     dmabuf_width_ = 0;
     dmabuf_height_ = 0;
@@ -711,24 +1485,49 @@ void OpenGLCompositor::destroyTexture() {
 void OpenGLCompositor::cleanup() {
     if (!ctx_) return;
 
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // Never leave the CEF thread waiting on a buffer we will not composite
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeDmabufFrame(queued_dmabuf_);
+        dmabuf_pending_.store(false, std::memory_order_relaxed);
+        dmabuf_released_ticket_ = dmabuf_next_ticket_;
+        dmabuf_release_cv_.notify_all();
+    }
+    dmabuf_current_ticket_ = 0;
+#endif
+
     destroyTexture();
+    destroyUploadRing();
 
     // Clean up CEF texture
-    if (cef_texture_) {
-        glDeleteTextures(1, &cef_texture_);
-        cef_texture_ = 0;
-        cef_texture_width_ = 0;
-        cef_texture_height_ = 0;
+    s_surface_pool.release(cef_texture_);
+    cef_texture_width_ = 0;
+    cef_texture_height_ = 0;
+    if (popup_texture_) {
+        glDeleteTextures(1, &popup_texture_);
+        popup_texture_ = 0;
+        popup_width_ = 0;
+        popup_height_ = 0;
     }
 
     if (program_) {
         glDeleteProgram(program_);
         program_ = 0;
+#if !defined(__APPLE__) && !defined(_WIN32)
+        // Last compositor out releases the shared batch program
+        if (--s_batch.users == 0) {
+            destroyBatchProgram();
+        }
+#endif
     }
     if (vao_) {
         glDeleteVertexArrays(1, &vao_);
         vao_ = 0;
     }
 
+    if (--s_live_compositors == 0) {
+        s_surface_pool.clear();
+    }
     ctx_ = nullptr;
 }
@@ -15,15 +15,34 @@ typedef EGLContext_ GLContext;
 #endif
 
 #include <mutex>
+#include <condition_variable>
 #include <cstdint>
 #include <atomic>
 #include <vector>
+#include "compositor/damage_rect.h"
+#include "compositor/dmabuf_frame.h"
+#include "compositor/gl_surface_pool.h"
 
 class OpenGLCompositor {
 public:
+    // How CEF software frames reach the GPU
+    enum class UploadMode {
+        Sync,  // glTexSubImage2D from client memory followed by glFinish (default)
+        Ring,  // Fence-guarded PBO ring, never waits on the GPU. Opt-in until
+               // measured on real drivers; slower than Sync on llvmpipe.
+    };
+
     OpenGLCompositor();
     ~OpenGLCompositor();
 
+    // Select upload path for all compositors (call before init)
+    static void setUploadMode(UploadMode mode);
+    static UploadMode uploadMode();
+
+    // Free pooled textures/buffers idle since a resize settled (GL thread).
+    // Returns ms until the next pooled object expires, or -1 if none are pooled.
+    static int trimSurfacePool();
+
     bool init(GLContext* ctx, uint32_t width, uint32_t height);
     void cleanup();
 
@@ -35,8 +54,16 @@ public:
     void markStagingDirty() { staging_pending_ = true; has_content_ = true; }
     bool hasPendingContent() const { return staging_pending_; }
 
-    // Update with partial/mismatched size data (copies overlapping region)
-    void updateOverlayPartial(const void* data, int src_width, int src_height);
+    // Upload CEF frame, limited to damaged rects (nullptr/full = whole frame)
+    // Returns number of bytes uploaded
+    size_t updateOverlayPartial(const void* data, int src_width, int src_height,
+                                const DamageRegion* damage = nullptr);
+
+    // Popup (PET_POPUP) layer, blended over the view in the composite pass
+    // rect: position in CEF texture pixels (empty = hidden)
+    void setPopupRect(const DamageRect& rect);
+    // Upload popup pixels (BGRA); returns number of bytes uploaded
+    size_t updatePopup(const void* data, int width, int height);
 
     // Get current compositor dimensions
     uint32_t width() const { return width_; }
@@ -48,12 +75,49 @@ public:
     // Composite overlay to screen with alpha blending
     void composite(uint32_t width, uint32_t height, float alpha);
 
+    // One browser layer for compositeLayers
+    struct Layer {
+        OpenGLCompositor* compositor = nullptr;
+        float alpha = 1.0f;
+    };
+    static constexpr int kMaxBatchLayers = 4;  // Layers blended per draw
+
+    // Composite layers back-to-front in as few draws as possible (one per
+    // kMaxBatchLayers on Linux, one per layer elsewhere). Returns draw count.
+    static int compositeLayers(const Layer* layers, int count, uint32_t width, uint32_t height);
+
+    // Software content is opaque (set per uploaded frame; dmabuf frames are assumed not)
+    void setOpaque(bool opaque) { content_opaque_ = opaque; }
+
+    // Layer at this alpha hides everything beneath it in a width x height view
+    bool coversView(float alpha, uint32_t width, uint32_t height) const;
+
+    // Layer culled this frame: hand back buffers held for its composite
+    void skipComposite();
+
+    // Merge window damage since the last call into out (window pixels, top-left
+    // origin) and reset it. alpha is the value the next composite will use.
+    void collectDamage(float alpha, DamageRegion& out);
+
     // Queue dmabuf for import (thread-safe, called from CEF callback)
-    void queueDmabuf(int fd, uint32_t stride, uint64_t modifier, int width, int height);
+    // Takes ownership of the plane fds; returns a ticket for waitDmabufReleased
+    uint64_t queueDmabuf(const DmabufFrame& frame);
+
+    // Block the CEF thread until the composite no longer needs the buffer
+    // (its reads are fenced into the dmabuf), so CEF can't reuse it underneath us.
+    // Returns false on timeout.
+    bool waitDmabufReleased(uint64_t ticket, int timeout_ms);
 
     // Import queued dmabuf (must be called from main/GL thread)
     bool importQueuedDmabuf();
 
+    // EGL can import dmabufs and synchronize them with native fences (after init)
+    bool dmabufImportSupported() const;
+
+    // EGLImage import cache counters (Linux dmabuf path)
+    uint64_t dmabufCacheHits() const;
+    uint64_t dmabufCacheMisses() const;
+
     // Resize resources
     void resize(uint32_t width, uint32_t height);
 
@@ -67,25 +131,64 @@ private:
     bool createTexture();
     bool createShader();
     void destroyTexture();
+    bool uploadThroughRing(const uint8_t* data, int src_width, int src_height,
+                           const DamageRegion* damage, bool full_upload, size_t& uploaded);
+    void destroyUploadRing();
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // Bind the texture to composite on the active unit; true if it is a dmabuf import
+    bool bindContentTexture(uint32_t view_w, uint32_t view_h, int& tex_w, int& tex_h, bool& swizzle);
+    void destroyDmabufCache();
+    void releaseDmabuf(uint64_t ticket);
+    void fenceCompositedDmabuf();
+#endif
 
     GLContext* ctx_ = nullptr;
     uint32_t width_ = 0;
     uint32_t height_ = 0;
 
-    // CEF texture - stores raw CEF frame at CEF's painted size (independent of viewport)
-    GLuint cef_texture_ = 0;
+    // CEF texture - stores raw CEF frame at CEF's painted size (independent of viewport).
+    // Storage comes from the surface pool and may be larger than the painted size.
+    GLSurfacePool::Texture cef_texture_;
     int cef_texture_width_ = 0;
     int cef_texture_height_ = 0;
     bool has_content_ = false;
     bool texture_valid_ = false;  // Set false on RECREATE, true when we get non-black frame
+    bool content_opaque_ = false;  // Every texel has alpha 1 (see setOpaque)
 
     // Legacy texture/PBO for compatibility (will be removed)
-    GLuint texture_ = 0;
-    GLuint pbos_[2] = {0, 0};
+    GLSurfacePool::Texture texture_;
+    GLSurfacePool::Buffer pbos_[2];
     int current_pbo_ = 0;
     void* pbo_mapped_ = nullptr;
     bool staging_pending_ = false;
 
+    // Streaming upload ring: each slot's fence marks when the GPU has
+    // finished reading it, so a busy slot is skipped rather than waited on
+    static constexpr int kUploadRingSize = 3;
+    struct UploadSlot {
+        GLuint pbo = 0;
+        size_t size = 0;
+        GLsync fence = nullptr;
+    };
+    UploadSlot upload_ring_[kUploadRingSize];
+    int upload_slot_ = 0;
+
+    // Popup layer texture (sized to the popup, not the view)
+    GLuint popup_texture_ = 0;
+    int popup_width_ = 0;
+    int popup_height_ = 0;
+    DamageRect popup_rect_;
+
+    // Window area changed since the last collectDamage (GL thread)
+    DamageRegion frame_damage_;
+    float damage_alpha_ = -1.0f;  // Alpha of the last collected frame (-1 = none yet)
+
+    // Upload timing (CPU time spent in updateOverlayPartial)
+    uint64_t upload_count_ = 0;
+    uint64_t upload_time_us_ = 0;
+    uint64_t upload_max_us_ = 0;
+    uint64_t upload_orphans_ = 0;  // All slots busy, storage orphaned instead of waiting
+
     // Thread safety
     std::mutex mutex_;
 
@@ -95,32 +198,72 @@ private:
     GLint swizzle_loc_ = -1;
     GLint tex_size_loc_ = -1;
     GLint view_size_loc_ = -1;
+    GLint tex_scale_loc_ = -1;
     GLint sampler_loc_ = -1;
+    GLint popup_sampler_loc_ = -1;
+    GLint popup_rect_loc_ = -1;
 
     // VAO for fullscreen quad
     GLuint vao_ = 0;
 
     // Unique texture unit for this compositor (prevents interference between compositors)
     int texture_unit_ = 0;
+    int popup_texture_unit_ = 0;
     int log_count_ = 0;  // Per-instance log counter
 
 #if !defined(__APPLE__) && !defined(_WIN32)
     // Dmabuf import (Linux only)
-    GLuint dmabuf_texture_ = 0;
-    void* egl_image_ = nullptr;  // EGLImage
+    GLuint dmabuf_texture_ = 0;  // Texture of the current cache entry (not owned)
     bool use_dmabuf_ = false;
     int dmabuf_width_ = 0;
     int dmabuf_height_ = 0;
 
-    // Queued dmabuf for import on main thread
-    struct QueuedDmabuf {
-        int fd = -1;
-        uint32_t stride = 0;
+    // CEF recycles a small pool of GPU buffers, so imports are cached per
+    // underlying buffer (dmabuf dev/inode) instead of recreated every paint
+    struct DmabufKey {
+        uint64_t dev = 0;
+        uint64_t ino = 0;
+        uint32_t fourcc = 0;
         uint64_t modifier = 0;
-        int width = 0;
-        int height = 0;
+        int plane_count = 0;
+        uint32_t strides[DmabufFrame::kMaxPlanes] = {};
+        uint64_t offsets[DmabufFrame::kMaxPlanes] = {};
+
+        bool operator==(const DmabufKey& o) const {
+            if (dev != o.dev || ino != o.ino || fourcc != o.fourcc ||
+                modifier != o.modifier || plane_count != o.plane_count) {
+                return false;
+            }
+            for (int i = 0; i < plane_count; i++) {
+                if (strides[i] != o.strides[i] || offsets[i] != o.offsets[i]) return false;
+            }
+            return true;
+        }
+    };
+    struct DmabufCacheEntry {
+        DmabufKey key;
+        void* egl_image = nullptr;  // EGLImage
+        GLuint texture = 0;
+        int fd = -1;                // Plane 0, kept to fence our reads into the buffer
+        uint64_t last_used = 0;
     };
-    QueuedDmabuf queued_dmabuf_;
+    static constexpr size_t kDmabufCacheMax = 8;  // Evict LRU beyond this (pool changed)
+    std::vector<DmabufCacheEntry> dmabuf_cache_;
+    uint64_t dmabuf_imports_ = 0;
+    uint64_t dmabuf_cache_hits_ = 0;
+    uint64_t dmabuf_cache_misses_ = 0;
+
+    // Queued dmabuf for import on main thread
+    DmabufFrame queued_dmabuf_;
+    uint64_t queued_ticket_ = 0;               // guarded by mutex_
     std::atomic<bool> dmabuf_pending_{false};  // Fast-path check without mutex
+
+    // Buffer hold: CEF waits until the frame it sent has been released.
+    // Tickets are issued and released in order, so one counter covers all.
+    std::condition_variable dmabuf_release_cv_;
+    uint64_t dmabuf_next_ticket_ = 0;      // guarded by mutex_
+    uint64_t dmabuf_released_ticket_ = 0;  // guarded by mutex_
+    uint64_t dmabuf_current_ticket_ = 0;   // Imported, waiting for composite (GL thread)
+    int dmabuf_current_fd_ = -1;           // Cache entry fd of the current frame (not owned)
 #endif
 };
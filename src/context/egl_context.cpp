@@ -7,6 +7,16 @@
 #include <X11/Xlib.h>
 #endif
 
+bool hasEglExtension(EGLDisplay display, const char* name) {
+    const char* exts = eglQueryString(display, EGL_EXTENSIONS);
+    if (!exts) return false;
+    size_t len = strlen(name);
+    for (const char* p = strstr(exts, name); p; p = strstr(p + len, name)) {
+        if ((p == exts || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0')) return true;
+    }
+    return false;
+}
+
 EGLContext_::EGLContext_() = default;
 
 EGLContext_::~EGLContext_() {
@@ -185,6 +195,23 @@ bool EGLContext_::init(SDL_Window* window) {
     // Enable vsync
     eglSwapInterval(display_, 1);
 
+    // Partial redraw support
+    if (hasEglExtension(display_, "EGL_KHR_partial_update")) {
+        set_damage_region_ = reinterpret_cast<PFNEGLSETDAMAGEREGIONKHRPROC>(
+            eglGetProcAddress("eglSetDamageRegionKHR"));
+    }
+    buffer_age_ = hasEglExtension(display_, "EGL_EXT_buffer_age") || set_damage_region_;
+    if (hasEglExtension(display_, "EGL_KHR_swap_buffers_with_damage")) {
+        swap_with_damage_ = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+    } else if (hasEglExtension(display_, "EGL_EXT_swap_buffers_with_damage")) {
+        swap_with_damage_ = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+    }
+    LOG_INFO(LOG_GL, "[EGL] Damage tracking: buffer_age=%s swap_with_damage=%s partial_update=%s",
+             buffer_age_ ? "yes" : "no", swap_with_damage_ ? "yes" : "no",
+             set_damage_region_ ? "yes" : "no");
+
     LOG_INFO(LOG_GL, "[EGL] Context created successfully");
     LOG_INFO(LOG_GL, "[EGL] GL_VERSION: %s", glGetString(GL_VERSION));
     LOG_INFO(LOG_GL, "[EGL] GL_RENDERER: %s", glGetString(GL_RENDERER));
@@ -216,6 +243,30 @@ void EGLContext_::swapBuffers() {
     eglSwapBuffers(display_, surface_);
 }
 
+int EGLContext_::bufferAge() const {
+    if (!buffer_age_) return 0;
+    EGLint age = 0;
+    if (!eglQuerySurface(display_, surface_, EGL_BUFFER_AGE_EXT, &age)) {
+        return 0;
+    }
+    return age;
+}
+
+void EGLContext_::setDamageRegion(const EGLint* rects, int count) {
+    if (set_damage_region_) {
+        set_damage_region_(display_, surface_, const_cast<EGLint*>(rects), count);
+    }
+}
+
+void EGLContext_::swapBuffersWithDamage(const EGLint* rects, int count) {
+    // Zero rects means "whole surface" to EGL, same as a plain swap
+    if (swap_with_damage_ && count > 0) {
+        swap_with_damage_(display_, surface_, rects, count);
+    } else {
+        eglSwapBuffers(display_, surface_);
+    }
+}
+
 bool EGLContext_::resize(int width, int height) {
     if (width == width_ && height == height_) {
         return true;
@@ -225,7 +276,7 @@ bool EGLContext_::resize(int width, int height) {
     if (is_wayland_ && egl_window_) {
         wl_egl_window_resize(egl_window_, width, height, 0, 0);
     }
-    // X11 window resize is handled by SDL/X11VideoLayer
+    // X11 window resize is handled by SDL
     return true;
 }
 
@@ -11,6 +11,9 @@
 #define GL_BGRA_EXT 0x80E1
 #endif
 
+// Whole-word match in the display's EGL_EXTENSIONS string
+bool hasEglExtension(EGLDisplay display, const char* name);
+
 class EGLContext_ {
 public:
     EGLContext_();
@@ -21,6 +24,12 @@ public:
     void swapBuffers();
     bool resize(int width, int height);
 
+    // Damage-tracked presentation (rects are x, y, w, h in surface pixels, bottom-left origin)
+    bool hasBufferAge() const { return buffer_age_; }
+    int bufferAge() const;  // Frames since the back buffer was presented (0 = undefined)
+    void setDamageRegion(const EGLint* rects, int count);  // EGL_KHR_partial_update (call before drawing)
+    void swapBuffersWithDamage(const EGLint* rects, int count);
+
     // Create a shared context for use on another thread
     EGLContext createSharedContext() const;
     void destroyContext(EGLContext ctx) const;
@@ -45,4 +54,8 @@ private:
     int width_ = 0;
     int height_ = 0;
     bool is_wayland_ = false;
+
+    bool buffer_age_ = false;  // EGL_EXT_buffer_age or EGL_KHR_partial_update
+    PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_with_damage_ = nullptr;  // KHR or EXT
+    PFNEGLSETDAMAGEREGIONKHRPROC set_damage_region_ = nullptr;
 };
@@ -28,12 +28,23 @@ PFNGLLINKPROGRAMPROC glLinkProgram = nullptr;
 PFNGLUSEPROGRAMPROC glUseProgram = nullptr;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = nullptr;
 PFNGLUNIFORM1IPROC glUniform1i = nullptr;
+PFNGLUNIFORM2FPROC glUniform2f = nullptr;
 
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = nullptr;
 PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = nullptr;
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray = nullptr;
 
+PFNGLGENBUFFERSPROC glGenBuffers = nullptr;
+PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
+PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
+PFNGLBUFFERDATAPROC glBufferData = nullptr;
+
 PFNGLACTIVETEXTUREPROC glActiveTexture = nullptr;
+PFNGLTEXSTORAGE2DPROC glTexStorage2D = nullptr;
+
+PFNGLFENCESYNCPROC glFenceSync = nullptr;
+PFNGLWAITSYNCPROC glWaitSync = nullptr;
+PFNGLDELETESYNCPROC glDeleteSync = nullptr;
 
 static void* getProc(const char* name) {
     void* proc = reinterpret_cast<void*>(wglGetProcAddress(name));
@@ -77,13 +88,27 @@ bool initGLLoader() {
     LOAD_GL(glUseProgram);
     LOAD_GL(glGetUniformLocation);
     LOAD_GL(glUniform1i);
+    LOAD_GL(glUniform2f);
 
     LOAD_GL(glGenVertexArrays);
     LOAD_GL(glDeleteVertexArrays);
     LOAD_GL(glBindVertexArray);
 
+    LOAD_GL(glGenBuffers);
+    LOAD_GL(glDeleteBuffers);
+    LOAD_GL(glBindBuffer);
+    LOAD_GL(glBufferData);
+
     LOAD_GL(glActiveTexture);
 
+    // Without it GLSurfacePool falls back to mutable glTexImage2D storage
+    glTexStorage2D = reinterpret_cast<decltype(glTexStorage2D)>(getProc("glTexStorage2D"));
+
+    // Without these OpenGLRenderer hands frames over with glFinish
+    glFenceSync = reinterpret_cast<decltype(glFenceSync)>(getProc("glFenceSync"));
+    glWaitSync = reinterpret_cast<decltype(glWaitSync)>(getProc("glWaitSync"));
+    glDeleteSync = reinterpret_cast<decltype(glDeleteSync)>(getProc("glDeleteSync"));
+
     initialized = true;
     LOG_INFO(LOG_GL, "[GL] Loaded extension functions");
     return true;
@@ -5,7 +5,7 @@
 #include <GL/gl.h>
 #include "GL/glext.h"
 
-// Minimal GL function loader for Windows - loads only what OpenGLRenderer needs
+// Minimal GL function loader for Windows - loads only what OpenGLRenderer and GLSurfacePool need
 namespace gl {
 
 // Framebuffer
@@ -34,14 +34,27 @@ extern PFNGLLINKPROGRAMPROC glLinkProgram;
 extern PFNGLUSEPROGRAMPROC glUseProgram;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 extern PFNGLUNIFORM1IPROC glUniform1i;
+extern PFNGLUNIFORM2FPROC glUniform2f;
 
 // VAO
 extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 
+// Buffers
+extern PFNGLGENBUFFERSPROC glGenBuffers;
+extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+extern PFNGLBINDBUFFERPROC glBindBuffer;
+extern PFNGLBUFFERDATAPROC glBufferData;
+
 // Texture
 extern PFNGLACTIVETEXTUREPROC glActiveTexture;
+extern PFNGLTEXSTORAGE2DPROC glTexStorage2D;  // Optional (GL 4.2 / ARB_texture_storage), may be null
+
+// Sync objects (optional, GL 3.2 / ARB_sync) - may be null
+extern PFNGLFENCESYNCPROC glFenceSync;
+extern PFNGLWAITSYNCPROC glWaitSync;
+extern PFNGLDELETESYNCPROC glDeleteSync;
 
 // Initialize GL function pointers (call after context is made current)
 bool initGLLoader();
@@ -70,9 +83,18 @@ using gl::glLinkProgram;
 using gl::glUseProgram;
 using gl::glGetUniformLocation;
 using gl::glUniform1i;
+using gl::glUniform2f;
 using gl::glGenVertexArrays;
 using gl::glDeleteVertexArrays;
 using gl::glBindVertexArray;
+using gl::glGenBuffers;
+using gl::glDeleteBuffers;
+using gl::glBindBuffer;
+using gl::glBufferData;
 using gl::glActiveTexture;
+using gl::glTexStorage2D;
+using gl::glFenceSync;
+using gl::glWaitSync;
+using gl::glDeleteSync;
 
 #endif  // _WIN32
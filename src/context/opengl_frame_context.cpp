@@ -9,6 +9,7 @@
 
 OpenGLFrameContext::OpenGLFrameContext(GLContext* gl) : gl_(gl) {}
 
+#ifdef _WIN32
 void OpenGLFrameContext::beginFrame(float bg_color, float alpha) {
     glClearColor(bg_color, bg_color, bg_color, alpha);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -17,3 +18,83 @@ void OpenGLFrameContext::beginFrame(float bg_color, float alpha) {
 void OpenGLFrameContext::endFrame() {
     gl_->swapBuffers();
 }
+#else
+void OpenGLFrameContext::setDamage(const DamageRegion& damage, int width, int height) {
+    damage_.clear();
+    damage_.merge(damage);
+    if (width != width_ || height != height_) {
+        damage_.setFull();
+        width_ = width;
+        height_ = height;
+    }
+    damage_set_ = true;
+}
+
+bool OpenGLFrameContext::needsFrame(float bg_color, float alpha) const {
+    return !damage_set_ || !damage_.empty() || bg_color != last_bg_ || alpha != last_alpha_;
+}
+
+void OpenGLFrameContext::beginFrame(float bg_color, float alpha) {
+    if (bg_color != last_bg_ || alpha != last_alpha_) {
+        damage_.setFull();
+        last_bg_ = bg_color;
+        last_alpha_ = alpha;
+    }
+
+    // The back buffer is age frames old: redraw this frame's damage plus
+    // everything presented since, or all of it when that's unknown
+    partial_ = false;
+    DamageRect repaint;
+    if (damage_set_ && !damage_.full() && gl_->hasBufferAge()) {
+        int age = gl_->bufferAge();
+        if (age > 0 && age - 1 <= history_count_) {
+            repaint = damage_.bounds(width_, height_);
+            for (int i = 0; i < age - 1; i++) {
+                repaint = unionDamageRect(repaint, history_[i]);
+            }
+            repaint = clipDamageRect(repaint, width_, height_);
+            partial_ = repaint.area() < static_cast<int64_t>(width_) * height_;
+        }
+    }
+
+    glClearColor(bg_color, bg_color, bg_color, alpha);
+    if (partial_) {
+        EGLint rect[4] = {repaint.x, height_ - repaint.y - repaint.height, repaint.width, repaint.height};
+        gl_->setDamageRegion(rect, 1);
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(rect[0], rect[1], rect[2], rect[3]);
+    }
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void OpenGLFrameContext::endFrame() {
+    if (!partial_) {
+        gl_->swapBuffers();
+        history_count_ = 0;  // Older frames are fully covered by this one
+        damage_set_ = false;
+        return;
+    }
+    glDisable(GL_SCISSOR_TEST);
+
+    // Only this frame's damage is new to the system compositor
+    EGLint rects[DamageRegion::kMaxRects * 4];
+    int count = 0;
+    for (const auto& r : damage_.rects()) {
+        DamageRect c = clipDamageRect(r, width_, height_);
+        if (c.empty()) continue;
+        rects[count * 4 + 0] = c.x;
+        rects[count * 4 + 1] = height_ - c.y - c.height;
+        rects[count * 4 + 2] = c.width;
+        rects[count * 4 + 3] = c.height;
+        count++;
+    }
+    gl_->swapBuffersWithDamage(rects, count);
+
+    for (int i = kDamageHistory - 1; i > 0; i--) {
+        history_[i] = history_[i - 1];
+    }
+    history_[0] = damage_.bounds(width_, height_);
+    history_count_ = std::min(history_count_ + 1, kDamageHistory);
+    damage_set_ = false;
+}
+#endif
@@ -5,6 +5,7 @@
 class WGLContext;
 using GLContext = WGLContext;
 #else
+#include "compositor/damage_rect.h"
 class EGLContext_;
 using GLContext = EGLContext_;
 #endif
@@ -14,6 +15,30 @@ public:
     explicit OpenGLFrameContext(GLContext* gl);
     void beginFrame(float bg_color, float alpha) override;
     void endFrame() override;
+
+#ifndef _WIN32
+    // Limit the next frame to damage (window pixels, top-left origin) on a
+    // width x height surface. Frames without a call are redrawn in full.
+    void setDamage(const DamageRegion& damage, int width, int height);
+    // False when the next frame would present the same pixels as the last one
+    bool needsFrame(float bg_color, float alpha) const;
+#endif
+
 private:
     GLContext* gl_;
+#ifndef _WIN32
+    // Damage of frames presented since the last full redraw ([0] = newest),
+    // used to repair back buffers that are more than one frame old
+    static constexpr int kDamageHistory = 4;
+    DamageRect history_[kDamageHistory];
+    int history_count_ = 0;
+
+    DamageRegion damage_;
+    bool damage_set_ = false;
+    bool partial_ = false;  // Current frame is scissored to the repaint rect
+    int width_ = 0;
+    int height_ = 0;
+    float last_bg_ = -1.0f;
+    float last_alpha_ = -1.0f;
+#endif
 };
@@ -6,7 +6,13 @@
 // Window state listener for mpv - pauses on minimize, resumes on restore
 class MpvLayer : public WindowStateListener {
 public:
-    explicit MpvLayer(MpvPlayer* mpv) : mpv_(mpv) {}
+    explicit MpvLayer(MpvPlayer* mpv = nullptr) : mpv_(mpv) {}
+
+    // Player comes and goes with the video stack (null = none)
+    void setPlayer(MpvPlayer* mpv) {
+        mpv_ = mpv;
+        was_playing_ = false;
+    }
 
     void onMinimized() override {
         if (!mpv_) return;
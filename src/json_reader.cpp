@@ -0,0 +1,292 @@
+#include "json_reader.h"
+#include <cstdlib>
+#include <cstring>
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool parseHex4(std::string_view s, size_t pos, uint32_t& out) {
+    if (pos + 4 > s.size()) return false;
+    out = 0;
+    for (size_t i = 0; i < 4; i++) {
+        int d = hexDigit(s[pos + i]);
+        if (d < 0) return false;
+        out = (out << 4) | static_cast<uint32_t>(d);
+    }
+    return true;
+}
+
+static void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+std::string JsonValue::str() const {
+    if (type != Type::String) return {};
+    if (raw.find('\\') == std::string_view::npos) return std::string(raw);
+
+    std::string out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); i++) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+        char e = raw[++i];
+        switch (e) {
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            uint32_t cp;
+            if (!parseHex4(raw, i + 1, cp)) break;
+            i += 4;
+            // Surrogate pair
+            uint32_t low;
+            if (cp >= 0xD800 && cp <= 0xDBFF && i + 2 < raw.size() && raw[i + 1] == '\\' &&
+                raw[i + 2] == 'u' && parseHex4(raw, i + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i += 6;
+            }
+            appendUtf8(out, cp);
+            break;
+        }
+        default: out += e; break;  // \" \\ \/
+        }
+    }
+    return out;
+}
+
+int64_t JsonValue::toInt(int64_t fallback) const {
+    if (type != Type::Number) return fallback;
+    size_t i = 0;
+    bool negative = false;
+    if (i < raw.size() && raw[i] == '-') {
+        negative = true;
+        i++;
+    }
+    if (i >= raw.size() || raw[i] < '0' || raw[i] > '9') return fallback;
+    int64_t val = 0;
+    for (; i < raw.size() && raw[i] >= '0' && raw[i] <= '9'; i++) {
+        val = val * 10 + (raw[i] - '0');
+    }
+    if (i < raw.size()) {
+        // Fractional or exponent form
+        return static_cast<int64_t>(toDouble(static_cast<double>(fallback)));
+    }
+    return negative ? -val : val;
+}
+
+double JsonValue::toDouble(double fallback) const {
+    if (type != Type::Number) return fallback;
+    char buf[64];
+    if (raw.size() >= sizeof(buf)) return fallback;
+    std::memcpy(buf, raw.data(), raw.size());
+    buf[raw.size()] = '\0';
+    char* end = nullptr;
+    double val = std::strtod(buf, &end);
+    return end == buf ? fallback : val;
+}
+
+bool JsonValue::toBool(bool fallback) const {
+    if (type != Type::Bool) return fallback;
+    return raw == "true";
+}
+
+void JsonReader::skipWhitespace() {
+    while (pos_ < json_.size()) {
+        char c = json_[pos_];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        pos_++;
+    }
+}
+
+bool JsonReader::fail() {
+    failed_ = true;
+    done_ = true;
+    return false;
+}
+
+bool JsonReader::begin(char open, char close) {
+    if (done_) return false;
+    skipWhitespace();
+    if (!started_) {
+        if (pos_ >= json_.size() || json_[pos_] != open) return fail();
+        pos_++;
+        started_ = true;
+        close_ = close;
+        skipWhitespace();
+        if (pos_ < json_.size() && json_[pos_] == close) {
+            done_ = true;
+            return false;
+        }
+        return true;
+    }
+    if (close_ != close || pos_ >= json_.size()) return fail();
+    if (json_[pos_] == close) {
+        done_ = true;
+        return false;
+    }
+    if (json_[pos_] != ',') return fail();
+    pos_++;
+    skipWhitespace();
+    return true;
+}
+
+bool JsonReader::readString(std::string_view& out) {
+    // At the opening quote
+    size_t start = ++pos_;
+    const char* base = json_.data();
+    while (pos_ < json_.size()) {
+        const void* quote = std::memchr(base + pos_, '"', json_.size() - pos_);
+        if (!quote) break;
+        size_t end = static_cast<const char*>(quote) - base;
+        // Escaped if preceded by an odd number of backslashes
+        size_t slashes = 0;
+        while (end - slashes > start && base[end - slashes - 1] == '\\') slashes++;
+        pos_ = end + 1;
+        if (!(slashes & 1)) {
+            out = json_.substr(start, end - start);
+            return true;
+        }
+    }
+    return fail();
+}
+
+// Characters skipContainer() has to look at
+static const struct StructuralTable {
+    bool is[256] = {};
+    constexpr StructuralTable() {
+        is[static_cast<unsigned char>('"')] = true;
+        is[static_cast<unsigned char>('{')] = true;
+        is[static_cast<unsigned char>('}')] = true;
+        is[static_cast<unsigned char>('[')] = true;
+        is[static_cast<unsigned char>(']')] = true;
+    }
+} kStructural;
+
+bool JsonReader::skipContainer() {
+    // At the opening bracket; brackets inside strings don't count
+    int depth = 0;
+    const char* base = json_.data();
+    while (pos_ < json_.size()) {
+        char c = base[pos_];
+        if (!kStructural.is[static_cast<unsigned char>(c)]) {
+            pos_++;
+            continue;
+        }
+        if (c == '"') {
+            std::string_view ignored;
+            if (!readString(ignored)) return false;
+            continue;
+        }
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (--depth == 0) {
+            pos_++;
+            return true;
+        }
+        pos_++;
+    }
+    return fail();
+}
+
+bool JsonReader::readValue(JsonValue& value) {
+    skipWhitespace();
+    if (pos_ >= json_.size()) return fail();
+    size_t start = pos_;
+    char c = json_[pos_];
+    if (c == '"') {
+        value.type = JsonValue::Type::String;
+        return readString(value.raw);
+    }
+    if (c == '{' || c == '[') {
+        value.type = c == '{' ? JsonValue::Type::Object : JsonValue::Type::Array;
+        if (!skipContainer()) return false;
+        value.raw = json_.substr(start, pos_ - start);
+        return true;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        value.type = JsonValue::Type::Number;
+        while (pos_ < json_.size()) {
+            c = json_[pos_];
+            if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) break;
+            pos_++;
+        }
+        value.raw = json_.substr(start, pos_ - start);
+        return true;
+    }
+    static constexpr std::string_view kLiterals[] = {"true", "false", "null"};
+    for (std::string_view lit : kLiterals) {
+        if (json_.substr(pos_, lit.size()) == lit) {
+            value.type = lit == "null" ? JsonValue::Type::Null : JsonValue::Type::Bool;
+            value.raw = json_.substr(pos_, lit.size());
+            pos_ += lit.size();
+            return true;
+        }
+    }
+    return fail();
+}
+
+bool JsonReader::nextMember(std::string_view& key, JsonValue& value) {
+    if (!begin('{', '}')) return false;
+    if (pos_ >= json_.size() || json_[pos_] != '"') return fail();
+    if (!readString(key)) return false;
+    skipWhitespace();
+    if (pos_ >= json_.size() || json_[pos_] != ':') return fail();
+    pos_++;
+    if (!readValue(value)) return false;
+    skipWhitespace();
+    return true;
+}
+
+bool JsonReader::nextElement(JsonValue& value) {
+    if (!begin('[', ']')) return false;
+    if (!readValue(value)) return false;
+    skipWhitespace();
+    return true;
+}
+
+std::string jsonEscape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                static const char kHex[] = "0123456789abcdef";
+                out += "\\u00";
+                out += kHex[(c >> 4) & 0xF];
+                out += kHex[c & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// One JSON value as found by JsonReader. Nothing is decoded until asked
+// for: raw points into the source text and must not outlive it.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Object, Array };
+
+    Type type = Type::Null;
+    std::string_view raw;  // String: between the quotes, still escaped.
+                           // Object/array: including the brackets.
+
+    bool isString() const { return type == Type::String; }
+    bool isNumber() const { return type == Type::Number; }
+
+    // Unescaped string value ("" for non-strings)
+    std::string str() const;
+    int64_t toInt(int64_t fallback = 0) const;
+    double toDouble(double fallback = 0.0) const;
+    bool toBool(bool fallback = false) const;
+};
+
+// Single-pass pull reader over a JSON object or array. Members and
+// elements are visited in order; nested containers are skipped as one
+// value (open one with another JsonReader over value.raw), so only keys at
+// this level are ever seen. No allocation unless a string is decoded.
+//
+//   JsonReader reader(json);
+//   std::string_view key;
+//   JsonValue value;
+//   while (reader.nextMember(key, value)) { ... }
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view json) : json_(json) {}
+
+    // Next member of an object. key is the raw (still escaped) name.
+    // False at the end of the object or on malformed input.
+    bool nextMember(std::string_view& key, JsonValue& value);
+
+    // Next element of an array. False at the end or on malformed input.
+    bool nextElement(JsonValue& value);
+
+    // Input was not well-formed (reading stopped early)
+    bool failed() const { return failed_; }
+
+private:
+    bool begin(char open, char close);
+    bool readValue(JsonValue& value);
+    bool readString(std::string_view& out);
+    bool skipContainer();
+    void skipWhitespace();
+    bool fail();
+
+    std::string_view json_;
+    size_t pos_ = 0;
+    char close_ = 0;
+    bool started_ = false;
+    bool done_ = false;
+    bool failed_ = false;
+};
+
+// Escape a string for embedding between JSON quotes
+std::string jsonEscape(std::string_view s);
@@ -46,18 +46,26 @@ void wakeMacEventLoop();
 #include "context/egl_context.h"
 #include "context/opengl_frame_context.h"
 #include "player/mpris/media_session_mpris.h"
+#include "compositor/dmabuf_selftest.h"
 #include <unistd.h>  // For close()
 #endif
 #include "player/media_session.h"
 #include "player/media_session_thread.h"
+#include "player/player_command.h"
+#include "player/item_json.h"
 #include "player/video_stack.h"
+#include "player/video_pipeline.h"
+#include "player/mpv/hwdec_policy.h"
 #include "player/video_renderer.h"
 #include "player/mpv_event_thread.h"
+#include "player/player_state_mirror.h"
 #include "player/video_render_controller.h"
 #include "cef/cef_app.h"
 #include "cef/cef_client.h"
 #include "cef/cef_thread.h"
 #include "browser/browser_stack.h"
+#include "compositor/frame_scheduler.h"
+#include "compositor/frame_telemetry.h"
 #include "input/input_layer.h"
 #include "input/browser_layer.h"
 #include "input/menu_layer.h"
@@ -65,6 +73,15 @@ void wakeMacEventLoop();
 #include "input/window_state.h"
 #include "ui/menu_overlay.h"
 #include "settings.h"
+#include "startup_graph.h"
+#include "trace.h"
+#include "cef/trace_session.h"
+#ifndef _WIN32
+#include "platform/signal_watcher.h"
+#include "platform/control_socket.h"
+#include <csignal>
+#include <unistd.h>
+#endif
 
 // Overlay fade constants
 constexpr float OVERLAY_FADE_DELAY_SEC = 1.0f;
@@ -120,124 +137,47 @@ SDL_SystemCursor cefCursorToSDL(cef_cursor_type_t type) {
     }
 }
 
-static auto _main_start = std::chrono::steady_clock::now();
-inline long _ms() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _main_start).count(); }
-
-// Simple JSON string value extractor (handles escaped quotes)
-std::string jsonGetString(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
-    size_t pos = json.find(search);
-    if (pos == std::string::npos) return "";
-    pos += search.length();
-    // Skip whitespace
-    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    if (pos >= json.size() || json[pos] != '"') return "";
-    pos++;  // Skip opening quote
-    std::string result;
-    while (pos < json.size() && json[pos] != '"') {
-        if (json[pos] == '\\' && pos + 1 < json.size()) {
-            pos++;  // Skip escape char
-        }
-        result += json[pos++];
-    }
-    return result;
-}
-
-// Extract integer from JSON
-int64_t jsonGetInt(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
-    size_t pos = json.find(search);
-    if (pos == std::string::npos) return 0;
-    pos += search.length();
-    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    std::string num;
-    while (pos < json.size() && (isdigit(json[pos]) || json[pos] == '-')) {
-        num += json[pos++];
-    }
-    return num.empty() ? 0 : std::stoll(num);
-}
-
-// Extract integer from JSON with default value
-int jsonGetIntDefault(const std::string& json, const std::string& key, int defaultVal) {
-    std::string search = "\"" + key + "\":";
-    size_t pos = json.find(search);
-    if (pos == std::string::npos) return defaultVal;
-    pos += search.length();
-    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    if (pos >= json.size()) return defaultVal;
-    bool negative = false;
-    if (json[pos] == '-') { negative = true; pos++; }
-    int val = 0;
-    while (pos < json.size() && json[pos] >= '0' && json[pos] <= '9') {
-        val = val * 10 + (json[pos] - '0');
-        pos++;
+// Find a connected display by name (0 if it is gone)
+static SDL_DisplayID findDisplay(const std::string& name) {
+    if (name.empty()) return 0;
+    int count = 0;
+    SDL_DisplayID* displays = SDL_GetDisplays(&count);
+    if (!displays) return 0;
+    SDL_DisplayID found = 0;
+    for (int i = 0; i < count && !found; i++) {
+        const char* display_name = SDL_GetDisplayName(displays[i]);
+        if (display_name && name == display_name) found = displays[i];
     }
-    return negative ? -val : val;
+    SDL_free(displays);
+    return found;
 }
 
-// Extract double from JSON (with optional hasValue output)
-double jsonGetDouble(const std::string& json, const std::string& key, bool* hasValue = nullptr) {
-    std::string search = "\"" + key + "\":";
-    size_t pos = json.find(search);
-    if (pos == std::string::npos) {
-        if (hasValue) *hasValue = false;
-        return 0.0;
+// Record window placement for the next launch (written debounced)
+static void rememberWindowGeometry(SDL_Window* window) {
+    SDL_WindowFlags flags = SDL_GetWindowFlags(window);
+    // Keep the last restored geometry while minimized/fullscreen
+    if (flags & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_FULLSCREEN)) return;
+
+    WindowGeometry geometry = Settings::instance().windowGeometry();
+    geometry.maximized = (flags & SDL_WINDOW_MAXIMIZED) != 0;
+    if (!geometry.maximized) {
+        SDL_GetWindowSize(window, &geometry.width, &geometry.height);
+        // Wayland never reports a global position
+        const char* driver = SDL_GetCurrentVideoDriver();
+        if (!(driver && strcmp(driver, "wayland") == 0)) {
+            geometry.has_position = SDL_GetWindowPosition(window, &geometry.x, &geometry.y);
+        }
     }
-    pos += search.length();
-    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t')) pos++;
-    std::string num;
-    while (pos < json.size() && (isdigit(json[pos]) || json[pos] == '-' || json[pos] == '.' || json[pos] == 'e' || json[pos] == 'E' || json[pos] == '+')) {
-        num += json[pos++];
+    if (const char* name = SDL_GetDisplayName(SDL_GetDisplayForWindow(window))) {
+        geometry.display = name;
     }
-    if (hasValue) *hasValue = !num.empty();
-    return num.empty() ? 0.0 : std::stod(num);
-}
-
-// Extract first element from JSON array of strings
-std::string jsonGetFirstArrayString(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
-    size_t pos = json.find(search);
-    if (pos == std::string::npos) return "";
-    pos += search.length();
-    while (pos < json.size() && json[pos] != '[') pos++;
-    if (pos >= json.size()) return "";
-    pos++;  // Skip [
-    while (pos < json.size() && json[pos] != '"' && json[pos] != ']') pos++;
-    if (pos >= json.size() || json[pos] == ']') return "";
-    pos++;  // Skip opening quote
-    std::string result;
-    while (pos < json.size() && json[pos] != '"') {
-        if (json[pos] == '\\' && pos + 1 < json.size()) pos++;
-        result += json[pos++];
+    if (Settings::instance().setWindowGeometry(geometry)) {
+        Settings::instance().saveAsync();
     }
-    return result;
 }
 
-MediaMetadata parseMetadataJson(const std::string& json) {
-    MediaMetadata meta;
-    meta.title = jsonGetString(json, "Name");
-    // For episodes, use SeriesName as artist; for audio, use Artists array
-    meta.artist = jsonGetString(json, "SeriesName");
-    if (meta.artist.empty()) {
-        meta.artist = jsonGetFirstArrayString(json, "Artists");
-    }
-    // For episodes, use SeasonName as album; for audio, use Album
-    meta.album = jsonGetString(json, "SeasonName");
-    if (meta.album.empty()) {
-        meta.album = jsonGetString(json, "Album");
-    }
-    meta.track_number = static_cast<int>(jsonGetInt(json, "IndexNumber"));
-    // RunTimeTicks is in 100ns units, convert to microseconds
-    meta.duration_us = jsonGetInt(json, "RunTimeTicks") / 10;
-    // Detect media type from Type field
-    std::string type = jsonGetString(json, "Type");
-    if (type == "Audio") {
-        meta.media_type = MediaType::Audio;
-    } else if (type == "Movie" || type == "Episode" || type == "Video" || type == "MusicVideo") {
-        meta.media_type = MediaType::Video;
-    }
-    return meta;
-}
+static auto _main_start = std::chrono::steady_clock::now();
+inline long _ms() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _main_start).count(); }
 
 int main(int argc, char* argv[]) {
     // CEF subprocesses inherit this env var - skip our arg parsing entirely
@@ -245,10 +185,17 @@ int main(int argc, char* argv[]) {
 
     // Parse arguments (main process only)
     SDL_LogPriority log_level = SDL_LOG_PRIORITY_INFO;
-    bool use_dmabuf = false;  // Disable DMA-BUF by default (can cause system freezes)
+    bool use_dmabuf = true;  // Zero-copy when EGL can import and fence dmabufs (checked at init)
+    bool dmabuf_selftest = false;
+    const char* trace_path = nullptr;  // Non-null: trace from startup (empty = temp dir)
+    const char* telemetry_socket = nullptr;  // Null/empty: default path, "off": none
     if (!is_cef_subprocess) {
         const char* log_level_str = nullptr;
         const char* log_file_path = nullptr;
+        const char* gl_upload_str = nullptr;
+        const char* present_mode_str = nullptr;
+        const char* hwdec_policy_str = nullptr;
+        const char* video_idle_str = nullptr;
         for (int i = 1; i < argc; i++) {
             if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
                 printf("Usage: jellyfin-desktop-cef [options]\n"
@@ -257,9 +204,27 @@ int main(int argc, char* argv[]) {
                        "  -v, --version           Show version information\n"
                        "  --log-level <level>     Set log level (verbose|debug|info|warn|error)\n"
                        "  --log-file <path>       Write logs to file (with timestamps)\n"
+                       "  --trace [<path>]        Record a Chrome trace (native spans + Chromium) until exit\n"
+#ifndef _WIN32
+                       "                          SIGUSR2 starts/stops a trace at any time\n"
+                       "  --telemetry-socket <path|off>\n"
+                       "                          Frame telemetry socket (default in $XDG_RUNTIME_DIR);\n"
+                       "                          SIGUSR1 also dumps it to the temp directory\n"
+#endif
 #if !defined(__APPLE__) && !defined(_WIN32)
-                       "  --dmabuf                Enable DMA-BUF zero-copy CEF rendering (experimental)\n"
+                       "  --no-dmabuf             Disable DMA-BUF zero-copy CEF rendering\n"
+                       "  --dmabuf-selftest       Validate DMA-BUF import on this GPU/driver and exit\n"
+                       "  --present-mode <mode>   Wayland video present mode (fifo|fifo-relaxed|mailbox, default fifo)\n"
+                       "  --hwdec-policy <rules>  Vulkan video hwdec rules, first match wins\n"
+                       "                          (allow|deny[:interop[:codec[:profile[:depth]]]],...)\n"
+                       "                          10/12-bit streams decode in software unless allowed\n"
 #endif
+#ifndef __APPLE__
+                       "  --gl-upload <mode>      CEF frame upload path (sync|ring, default sync)\n"
+#endif
+                       "  --video-idle-timeout <seconds>\n"
+                       "                          Release the video stack after this long without\n"
+                       "                          playback (0 = never, default 300)\n"
                        );
                 return 0;
             } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0) {
@@ -275,8 +240,36 @@ int main(int argc, char* argv[]) {
                 log_file_path = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
             } else if (strncmp(argv[i], "--log-file=", 11) == 0) {
                 log_file_path = argv[i] + 11;
+            } else if (strcmp(argv[i], "--trace") == 0) {
+                trace_path = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
+            } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+                trace_path = argv[i] + 8;
+            } else if (strcmp(argv[i], "--telemetry-socket") == 0) {
+                telemetry_socket = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
+            } else if (strncmp(argv[i], "--telemetry-socket=", 19) == 0) {
+                telemetry_socket = argv[i] + 19;
             } else if (strcmp(argv[i], "--dmabuf") == 0) {
-                use_dmabuf = true;
+                use_dmabuf = true;  // Default now, kept for compatibility
+            } else if (strcmp(argv[i], "--no-dmabuf") == 0) {
+                use_dmabuf = false;
+            } else if (strcmp(argv[i], "--dmabuf-selftest") == 0) {
+                dmabuf_selftest = true;
+            } else if (strcmp(argv[i], "--gl-upload") == 0) {
+                gl_upload_str = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
+            } else if (strncmp(argv[i], "--gl-upload=", 12) == 0) {
+                gl_upload_str = argv[i] + 12;
+            } else if (strcmp(argv[i], "--present-mode") == 0) {
+                present_mode_str = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
+            } else if (strncmp(argv[i], "--present-mode=", 15) == 0) {
+                present_mode_str = argv[i] + 15;
+            } else if (strcmp(argv[i], "--hwdec-policy") == 0) {
+                hwdec_policy_str = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
+            } else if (strncmp(argv[i], "--hwdec-policy=", 15) == 0) {
+                hwdec_policy_str = argv[i] + 15;
+            } else if (strcmp(argv[i], "--video-idle-timeout") == 0) {
+                video_idle_str = (i + 1 < argc && argv[i+1][0] != '-') ? argv[++i] : "";
+            } else if (strncmp(argv[i], "--video-idle-timeout=", 21) == 0) {
+                video_idle_str = argv[i] + 21;
             } else if (argv[i][0] == '-') {
                 fprintf(stderr, "Unknown option: %s\n", argv[i]);
                 return 1;
@@ -299,17 +292,57 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
         }
+        if (gl_upload_str && gl_upload_str[0]) {
+#ifndef __APPLE__
+            if (strcmp(gl_upload_str, "ring") == 0) {
+                OpenGLCompositor::setUploadMode(OpenGLCompositor::UploadMode::Ring);
+            } else if (strcmp(gl_upload_str, "sync") == 0) {
+                OpenGLCompositor::setUploadMode(OpenGLCompositor::UploadMode::Sync);
+            } else {
+                fprintf(stderr, "Invalid GL upload mode: %s\n", gl_upload_str);
+                return 1;
+            }
+#endif
+        }
+        if (present_mode_str && present_mode_str[0]) {
+#if !defined(__APPLE__) && !defined(_WIN32)
+            if (strcmp(present_mode_str, "fifo") == 0) {
+                VideoStack::setPresentMode(VideoPresentMode::Fifo);
+            } else if (strcmp(present_mode_str, "fifo-relaxed") == 0) {
+                VideoStack::setPresentMode(VideoPresentMode::FifoRelaxed);
+            } else if (strcmp(present_mode_str, "mailbox") == 0) {
+                VideoStack::setPresentMode(VideoPresentMode::Mailbox);
+            } else {
+                fprintf(stderr, "Invalid present mode: %s\n", present_mode_str);
+                return 1;
+            }
+#endif
+        }
+        if (hwdec_policy_str && hwdec_policy_str[0]) {
+#if !defined(__APPLE__) && !defined(_WIN32)
+            std::vector<HwdecPolicy::Rule> rules;
+            if (!HwdecPolicy::parseRules(hwdec_policy_str, rules)) {
+                fprintf(stderr, "Invalid hwdec policy: %s\n", hwdec_policy_str);
+                return 1;
+            }
+            HwdecPolicy::setDefaultRules(std::move(rules));
+#endif
+        }
+        if (video_idle_str && video_idle_str[0]) {
+            char* end = nullptr;
+            long secs = strtol(video_idle_str, &end, 10);
+            if (*end != '\0' || secs < 0) {
+                fprintf(stderr, "Invalid video idle timeout: %s\n", video_idle_str);
+                return 1;
+            }
+            VideoPipeline::setIdleTimeout(std::chrono::seconds(secs));
+        }
 
         initLogging(log_level);
 
         // Startup banner
         LOG_INFO(LOG_MAIN, "jellyfin-desktop-cef " APP_VERSION_STRING " built " __DATE__ " " __TIME__);
         LOG_INFO(LOG_MAIN, "CEF " CEF_VERSION);
-#if !defined(__APPLE__) && !defined(_WIN32)
-        if (use_dmabuf) {
-            LOG_INFO(LOG_MAIN, "DMA-BUF zero-copy CEF rendering enabled (experimental)");
-        }
-#endif
     }
 
 #ifdef __APPLE__
@@ -376,18 +409,122 @@ int main(int argc, char* argv[]) {
         return exit_code;
     }
 
+    // Shared player state for the page (read via jmpNative.playerState);
+    // without it the page falls back to pushed updates
+    PlayerStateMirror player_state_mirror;
+    if (player_state_mirror.create()) {
+        App::SetPlayerStateMirror(player_state_mirror.name());
+    }
+    PlayerStateSnapshot player_state;
+    bool player_state_dirty = false;
+
 #if defined(__APPLE__) && defined(NDEBUG)
     // In release builds, offer to move app to /Applications (clears quarantine)
     PFMoveToApplicationsFolderIfNecessary();
 #endif
 
+    // CEF settings (CefThread sets external_message_pump)
+    CefSettings settings;
+    settings.no_sandbox = true;
+    settings.windowless_rendering_enabled = true;
+
+#ifdef __APPLE__
+    // macOS: Set framework path (cef_framework_path set earlier during CEF loading)
+    CefString(&settings.framework_dir_path).FromString((cef_framework_path / "Chromium Embedded Framework.framework").string());
+    // Use main executable as subprocess - it handles CefExecuteProcess early
+    CefString(&settings.browser_subprocess_path).FromString((exe_path / "jellyfin-desktop-cef").string());
+#elif defined(_WIN32)
+    // Windows: Get exe path
+    wchar_t exe_buf[MAX_PATH];
+    GetModuleFileNameW(nullptr, exe_buf, MAX_PATH);
+    std::filesystem::path exe_path = std::filesystem::path(exe_buf).parent_path();
+    CefString(&settings.resources_dir_path).FromString(exe_path.string());
+    CefString(&settings.locales_dir_path).FromString((exe_path / "locales").string());
+#else
+    std::filesystem::path exe_path = std::filesystem::canonical("/proc/self/exe").parent_path();
+#ifdef CEF_RESOURCES_DIR
+    CefString(&settings.resources_dir_path).FromString(CEF_RESOURCES_DIR);
+    CefString(&settings.locales_dir_path).FromString(CEF_RESOURCES_DIR "/locales");
+#else
+    CefString(&settings.resources_dir_path).FromString(exe_path.string());
+    CefString(&settings.locales_dir_path).FromString((exe_path / "locales").string());
+#endif
+#endif
+
+    // Cache path
+    std::filesystem::path cache_path;
+#ifdef _WIN32
+    if (const char* appdata = std::getenv("LOCALAPPDATA")) {
+        cache_path = std::filesystem::path(appdata) / "jellyfin-desktop-cef";
+    }
+#elif defined(__APPLE__)
+    if (const char* home = std::getenv("HOME")) {
+        cache_path = std::filesystem::path(home) / "Library" / "Caches" / "jellyfin-desktop-cef";
+    }
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        cache_path = std::filesystem::path(xdg) / "jellyfin-desktop-cef";
+    } else if (const char* home = std::getenv("HOME")) {
+        cache_path = std::filesystem::path(home) / ".cache" / "jellyfin-desktop-cef";
+    }
+#endif
+    if (!cache_path.empty()) {
+        CefString(&settings.root_cache_path).FromString(cache_path.string());
+        CefString(&settings.cache_path).FromString((cache_path / "cache").string());
+    }
+
+    // Capture stderr before CEF starts (routes Chromium logs through SDL)
+    initStderrCapture();
+
+    // Startup runs as a dependency graph: settings, the menu font and the
+    // cache directory load on worker threads, and on Windows/Linux CEF
+    // initializes on its own thread while the window and GL context come up
+    // here. The video stack waits for the first playerLoad (VideoPipeline).
+#ifndef __APPLE__
+    CefThread cefThread;  // Before the graph, whose cefInit stage runs it
+#endif
+    MenuOverlay menu;
+    StartupGraph startup;
+    auto settings_stage = startup.spawn("settings", {}, []() {
+        Settings::instance().load();
+        return true;  // No settings file yet is fine
+    });
+    auto fonts_stage = startup.spawn("fonts", {}, [&menu]() {
+        if (!menu.init()) {
+            LOG_WARN(LOG_MENU, "Failed to init menu overlay (no font found)");
+        }
+        return true;
+    });
+    auto cache_stage = startup.spawn("cacheDir", {}, [&cache_path]() {
+        std::error_code ec;
+        if (!cache_path.empty()) {
+            std::filesystem::create_directories(cache_path, ec);
+        }
+        return true;  // CEF creates it itself if we couldn't
+    });
+
     SDL_SetAppMetadata("Jellyfin Desktop CEF", nullptr, "org.jellyfin.JellyfinDesktopCEF");
 
     // SDL initialization with OpenGL (for main surface CEF overlay)
+    auto sdl_stage = startup.add("sdlInit");
+    startup.begin(sdl_stage);
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         LOG_ERROR(LOG_MAIN, "SDL_Init failed: %s", SDL_GetError());
         return 1;
     }
+    startup.end(sdl_stage);
+
+#ifndef __APPLE__
+    // Windows/Linux: CEF runs on a dedicated thread; its init overlaps the
+    // window, GL and video stack setup below. After SDL_Init so the two
+    // don't race on display connection setup.
+    StartupGraph::Stage cef_stage = -1;
+    if (!dmabuf_selftest) {
+        cef_stage = startup.spawn("cefInit", {cache_stage, sdl_stage}, [&]() {
+            return cefThread.start(main_args, settings, app);
+        });
+    }
+#endif
 
     // Register custom event for cross-thread main loop wake-up
     static Uint32 SDL_EVENT_WAKE = SDL_RegisterEvents(1);
@@ -407,16 +544,50 @@ int main(int argc, char* argv[]) {
     App::SetWakeCallback(wakeMainLoop);
 #endif
 
-    const int width = 1280;
-    const int height = 720;
+    // Render on demand: producers request a frame, idle iterations sleep
+    FrameScheduler frame_scheduler;
+    auto requestPaintFrame = [&frame_scheduler, wakeMainLoop]() {
+        frame_scheduler.request(FrameScheduler::kPaint);
+        wakeMainLoop();
+    };
+
+    auto window_stage = startup.add("window", {settings_stage});
+    startup.begin(window_stage);
+
+    // Restore the last window placement so browsers and compositors are
+    // created at their final size instead of resizing after the first paint
+    WindowGeometry geometry = Settings::instance().windowGeometry();
+    SDL_DisplayID saved_display = findDisplay(geometry.display);
+    int window_x = SDL_WINDOWPOS_UNDEFINED;
+    int window_y = SDL_WINDOWPOS_UNDEFINED;
+    SDL_Rect usable;
+    if (saved_display && SDL_GetDisplayUsableBounds(saved_display, &usable)) {
+        geometry.width = std::min(geometry.width, usable.w);
+        geometry.height = std::min(geometry.height, usable.h);
+        SDL_Rect saved_rect = {geometry.x, geometry.y, geometry.width, geometry.height};
+        if (geometry.has_position && SDL_HasRectIntersection(&saved_rect, &usable)) {
+            window_x = geometry.x;
+            window_y = geometry.y;
+        } else {
+            window_x = window_y = SDL_WINDOWPOS_CENTERED_DISPLAY(saved_display);
+        }
+    }
 
     // Use plain Wayland window - we create our own EGL context
     // SDL_WINDOW_HIGH_PIXEL_DENSITY enables HiDPI support
-    SDL_Window* window = SDL_CreateWindow(
-        "Jellyfin Desktop CEF",
-        width, height,
-        SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY
-    );
+    SDL_WindowFlags window_flags = SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY;
+    if (geometry.maximized) {
+        window_flags |= SDL_WINDOW_MAXIMIZED;
+    }
+    SDL_PropertiesID window_props = SDL_CreateProperties();
+    SDL_SetStringProperty(window_props, SDL_PROP_WINDOW_CREATE_TITLE_STRING, "Jellyfin Desktop CEF");
+    SDL_SetNumberProperty(window_props, SDL_PROP_WINDOW_CREATE_X_NUMBER, window_x);
+    SDL_SetNumberProperty(window_props, SDL_PROP_WINDOW_CREATE_Y_NUMBER, window_y);
+    SDL_SetNumberProperty(window_props, SDL_PROP_WINDOW_CREATE_WIDTH_NUMBER, geometry.width);
+    SDL_SetNumberProperty(window_props, SDL_PROP_WINDOW_CREATE_HEIGHT_NUMBER, geometry.height);
+    SDL_SetNumberProperty(window_props, SDL_PROP_WINDOW_CREATE_FLAGS_NUMBER, window_flags);
+    SDL_Window* window = SDL_CreateWindowWithProperties(window_props);
+    SDL_DestroyProperties(window_props);
 
     if (!window) {
         LOG_ERROR(LOG_MAIN, "SDL_CreateWindow failed: %s", SDL_GetError());
@@ -424,7 +595,16 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    // Maximizing may already have changed the size
+    int width = geometry.width;
+    int height = geometry.height;
+    SDL_GetWindowSize(window, &width, &height);
+    LOG_INFO(LOG_WINDOW, "Window: %dx%d%s on %s", width, height,
+             geometry.maximized ? " (maximized)" : "",
+             geometry.display.empty() ? "default display" : geometry.display.c_str());
+
     SDL_StartTextInput(window);
+    startup.end(window_stage);
 
 #ifdef __APPLE__
     // Window activation is deferred until first WINDOW_EXPOSED event
@@ -432,15 +612,8 @@ int main(int argc, char* argv[]) {
 #endif
 
 #ifdef __APPLE__
-    // Create video stack
-    VideoStack videoStack = VideoStack::create(window, width, height);
-    if (!videoStack.player || !videoStack.renderer) {
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
-    }
-    MpvPlayer* mpv = videoStack.player.get();
-    VideoRenderer& videoRenderer = *videoStack.renderer;
+    // Video stack, created on first playerLoad
+    VideoPipeline video(window);
     bool has_video = false;
     bool video_needs_rerender = false;
     double current_playback_rate = 1.0;
@@ -457,6 +630,8 @@ int main(int argc, char* argv[]) {
     compositor_ctx.window = window;
 #elif defined(_WIN32)
     // Windows: Initialize WGL context for OpenGL rendering
+    auto gl_stage = startup.add("glContext");
+    startup.begin(gl_stage);
     WGLContext wgl;
     if (!wgl.init(window)) {
         LOG_ERROR(LOG_GL, "WGL init failed");
@@ -464,16 +639,10 @@ int main(int argc, char* argv[]) {
         SDL_Quit();
         return 1;
     }
+    startup.end(gl_stage);
 
-    // Create video stack
-    VideoStack videoStack = VideoStack::create(window, width, height, &wgl);
-    if (!videoStack.player || !videoStack.renderer) {
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return 1;
-    }
-    MpvPlayer* mpv = videoStack.player.get();
-    VideoRenderer& videoRenderer = *videoStack.renderer;
+    // Video stack, created on first playerLoad
+    VideoPipeline video(window, &wgl);
     bool has_video = false;
     bool video_needs_rerender = false;
     double current_playback_rate = 1.0;
@@ -487,6 +656,8 @@ int main(int argc, char* argv[]) {
     int physical_height = height;
 #else
     // Linux: Initialize EGL context for OpenGL rendering
+    auto gl_stage = startup.add("glContext");
+    startup.begin(gl_stage);
     EGLContext_ egl;
     if (!egl.init(window)) {
         LOG_ERROR(LOG_GL, "EGL init failed");
@@ -494,16 +665,20 @@ int main(int argc, char* argv[]) {
         SDL_Quit();
         return 1;
     }
+    startup.end(gl_stage);
 
-    // Create video stack (detects Wayland vs X11 internally)
-    VideoStack videoStack = VideoStack::create(window, width, height, &egl);
-    if (!videoStack.player || !videoStack.renderer) {
+    if (dmabuf_selftest) {
+        OpenGLCompositor selftest_compositor;
+        bool ok = selftest_compositor.init(&egl, width, height) && runDmabufSelfTest(selftest_compositor);
+        selftest_compositor.cleanup();
+        egl.cleanup();
         SDL_DestroyWindow(window);
         SDL_Quit();
-        return 1;
+        return ok ? 0 : 1;
     }
-    MpvPlayer* mpv = videoStack.player.get();
-    VideoRenderer& videoRenderer = *videoStack.renderer;
+
+    // Video stack, created on first playerLoad (detects Wayland vs X11 then)
+    VideoPipeline video(window, &egl);
     bool has_video = false;
     bool video_needs_rerender = false;
     double current_playback_rate = 1.0;
@@ -522,66 +697,11 @@ int main(int argc, char* argv[]) {
     compositor_ctx.gl_context = &egl;
 #endif
 
-    // Load settings
-    Settings::instance().load();
-
-    // CEF settings (CefThread sets external_message_pump)
-    CefSettings settings;
-    settings.no_sandbox = true;
-    settings.windowless_rendering_enabled = true;
-
-#ifdef __APPLE__
-    // macOS: Set framework path (cef_framework_path set earlier during CEF loading)
-    CefString(&settings.framework_dir_path).FromString((cef_framework_path / "Chromium Embedded Framework.framework").string());
-    // Use main executable as subprocess - it handles CefExecuteProcess early
-    CefString(&settings.browser_subprocess_path).FromString((exe_path / "jellyfin-desktop-cef").string());
-#elif defined(_WIN32)
-    // Windows: Get exe path
-    wchar_t exe_buf[MAX_PATH];
-    GetModuleFileNameW(nullptr, exe_buf, MAX_PATH);
-    std::filesystem::path exe_path = std::filesystem::path(exe_buf).parent_path();
-    CefString(&settings.resources_dir_path).FromString(exe_path.string());
-    CefString(&settings.locales_dir_path).FromString((exe_path / "locales").string());
-#else
-    std::filesystem::path exe_path = std::filesystem::canonical("/proc/self/exe").parent_path();
-#ifdef CEF_RESOURCES_DIR
-    CefString(&settings.resources_dir_path).FromString(CEF_RESOURCES_DIR);
-    CefString(&settings.locales_dir_path).FromString(CEF_RESOURCES_DIR "/locales");
-#else
-    CefString(&settings.resources_dir_path).FromString(exe_path.string());
-    CefString(&settings.locales_dir_path).FromString((exe_path / "locales").string());
-#endif
-#endif
-
-    // Cache path
-    std::filesystem::path cache_path;
-#ifdef _WIN32
-    if (const char* appdata = std::getenv("LOCALAPPDATA")) {
-        cache_path = std::filesystem::path(appdata) / "jellyfin-desktop-cef";
-    }
-#elif defined(__APPLE__)
-    if (const char* home = std::getenv("HOME")) {
-        cache_path = std::filesystem::path(home) / "Library" / "Caches" / "jellyfin-desktop-cef";
-    }
-#else
-    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
-        cache_path = std::filesystem::path(xdg) / "jellyfin-desktop-cef";
-    } else if (const char* home = std::getenv("HOME")) {
-        cache_path = std::filesystem::path(home) / ".cache" / "jellyfin-desktop-cef";
-    }
-#endif
-    if (!cache_path.empty()) {
-        std::filesystem::create_directories(cache_path);
-        CefString(&settings.root_cache_path).FromString(cache_path.string());
-        CefString(&settings.cache_path).FromString((cache_path / "cache").string());
-    }
-
-    // Capture stderr before CEF starts (routes Chromium logs through SDL)
-    initStderrCapture();
-
 #ifdef __APPLE__
     // Pre-create Metal compositors BEFORE CefInitialize to avoid startup delay
     // Metal device/pipeline/texture creation takes time; do it while CEF init runs
+    auto compositors_stage = startup.add("compositors");
+    startup.begin(compositors_stage);
     auto overlay_compositor = std::make_unique<MetalCompositor>();
     overlay_compositor->init(window, physical_width, physical_height);
     LOG_DEBUG(LOG_COMPOSITOR, "Pre-created overlay Metal compositor");
@@ -589,8 +709,11 @@ int main(int argc, char* argv[]) {
     auto main_compositor = std::make_unique<MetalCompositor>();
     main_compositor->init(window, physical_width, physical_height);
     LOG_DEBUG(LOG_COMPOSITOR, "Pre-created main Metal compositor");
+    startup.end(compositors_stage);
 
     // macOS: Use external_message_pump on main thread (CEF doesn't handle separate thread well)
+    auto cef_stage = startup.add("cefInit", {cache_stage});
+    startup.begin(cef_stage);
     settings.external_message_pump = true;
     if (!CefInitialize(main_args, settings, app, nullptr)) {
         LOG_ERROR(LOG_CEF, "CefInitialize failed");
@@ -599,31 +722,31 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     LOG_INFO(LOG_CEF, "CEF context initialized");
-#else
-    // Windows/Linux: Start CEF on dedicated thread
-    CefThread cefThread;
-    if (!cefThread.start(main_args, settings, app)) {
+    startup.end(cef_stage);
+#endif
+
+    // Browser setup needs CEF and the menu font
+    auto browsers_stage = startup.add("browsers", {fonts_stage, cef_stage});
+    if (!startup.begin(browsers_stage)) {
         LOG_ERROR(LOG_CEF, "CefThread start failed");
         SDL_DestroyWindow(window);
         SDL_Quit();
         return 1;
     }
-#endif
 
     // Browser stack manages all browsers and their paint buffers
     BrowserStack browsers;
     bool paint_size_matched = true;  // Track if last paint matched compositor size
 
-    // Player command queue
-    struct PlayerCmd {
-        std::string cmd;
-        std::string url;
-        int intArg;
-        double doubleArg;
-        std::string metadata;  // JSON for load command
+    // Player command queue (CEF and media session threads -> main loop)
+    PlayerCommandQueue cmd_queue;
+    cmd_queue.setWakeCallback(wakeMainLoop);
+    auto postPlayerCmd = [&cmd_queue](PlayerCommand&& cmd) {
+        if (!cmd_queue.post(std::move(cmd))) {
+            LOG_WARN(LOG_MAIN, "Player command queue full, dropping command");
+        }
     };
-    std::mutex cmd_mutex;
-    std::vector<PlayerCmd> pending_cmds;
+    std::mutex cmd_mutex;  // Guards pending_server_url
 
     // Initialize media session with platform backend
     MediaSession mediaSession;
@@ -636,40 +759,23 @@ int main(int argc, char* argv[]) {
 #endif
     MediaSessionThread mediaSessionThread;
     mediaSessionThread.start(&mediaSession);
-    mediaSession.onPlay = [&]() {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_action", "play", 0, 0.0});
+    auto postMediaAction = [postPlayerCmd](MediaAction action) {
+        postPlayerCmd(PlayerCommand::make(PlayerOp::MediaAction, static_cast<int>(action)));
     };
-    mediaSession.onPause = [&]() {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_action", "pause", 0, 0.0});
-    };
-    mediaSession.onPlayPause = [&]() {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_action", "play_pause", 0, 0.0});
-    };
-    mediaSession.onStop = [&]() {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_action", "stop", 0, 0.0});
-    };
-    mediaSession.onSeek = [&](int64_t position_us) {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_seek", "", static_cast<int>(position_us / 1000), 0.0});
-    };
-    mediaSession.onNext = [&]() {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_action", "next", 0, 0.0});
-    };
-    mediaSession.onPrevious = [&]() {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_action", "previous", 0, 0.0});
+    mediaSession.onPlay = [postMediaAction]() { postMediaAction(MediaAction::Play); };
+    mediaSession.onPause = [postMediaAction]() { postMediaAction(MediaAction::Pause); };
+    mediaSession.onPlayPause = [postMediaAction]() { postMediaAction(MediaAction::PlayPause); };
+    mediaSession.onStop = [postMediaAction]() { postMediaAction(MediaAction::Stop); };
+    mediaSession.onSeek = [postPlayerCmd](int64_t position_us) {
+        postPlayerCmd(PlayerCommand::make(PlayerOp::MediaSeek, static_cast<int>(position_us / 1000)));
     };
+    mediaSession.onNext = [postMediaAction]() { postMediaAction(MediaAction::Next); };
+    mediaSession.onPrevious = [postMediaAction]() { postMediaAction(MediaAction::Previous); };
     mediaSession.onRaise = [&]() {
         SDL_RaiseWindow(window);
     };
-    mediaSession.onSetRate = [&](double rate) {
-        std::lock_guard<std::mutex> lock(cmd_mutex);
-        pending_cmds.push_back({"media_rate", "", 0, rate});
+    mediaSession.onSetRate = [postPlayerCmd](double rate) {
+        postPlayerCmd(PlayerCommand::makeDouble(PlayerOp::MediaRate, rate));
     };
 
     // Overlay browser state
@@ -680,12 +786,6 @@ int main(int argc, char* argv[]) {
     float clear_color = 16.0f / 255.0f;  // #101010 until fade begins
     std::string pending_server_url;
 
-    // Context menu overlay
-    MenuOverlay menu;
-    if (!menu.init()) {
-        LOG_WARN(LOG_MENU, "Failed to init menu overlay (no font found)");
-    }
-
     // Cursor state
     SDL_Cursor* current_cursor = nullptr;
 
@@ -713,13 +813,13 @@ int main(int argc, char* argv[]) {
 
     // Overlay browser client (for loading UI)
     CefRefPtr<OverlayClient> overlay_client(new OverlayClient(width, height,
-        [overlay_paint_cb](const void* buffer, int w, int h) {
+        [overlay_paint_cb](const void* buffer, int w, int h, const CefRenderHandler::RectList& dirty) {
             static bool first_overlay_paint = true;
             if (first_overlay_paint) {
                 LOG_DEBUG(LOG_OVERLAY, "first paint callback: %dx%d", w, h);
                 first_overlay_paint = false;
             }
-            overlay_paint_cb(buffer, w, h);
+            overlay_paint_cb(buffer, w, h, dirty);
         },
         [&](const std::string& url) {
             // loadServer callback - start loading main browser
@@ -730,9 +830,11 @@ int main(int argc, char* argv[]) {
         getPhysicalSize,
 #if !defined(__APPLE__) && !defined(_WIN32)
         // Accelerated paint callback for overlay
-        [overlay_ptr, wakeMainLoop](int fd, uint32_t stride, uint64_t modifier, int w, int h) {
-            overlay_ptr->compositor->queueDmabuf(fd, stride, modifier, w, h);
-            wakeMainLoop();
+        [overlay_ptr, requestPaintFrame](const DmabufFrame& frame) {
+            uint64_t ticket = overlay_ptr->compositor->queueDmabuf(frame);
+            requestPaintFrame();
+            // Hold CEF's buffer until composited (bounded so a stalled main loop can't wedge CEF)
+            overlay_ptr->compositor->waitDmabufReleased(ticket, 50);
         }
 #else
         nullptr
@@ -751,7 +853,7 @@ int main(int argc, char* argv[]) {
     overlay_ptr->isClosed = [overlay_client]() { return overlay_client->isClosed(); };
     overlay_ptr->input_layer = std::make_unique<BrowserLayer>(overlay_client.get());
     overlay_ptr->input_layer->setWindowSize(width, height);
-    overlay_ptr->wake_main_loop = wakeMainLoop;
+    overlay_ptr->wake_main_loop = requestPaintFrame;
     browsers.add("overlay", std::move(overlay_entry));
 
     // Track who initiated fullscreen (only changes from NONE, returns to NONE on exit)
@@ -771,32 +873,37 @@ int main(int argc, char* argv[]) {
         SDL_Quit();
         return 1;
     }
+#if !defined(_WIN32)
+    if (use_dmabuf && !main_ptr->compositor->dmabufImportSupported()) {
+        LOG_INFO(LOG_MAIN, "DMA-BUF import/fence extensions missing, using software CEF rendering");
+        use_dmabuf = false;
+    }
+    LOG_INFO(LOG_MAIN, "CEF rendering: %s", use_dmabuf ? "DMA-BUF zero-copy" : "software");
+#endif
 #endif
     auto main_paint_cb = main_ptr->makePaintCallback();
 
     CefRefPtr<Client> client(new Client(width, height,
-        [main_paint_cb, main_ptr, &paint_size_matched](const void* buffer, int w, int h) {
+        [main_paint_cb, main_ptr, &paint_size_matched](const void* buffer, int w, int h, const CefRenderHandler::RectList& dirty) {
             static int paint_count = 0;
             if (paint_count++ % 100 == 0) {
                 LOG_DEBUG(LOG_CEF, "main browser paint #%d: %dx%d", paint_count, w, h);
             }
-            main_paint_cb(buffer, w, h);
+            main_paint_cb(buffer, w, h, dirty);
             // Track if paint matched compositor size
             if (w == static_cast<int>(main_ptr->compositor->width()) &&
                 h == static_cast<int>(main_ptr->compositor->height())) {
                 paint_size_matched = true;
             }
         },
-        [&](const std::string& cmd, const std::string& arg, int intArg, const std::string& metadata) {
-            std::lock_guard<std::mutex> lock(cmd_mutex);
-            pending_cmds.push_back({cmd, arg, intArg, 0.0, metadata});
-            wakeMainLoop();  // Wake from idle wait to process command
-        },
+        postPlayerCmd,
 #if !defined(__APPLE__) && !defined(_WIN32)
         // Accelerated paint callback - queue dmabuf for import on main thread
-        [main_ptr, wakeMainLoop](int fd, uint32_t stride, uint64_t modifier, int w, int h) {
-            main_ptr->compositor->queueDmabuf(fd, stride, modifier, w, h);
-            wakeMainLoop();
+        [main_ptr, requestPaintFrame](const DmabufFrame& frame) {
+            uint64_t ticket = main_ptr->compositor->queueDmabuf(frame);
+            requestPaintFrame();
+            // Hold CEF's buffer until composited (bounded so a stalled main loop can't wedge CEF)
+            main_ptr->compositor->waitDmabufReleased(ticket, 50);
         },
 #else
         nullptr,  // No GPU accelerated paint on macOS/Windows
@@ -836,6 +943,7 @@ int main(int argc, char* argv[]) {
         }
 #endif
     ));
+    client->setPopupCallback(main_ptr->makePopupCallback());
     main_ptr->client = client;
     main_ptr->getBrowser = [client]() { return client->browser(); };
     main_ptr->resizeBrowser = [client](int w, int h) { client->resize(w, h); };
@@ -843,7 +951,7 @@ int main(int argc, char* argv[]) {
     main_ptr->isClosed = [client]() { return client->isClosed(); };
     main_ptr->input_layer = std::make_unique<BrowserLayer>(client.get());
     main_ptr->input_layer->setWindowSize(width, height);
-    main_ptr->wake_main_loop = wakeMainLoop;
+    main_ptr->wake_main_loop = requestPaintFrame;
     browsers.add("main", std::move(main_entry));
 
     CefWindowInfo window_info;
@@ -855,7 +963,6 @@ int main(int argc, char* argv[]) {
 #else
     window_info.shared_texture_enabled = use_dmabuf;  // Linux: dmabuf zero-copy
 #endif
-    (void)use_dmabuf;
 
     CefBrowserSettings browser_settings;
     browser_settings.background_color = 0;
@@ -904,6 +1011,9 @@ int main(int argc, char* argv[]) {
         LOG_INFO(LOG_MAIN, "Loading saved server: %s", saved_url.c_str());
         CefBrowserHost::CreateBrowser(window_info, client, saved_url, browser_settings, nullptr, nullptr);
     }
+    startup.end(browsers_stage);
+    startup.report();
+
     // Input routing stack - use BrowserStack for input layers
     MenuLayer menu_layer(&menu);
     InputStack input_stack;
@@ -921,7 +1031,7 @@ int main(int argc, char* argv[]) {
     window_state.add(active_browser);
 #ifndef __APPLE__
     // Windows/Linux: Pause video on minimize
-    MpvLayer mpv_layer(mpv);
+    MpvLayer mpv_layer;
     window_state.add(&mpv_layer);
 #endif
 
@@ -935,22 +1045,58 @@ int main(int argc, char* argv[]) {
 #endif
 #if !defined(_WIN32) && !defined(__APPLE__)
     auto last_resize_time = Clock::now() - std::chrono::seconds(10);  // Track when resize stopped
+    DamageRegion frame_damage;        // Window area to redraw this frame
+    bool video_was_in_window = false;  // Last frame had video composited into the window
 #endif
 
-    // Start mpv event thread - processes events and queues them for main thread
-    MpvEventThread mpvEvents;
-    mpvEvents.start(mpv);
+    // mpv event thread (runs while the video stack exists) - processes
+    // events and queues them for main thread
+    MpvEventThread& mpvEvents = video.events();
+    mpvEvents.setWakeCallback(wakeMainLoop);
+
+#ifndef __APPLE__
+    // Video render thread, likewise started with the video stack
+    VideoRenderController& videoController = video.controller();
+    videoController.setFrameCallback([&frame_scheduler, wakeMainLoop]() {
+        frame_scheduler.request(FrameScheduler::kVideo);
+        wakeMainLoop();
+    });
+#endif
 
+    // Tracing: --trace records from here until exit, SIGUSR2 toggles
+    TraceSession trace_session(trace_path ? trace_path : "");
 #ifndef __APPLE__
-    // Windows and Linux use threaded video rendering
-    // Windows: OpenGL with shared WGL context + FBO
-    // Linux/Wayland: Vulkan subsurface
-    // Linux/X11: OpenGL with shared EGL context + FBO
-    VideoRenderController videoController;
-    videoController.startThreaded(&videoRenderer);
-    mpv->setRedrawCallback([&videoController]() {
-        videoController.notify();
+    TraceRecorder::setThreadName("Main loop");  // macOS: main thread is CrBrowserMain
+#endif
+#ifndef _WIN32
+    SignalWatcher::watch(SIGUSR2, [&trace_session]() { trace_session.toggle(); });
+#endif
+    if (trace_path) {
+        trace_session.start();
+    }
+
+    // Frame telemetry: always recording. SIGUSR1 writes the percentiles to
+    // the temp directory; the control socket answers each connection with them.
+    FrameTelemetry frame_telemetry;
+#ifndef _WIN32
+    SignalWatcher::watch(SIGUSR1, [&frame_telemetry]() {
+        std::error_code ec;
+        std::filesystem::path path = std::filesystem::temp_directory_path(ec) /
+            ("jellyfin-desktop-frames-" + std::to_string(getpid()) + ".json");
+        if (frame_telemetry.writeJson(path.string())) {
+            LOG_INFO(LOG_MAIN, "Frame telemetry written to %s", path.string().c_str());
+        }
+        frame_telemetry.logSummary();
     });
+    std::string telemetry_socket_path = telemetry_socket ? telemetry_socket : "";
+    if (telemetry_socket_path.empty()) {
+        telemetry_socket_path = ControlSocket::defaultPath();
+    }
+    if (!telemetry_socket_path.empty() && telemetry_socket_path != "off") {
+        ControlSocket::start(telemetry_socket_path, [&frame_telemetry]() {
+            return frame_telemetry.dumpJson();
+        });
+    }
 #endif
 
 #ifdef __APPLE__
@@ -958,7 +1104,7 @@ int main(int argc, char* argv[]) {
     struct LiveResizeContext {
         SDL_Window* window;
         BrowserStack* browsers;
-        VideoRenderer* videoRenderer;
+        VideoPipeline* video;
         int* current_width;
         int* current_height;
         bool* has_video;
@@ -966,7 +1112,7 @@ int main(int argc, char* argv[]) {
     LiveResizeContext live_resize_ctx = {
         window,
         &browsers,
-        &videoRenderer,
+        &video,
         &current_width,
         &current_height,
         &has_video
@@ -986,7 +1132,9 @@ int main(int argc, char* argv[]) {
             float scale = SDL_GetWindowDisplayScale(ctx->window);
             int physical_w = static_cast<int>(*ctx->current_width * scale);
             int physical_h = static_cast<int>(*ctx->current_height * scale);
-            ctx->videoRenderer->resize(physical_w, physical_h);
+            if (VideoRenderer* videoRenderer = ctx->video->renderer()) {
+                videoRenderer->resize(physical_w, physical_h);
+            }
         }
 
         // Render on EXPOSED events during live resize
@@ -995,8 +1143,9 @@ int main(int argc, char* argv[]) {
             App::DoWork();
 
             // Render video if playing
-            if (*ctx->has_video && ctx->videoRenderer->hasFrame()) {
-                ctx->videoRenderer->render(*ctx->current_width, *ctx->current_height);
+            VideoRenderer* videoRenderer = ctx->video->renderer();
+            if (*ctx->has_video && videoRenderer && videoRenderer->hasFrame()) {
+                videoRenderer->render(*ctx->current_width, *ctx->current_height);
             }
 
             // Flush and composite all browsers (back-to-front order)
@@ -1016,28 +1165,266 @@ int main(int argc, char* argv[]) {
 
     // Main loop - simplified (no Vulkan command buffers for main surface)
     bool running = true;
-    bool needs_render = true;  // Render first frame
+    bool video_was_active = false;
     int slow_frame_count = 0;
+#ifndef __APPLE__
+    int pool_trim_ms = -1;  // Until pooled GPU storage left by a resize is due to be freed (-1 = none)
+#endif
+    int video_release_ms = -1;  // Until the unused video stack is due to be released (-1 = none)
+    MpvBufferedRanges buffered_ranges;  // Reused across frames (~0.5 KB)
+
+    // The video stack comes up on demand; settings the page changed while
+    // there was none are applied to the new player
+    auto acquireVideo = [&]() {
+        bool fresh = !video.created();
+        if (!video.acquire(current_width, current_height)) {
+            return false;
+        }
+        if (fresh) {
+            MpvPlayer* mpv = video.player();
+            mpv->setVolume(player_state.volume);
+            mpv->setMuted(player_state.muted);
+            mpv->setSpeed(player_state.rate);
+#ifndef __APPLE__
+            mpv_layer.setPlayer(mpv);
+#endif
+        }
+        return true;
+    };
+    auto releaseVideo = [&]() {
+#ifndef __APPLE__
+        mpv_layer.setPlayer(nullptr);
+#endif
+        video.release();
+        frame_scheduler.request(FrameScheduler::kVideo);  // Clear alpha / video layer changed
+    };
+
+    // Player command dispatch table, indexed by PlayerOp
+    std::array<std::function<void(const PlayerCommand&)>, kPlayerOpCount> player_handlers;
+    auto on = [&player_handlers](PlayerOp op, std::function<void(const PlayerCommand&)> fn) {
+        player_handlers[static_cast<size_t>(op)] = std::move(fn);
+    };
+    on(PlayerOp::Load, [&](const PlayerCommand& cmd) {
+        double startSec = static_cast<double>(cmd.int_arg) / 1000.0;
+        LOG_INFO(LOG_MAIN, "playerLoad: %s start=%.1fs", cmd.text.c_str(), startSec);
+        // Parse and set media session metadata
+        ItemJson item;
+        if (!cmd.metadata.empty() && cmd.metadata != "{}") {
+            item = parseItemJson(cmd.metadata);
+            LOG_DEBUG(LOG_MAIN, "metadata: title=%s artist=%s", item.meta.title.c_str(), item.meta.artist.c_str());
+            mediaSessionThread.setMetadata(item.meta);
+        }
+        if (!acquireVideo()) {
+            client->emitError("Failed to load video");
+            return;
+        }
+        MpvPlayer* mpv = video.player();
+        VideoRenderer* videoRenderer = video.renderer();
+        // Apply normalization gain (ReplayGain) if present, else clear any previous gain
+        mpv->setNormalizationGain(item.has_normalization_gain ? item.normalization_gain : 0.0);
+        if (mpv->loadFile(cmd.text, startSec)) {
+            player_state.position_ms = static_cast<double>(cmd.int_arg);
+            player_state.duration_ms = 0.0;
+            player_state.range_count = 0;
+            player_state_dirty = true;
+            has_video = true;
+            videoRenderer->setVisible(true);
+            LOG_INFO(LOG_MAIN, "Video loaded, has_video=true");
+#ifndef __APPLE__
+            videoController.setActive(true);
+            if (videoRenderer->isHdr()) {
+                videoController.requestSetColorspace();
+            }
+#else
+            if (videoRenderer->isHdr()) {
+                videoRenderer->setColorspace();
+            }
+#endif
+            // Apply initial subtitle track if specified
+            if (item.sub_idx >= 0) {
+                mpv->setSubtitleTrack(item.sub_idx);
+            }
+            // Apply initial audio track if specified
+            if (item.audio_idx >= 0) {
+                mpv->setAudioTrack(item.audio_idx);
+            }
+            // mpv events will trigger state callbacks
+        } else {
+            client->emitError("Failed to load video");
+        }
+    });
+    on(PlayerOp::Stop, [&](const PlayerCommand&) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->stop();
+        }
+        player_state.paused = true;
+        player_state_dirty = true;
+        has_video = false;
+        video_ready = false;
+#ifndef __APPLE__
+        videoController.setActive(false);
+        videoController.resetVideoReady();
+#endif
+        if (VideoRenderer* videoRenderer = video.renderer()) {
+            videoRenderer->setVisible(false);
+        }
+        // mpv END_FILE event will trigger finished callback
+    });
+    // mpv pause property change will trigger state callback. Without a video
+    // stack there is nothing to control; volume, mute and speed are kept in
+    // player_state for the next one.
+    on(PlayerOp::Pause, [&](const PlayerCommand&) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->pause();
+        }
+    });
+    on(PlayerOp::Play, [&](const PlayerCommand&) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->play();
+        }
+    });
+    on(PlayerOp::PlayPause, [&](const PlayerCommand&) {
+        MpvPlayer* mpv = video.player();
+        if (!mpv) {
+            return;
+        }
+        if (mpv->isPaused()) {
+            mpv->play();
+        } else {
+            mpv->pause();
+        }
+    });
+    on(PlayerOp::Seek, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->seek(static_cast<double>(cmd.int_arg) / 1000.0);
+        }
+        // Page polls the mirror; show the target until mpv reports from there
+        player_state.position_ms = static_cast<double>(cmd.int_arg);
+        player_state_dirty = true;
+    });
+    on(PlayerOp::Volume, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->setVolume(cmd.int_arg);
+        }
+        player_state.volume = cmd.int_arg;
+        player_state_dirty = true;
+    });
+    on(PlayerOp::Mute, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->setMuted(cmd.int_arg != 0);
+        }
+        player_state.muted = cmd.int_arg != 0;
+        player_state_dirty = true;
+    });
+    on(PlayerOp::Speed, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->setSpeed(cmd.int_arg / 1000.0);
+        }
+        player_state.rate = cmd.int_arg / 1000.0;
+        player_state_dirty = true;
+    });
+    on(PlayerOp::Subtitle, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->setSubtitleTrack(cmd.int_arg);
+        }
+    });
+    on(PlayerOp::Audio, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->setAudioTrack(cmd.int_arg);
+        }
+    });
+    on(PlayerOp::AudioDelay, [&](const PlayerCommand& cmd) {
+        if (MpvPlayer* mpv = video.player()) {
+            mpv->setAudioDelay(cmd.double_arg);
+        }
+    });
+    on(PlayerOp::MediaMetadata, [&](const PlayerCommand& cmd) {
+        MediaMetadata meta = parseItemJson(cmd.text).meta;
+        LOG_DEBUG(LOG_MAIN, "Media metadata: title=%s", meta.title.c_str());
+        mediaSessionThread.setMetadata(meta);
+    });
+    on(PlayerOp::MediaPosition, [&](const PlayerCommand& cmd) {
+        mediaSessionThread.setPosition(static_cast<int64_t>(cmd.int_arg) * 1000);
+    });
+    on(PlayerOp::MediaState, [&](const PlayerCommand& cmd) {
+        mediaSessionThread.setPlaybackState(static_cast<PlaybackState>(cmd.int_arg));
+    });
+    on(PlayerOp::MediaArtwork, [&](const PlayerCommand& cmd) {
+        LOG_DEBUG(LOG_MAIN, "Media artwork received: %.50s...", cmd.text.c_str());
+        mediaSessionThread.setArtwork(cmd.text);
+    });
+    on(PlayerOp::MediaQueue, [&](const PlayerCommand& cmd) {
+        // Decode flags: bit 0 = canNext, bit 1 = canPrev
+        mediaSessionThread.setCanGoNext((cmd.int_arg & 1) != 0);
+        mediaSessionThread.setCanGoPrevious((cmd.int_arg & 2) != 0);
+    });
+    on(PlayerOp::MediaNotifyRate, [&](const PlayerCommand& cmd) {
+        current_playback_rate = cmd.double_arg;
+        mediaSessionThread.setRate(cmd.double_arg);
+    });
+    on(PlayerOp::MediaSeeked, [&](const PlayerCommand& cmd) {
+        // JS detected a seek - emit Seeked signal to media session
+        mediaSessionThread.emitSeeked(static_cast<int64_t>(cmd.int_arg) * 1000);
+    });
+    on(PlayerOp::MediaAction, [&](const PlayerCommand& cmd) {
+        // Route media session control commands to JS playbackManager
+        static const char* const kActionNames[] = {"play", "pause", "play_pause", "stop", "next", "previous"};
+        client->emitHostInput(kActionNames[cmd.int_arg]);
+    });
+    on(PlayerOp::MediaSeek, [&](const PlayerCommand& cmd) {
+        // Route media session seek to JS playbackManager
+        client->emitSeek(cmd.int_arg);
+    });
+    on(PlayerOp::MediaRate, [&](const PlayerCommand& cmd) {
+        // Route media session rate change to JS player
+        client->emitRateChanged(cmd.double_arg);
+    });
+    PlayerCommand player_cmd, next_player_cmd;  // Reused so draining doesn't allocate
+    frame_scheduler.request(FrameScheduler::kResize);  // Render first frame
     while (running && !client->isClosed()) {
         auto frame_start = Clock::now();
         auto now = frame_start;
         bool activity_this_frame = false;
 
-        // Process mpv events from event thread
-        for (const auto& ev : mpvEvents.drain()) {
+        // Process mpv state from event thread: newest position/duration/cache
+        // state only, then discrete events in order
+        TraceSpan mpv_span("main.mpvEvents");
+        FrameTelemetry::Timer mpv_timer(frame_telemetry, FrameTelemetry::kEvents);
+        double mpv_ms;
+        if (mpvEvents.takePosition(mpv_ms)) {
+            mediaSessionThread.setPosition(static_cast<int64_t>(mpv_ms * 1000.0));
+            player_state.position_ms = mpv_ms;
+            player_state_dirty = true;
+        }
+        if (mpvEvents.takeDuration(mpv_ms)) {
+            client->updateDuration(mpv_ms);
+            player_state.duration_ms = mpv_ms;
+            player_state_dirty = true;
+        }
+        if (mpvEvents.takeBufferedRanges(buffered_ranges)) {
+            if (player_state_mirror.isOpen()) {
+                player_state.range_count = std::min(buffered_ranges.count, PlayerStateSnapshot::kMaxRanges);
+                for (int i = 0; i < player_state.range_count; i++) {
+                    player_state.ranges[i] = {buffered_ranges.ranges[i].first, buffered_ranges.ranges[i].second};
+                }
+                player_state_dirty = true;
+            } else {
+                client->updateBufferedRanges(buffered_ranges.ranges, buffered_ranges.count);
+            }
+        }
+        MpvEvent ev;
+        while (mpvEvents.pop(ev)) {
             switch (ev.type) {
-            case MpvEvent::Type::Position:
-                mediaSessionThread.setPosition(static_cast<int64_t>(ev.value * 1000.0));
-                break;
-            case MpvEvent::Type::Duration:
-                client->updateDuration(ev.value);
-                break;
             case MpvEvent::Type::Playing:
+                player_state.paused = false;
+                player_state_dirty = true;
                 client->emitPlaying();
                 mediaSessionThread.setPlaybackState(PlaybackState::Playing);
                 break;
             case MpvEvent::Type::Paused:
-                if (mpv->isPlaying()) {
+                player_state.paused = ev.flag;
+                player_state_dirty = true;
+                if (video.player() && video.player()->isPlaying()) {
                     if (ev.flag) {
                         client->emitPaused();
                         mediaSessionThread.setPlaybackState(PlaybackState::Paused);
@@ -1055,7 +1442,12 @@ int main(int argc, char* argv[]) {
                 videoController.setActive(false);
                 videoController.resetVideoReady();
 #endif
-                videoRenderer.setVisible(false);
+                if (VideoRenderer* videoRenderer = video.renderer()) {
+                    videoRenderer->setVisible(false);
+                }
+                player_state.paused = true;
+                player_state.buffering = false;
+                player_state_dirty = true;
                 client->emitFinished();
                 mediaSessionThread.setPlaybackState(PlaybackState::Stopped);
                 break;
@@ -1067,49 +1459,58 @@ int main(int argc, char* argv[]) {
                 videoController.setActive(false);
                 videoController.resetVideoReady();
 #endif
-                videoRenderer.setVisible(false);
+                if (VideoRenderer* videoRenderer = video.renderer()) {
+                    videoRenderer->setVisible(false);
+                }
+                player_state.paused = true;
+                player_state.buffering = false;
+                player_state_dirty = true;
                 client->emitCanceled();
                 mediaSessionThread.setPlaybackState(PlaybackState::Stopped);
                 break;
             case MpvEvent::Type::Seeked:
+                player_state.position_ms = ev.value;
+                player_state_dirty = true;
                 client->updatePosition(ev.value);
                 mediaSessionThread.setPosition(static_cast<int64_t>(ev.value * 1000.0));
                 mediaSessionThread.setRate(current_playback_rate);
                 mediaSessionThread.emitSeeked(static_cast<int64_t>(ev.value * 1000.0));
                 break;
             case MpvEvent::Type::Buffering:
+                player_state.position_ms = ev.value;
+                player_state.buffering = ev.flag;
+                player_state_dirty = true;
                 mediaSessionThread.setPosition(static_cast<int64_t>(ev.value * 1000.0));
                 mediaSessionThread.setRate(ev.flag ? 0.0 : current_playback_rate);
                 break;
             case MpvEvent::Type::CoreIdle:
+                player_state.position_ms = ev.value;
+                player_state_dirty = true;
                 mediaSessionThread.setPosition(static_cast<int64_t>(ev.value * 1000.0));
                 break;
-            case MpvEvent::Type::BufferedRanges: {
-                std::string json = "[";
-                for (size_t i = 0; i < ev.ranges.size(); i++) {
-                    if (i > 0) json += ",";
-                    json += "{\"start\":" + std::to_string(ev.ranges[i].first) +
-                            ",\"end\":" + std::to_string(ev.ranges[i].second) + "}";
-                }
-                json += "]";
-                client->executeJS("if(window._nativeUpdateBufferedRanges)window._nativeUpdateBufferedRanges(" + json + ");");
-                break;
-            }
             case MpvEvent::Type::Error:
-                LOG_ERROR(LOG_MAIN, "Playback error: %s", ev.error.c_str());
+                LOG_ERROR(LOG_MAIN, "Playback error: %s", ev.error);
                 has_video = false;
                 video_ready = false;
 #ifndef __APPLE__
                 videoController.setActive(false);
                 videoController.resetVideoReady();
 #endif
-                videoRenderer.setVisible(false);
+                if (VideoRenderer* videoRenderer = video.renderer()) {
+                    videoRenderer->setVisible(false);
+                }
+                player_state.paused = true;
+                player_state.buffering = false;
+                player_state_dirty = true;
                 client->emitError(ev.error);
                 mediaSessionThread.setPlaybackState(PlaybackState::Stopped);
                 break;
             }
         }
 
+        mpv_span.end();
+        mpv_timer.end();
+
         if (!focus_set) {
             window_state.notifyFocusGained();
             focus_set = true;
@@ -1117,14 +1518,15 @@ int main(int argc, char* argv[]) {
 
         // Event-driven: wait for events when idle, poll when active
         bool has_pending = browsers.anyHasPendingContent();
-        bool has_pending_cmds = false;
-        {
-            std::lock_guard<std::mutex> lock(cmd_mutex);
-            has_pending_cmds = !pending_cmds.empty();
-        }
+        bool has_pending_cmds = cmd_queue.pending();
         SDL_Event event;
         bool have_event;
-        if (needs_render || has_video || has_pending || has_pending_cmds || !paint_size_matched) {
+        bool busy = frame_scheduler.pending() || has_pending || has_pending_cmds || !paint_size_matched ||
+                    overlay_state == OverlayState::FADING;
+#ifdef __APPLE__
+        busy = busy || has_video;  // Video renders on the main thread
+#endif
+        if (busy) {
             have_event = SDL_PollEvent(&event);
         } else {
 #ifdef __APPLE__
@@ -1134,10 +1536,7 @@ int main(int argc, char* argv[]) {
 
             // Re-check if CEF work generated content
             has_pending = browsers.anyHasPendingContent();
-            {
-                std::lock_guard<std::mutex> lock(cmd_mutex);
-                has_pending_cmds = !pending_cmds.empty();
-            }
+            has_pending_cmds = cmd_queue.pending();
             if (has_pending || has_pending_cmds) {
                 have_event = SDL_PollEvent(&event);
             } else {
@@ -1147,11 +1546,31 @@ int main(int argc, char* argv[]) {
                 have_event = SDL_PollEvent(&event);
             }
 #else
-            // Idle: block until SDL event (input, window, or CEF wake callback)
-            have_event = SDL_WaitEvent(&event);
+            // Idle: block until SDL event (input, window, or CEF/mpv/video wake callback),
+            // but not past the overlay fade delay or the next surface pool trim
+            int wait_ms = -1;
+            if (overlay_state == OverlayState::WAITING) {
+                float remaining = OVERLAY_FADE_DELAY_SEC -
+                    std::chrono::duration<float>(now - overlay_fade_start).count();
+                wait_ms = static_cast<int>(remaining * 1000.0f) + 1;
+            }
+            if (pool_trim_ms >= 0 && (wait_ms < 0 || pool_trim_ms + 1 < wait_ms)) {
+                wait_ms = pool_trim_ms + 1;
+            }
+            if (video_release_ms >= 0 && (wait_ms < 0 || video_release_ms + 1 < wait_ms)) {
+                wait_ms = video_release_ms + 1;
+            }
+            if (wait_ms >= 0) {
+                have_event = SDL_WaitEventTimeout(&event, std::max(1, wait_ms));
+            } else {
+                have_event = SDL_WaitEvent(&event);
+            }
 #endif
         }
 
+        frame_telemetry.woke();
+        TraceSpan events_span("main.sdlEvents");
+        FrameTelemetry::Timer events_timer(frame_telemetry, FrameTelemetry::kEvents);
         while (have_event) {
             switch (event.type) {
             case SDL_EVENT_QUIT:
@@ -1207,6 +1626,12 @@ int main(int argc, char* argv[]) {
 
             case SDL_EVENT_WINDOW_RESTORED:
                 window_state.notifyRestored();
+                rememberWindowGeometry(window);
+                break;
+
+            case SDL_EVENT_WINDOW_MAXIMIZED:
+            case SDL_EVENT_WINDOW_MOVED:
+                rememberWindowGeometry(window);
                 break;
 
 #ifdef __APPLE__
@@ -1236,8 +1661,10 @@ int main(int argc, char* argv[]) {
 
             case SDL_EVENT_WINDOW_RESIZED: {
                 paint_size_matched = false;  // Keep rendering until paint matches new size
+                frame_scheduler.request(FrameScheduler::kResize);
                 current_width = event.window.data1;
                 current_height = event.window.data2;
+                rememberWindowGeometry(window);
 
                 // Get physical dimensions for compositor resize
                 int physical_w, physical_h;
@@ -1247,7 +1674,9 @@ int main(int argc, char* argv[]) {
                 browsers.resizeAll(current_width, current_height, physical_w, physical_h);
 
 #ifdef __APPLE__
-                videoRenderer.resize(physical_w, physical_h);
+                if (VideoRenderer* videoRenderer = video.renderer()) {
+                    videoRenderer->resize(physical_w, physical_h);
+                }
 #elif defined(_WIN32)
                 // Resize WGL context
                 wgl.resize(current_width, current_height);
@@ -1258,7 +1687,9 @@ int main(int argc, char* argv[]) {
 
                 // Resize video layer on render thread (no-op for X11/OpenGL)
                 videoController.requestResize(physical_w, physical_h);
-                videoRenderer.setDestinationSize(current_width, current_height);
+                if (VideoRenderer* videoRenderer = video.renderer()) {
+                    videoRenderer->setDestinationSize(current_width, current_height);
+                }
 
                 // Track resize time for paint matching
                 last_resize_time = Clock::now();
@@ -1267,6 +1698,7 @@ int main(int argc, char* argv[]) {
             }
 
             case SDL_EVENT_WINDOW_DISPLAY_SCALE_CHANGED: {
+                frame_scheduler.request(FrameScheduler::kResize);
                 float new_scale = SDL_GetWindowDisplayScale(window);
 
                 // Resize window to maintain same physical size
@@ -1296,154 +1728,54 @@ int main(int argc, char* argv[]) {
             }
             have_event = SDL_PollEvent(&event);
         }
+        events_span.end();
+        events_timer.end();
 
 #ifdef __APPLE__
         // macOS: Always pump CEF - scheduling controls actual work frequency
-        App::DoWork();
+        {
+            TRACE_SPAN("main.cefWork");
+            App::DoWork();
+        }
 #endif
 
-        // Determine if we need to render this frame
-        needs_render = activity_this_frame || has_video || browsers.anyHasPendingContent() || overlay_state == OverlayState::FADING;
+        if (activity_this_frame) {
+            frame_scheduler.request(FrameScheduler::kInput);
+        }
 
-        // Process player commands
+        // Process player commands. Runs of the same latest-wins command
+        // (scrub seeks, position reports) dispatch only the last one.
         {
-            std::lock_guard<std::mutex> lock(cmd_mutex);
-            for (const auto& cmd : pending_cmds) {
-                if (cmd.cmd == "load") {
-                    double startSec = static_cast<double>(cmd.intArg) / 1000.0;
-                    LOG_INFO(LOG_MAIN, "playerLoad: %s start=%.1fs", cmd.url.c_str(), startSec);
-                    // Parse and set media session metadata
-                    if (!cmd.metadata.empty() && cmd.metadata != "{}") {
-                        MediaMetadata meta = parseMetadataJson(cmd.metadata);
-                        LOG_DEBUG(LOG_MAIN, "metadata: title=%s artist=%s", meta.title.c_str(), meta.artist.c_str());
-                        mediaSessionThread.setMetadata(meta);
-                        // Apply normalization gain (ReplayGain) if present
-                        bool hasGain = false;
-                        double normGain = jsonGetDouble(cmd.metadata, "NormalizationGain", &hasGain);
-                        mpv->setNormalizationGain(hasGain ? normGain : 0.0);
-                    } else {
-                        mpv->setNormalizationGain(0.0);  // Clear any previous gain
-                    }
-                    if (mpv->loadFile(cmd.url, startSec)) {
-                        has_video = true;
-                        videoRenderer.setVisible(true);
-                        LOG_INFO(LOG_MAIN, "Video loaded, has_video=true");
-#ifndef __APPLE__
-                        videoController.setActive(true);
-                        if (videoRenderer.isHdr()) {
-                            videoController.requestSetColorspace();
-                        }
-#else
-                        if (videoRenderer.isHdr()) {
-                            videoRenderer.setColorspace();
-                        }
-#endif
-                        // Apply initial subtitle track if specified
-                        int subIdx = jsonGetIntDefault(cmd.metadata, "_subIdx", -1);
-                        if (subIdx >= 0) {
-                            mpv->setSubtitleTrack(subIdx);
-                        }
-                        // Apply initial audio track if specified
-                        int audioIdx = jsonGetIntDefault(cmd.metadata, "_audioIdx", -1);
-                        if (audioIdx >= 0) {
-                            mpv->setAudioTrack(audioIdx);
-                        }
-                        // mpv events will trigger state callbacks
-                    } else {
-                        client->emitError("Failed to load video");
-                    }
-                } else if (cmd.cmd == "stop") {
-                    mpv->stop();
-                    has_video = false;
-                    video_ready = false;
-#ifndef __APPLE__
-                    videoController.setActive(false);
-                    videoController.resetVideoReady();
-#endif
-                    videoRenderer.setVisible(false);
-                    // mpv END_FILE event will trigger finished callback
-                } else if (cmd.cmd == "pause") {
-                    mpv->pause();
-                    // mpv pause property change will trigger state callback
-                } else if (cmd.cmd == "play") {
-                    mpv->play();
-                    // mpv pause property change will trigger state callback
-                } else if (cmd.cmd == "playpause") {
-                    if (mpv->isPaused()) {
-                        mpv->play();
-                    } else {
-                        mpv->pause();
-                    }
-                    // mpv pause property change will trigger state callback
-                } else if (cmd.cmd == "seek") {
-                    mpv->seek(static_cast<double>(cmd.intArg) / 1000.0);
-                } else if (cmd.cmd == "volume") {
-                    mpv->setVolume(cmd.intArg);
-                } else if (cmd.cmd == "mute") {
-                    mpv->setMuted(cmd.intArg != 0);
-                } else if (cmd.cmd == "speed") {
-                    double speed = cmd.intArg / 1000.0;
-                    mpv->setSpeed(speed);
-                } else if (cmd.cmd == "subtitle") {
-                    mpv->setSubtitleTrack(cmd.intArg);
-                } else if (cmd.cmd == "audio") {
-                    mpv->setAudioTrack(cmd.intArg);
-                } else if (cmd.cmd == "audioDelay") {
-                    if (!cmd.metadata.empty()) {
-                        try {
-                            double delay = std::stod(cmd.metadata);
-                            mpv->setAudioDelay(delay);
-                        } catch (...) {
-                            LOG_WARN(LOG_MAIN, "Invalid audioDelay value: %s", cmd.metadata.c_str());
-                        }
-                    }
-                } else if (cmd.cmd == "media_metadata") {
-                    MediaMetadata meta = parseMetadataJson(cmd.url);
-                    LOG_DEBUG(LOG_MAIN, "Media metadata: title=%s", meta.title.c_str());
-                    mediaSessionThread.setMetadata(meta);
-                } else if (cmd.cmd == "media_position") {
-                    int64_t pos_us = static_cast<int64_t>(cmd.intArg) * 1000;
-                    mediaSessionThread.setPosition(pos_us);
-                } else if (cmd.cmd == "media_state") {
-                    if (cmd.url == "Playing") {
-                        mediaSessionThread.setPlaybackState(PlaybackState::Playing);
-                    } else if (cmd.url == "Paused") {
-                        mediaSessionThread.setPlaybackState(PlaybackState::Paused);
-                    } else {
-                        mediaSessionThread.setPlaybackState(PlaybackState::Stopped);
+            TRACE_SPAN("main.playerCommands");
+            FrameTelemetry::Timer commands_timer(frame_telemetry, FrameTelemetry::kCommands);
+            cmd_queue.clearWake();
+            bool have_cmd = cmd_queue.pop(player_cmd);
+            if (have_cmd) {
+                frame_scheduler.request(FrameScheduler::kCommand);
+            }
+            while (have_cmd) {
+                bool have_next = cmd_queue.pop(next_player_cmd);
+                if (!(have_next && next_player_cmd.op == player_cmd.op && playerOpCoalesces(player_cmd.op))) {
+                    const auto& handler = player_handlers[static_cast<size_t>(player_cmd.op)];
+                    if (handler) {
+                        handler(player_cmd);
                     }
-                } else if (cmd.cmd == "media_artwork") {
-                    LOG_DEBUG(LOG_MAIN, "Media artwork received: %.50s...", cmd.url.c_str());
-                    mediaSessionThread.setArtwork(cmd.url);
-                } else if (cmd.cmd == "media_queue") {
-                    // Decode flags: bit 0 = canNext, bit 1 = canPrev
-                    bool canNext = (cmd.intArg & 1) != 0;
-                    bool canPrev = (cmd.intArg & 2) != 0;
-                    mediaSessionThread.setCanGoNext(canNext);
-                    mediaSessionThread.setCanGoPrevious(canPrev);
-                } else if (cmd.cmd == "media_notify_rate") {
-                    // Rate was encoded as rate * 1000000
-                    double rate = static_cast<double>(cmd.intArg) / 1000000.0;
-                    current_playback_rate = rate;
-                    mediaSessionThread.setRate(rate);
-                } else if (cmd.cmd == "media_seeked") {
-                    // JS detected a seek - emit Seeked signal to media session
-                    int64_t pos_us = static_cast<int64_t>(cmd.intArg) * 1000;
-                    mediaSessionThread.emitSeeked(pos_us);
-                } else if (cmd.cmd == "media_action") {
-                    // Route media session control commands to JS playbackManager
-                    std::string js = "if(window._nativeHostInput) window._nativeHostInput(['" + cmd.url + "']);";
-                    client->executeJS(js);
-                } else if (cmd.cmd == "media_seek") {
-                    // Route media session seek to JS playbackManager
-                    std::string js = "if(window._nativeSeek) window._nativeSeek(" + std::to_string(cmd.intArg) + ");";
-                    client->executeJS(js);
-                } else if (cmd.cmd == "media_rate") {
-                    // Route media session rate change to JS player
-                    client->emitRateChanged(cmd.doubleArg);
                 }
+                std::swap(player_cmd, next_player_cmd);
+                have_cmd = have_next;
             }
-            pending_cmds.clear();
+        }
+
+        // Nothing played for the idle timeout: free mpv, its threads and the
+        // video surface until the next playerLoad
+        if (video.idleExpired(has_video, video_release_ms)) {
+            releaseVideo();
+        }
+
+        // One mirror update per iteration covers mpv state and commands
+        if (player_state_dirty) {
+            player_state_mirror.publish(player_state);
+            player_state_dirty = false;
         }
 
         // Check for pending server URL from overlay
@@ -1511,13 +1843,29 @@ int main(int argc, char* argv[]) {
         // Menu overlay blending
         menu.clearRedraw();
 
+        // Changes made on this thread that need a frame
+        if (overlay_state == OverlayState::FADING) {
+            frame_scheduler.request(FrameScheduler::kAnimation);
+        }
+        if (browsers.anyHasPendingContent()) {
+            frame_scheduler.request(FrameScheduler::kPaint);
+        }
+        if (has_video != video_was_active) {
+            frame_scheduler.request(FrameScheduler::kVideo);  // Clear alpha / video layer changed
+            video_was_active = has_video;
+        }
+        bool frame_drawn = false;
+        TraceSpan render_span("main.render");
+
         // Render video to subsurface/layer
 #ifdef __APPLE__
-        if (has_video) {
-            bool hasFrame = videoRenderer.hasFrame();
+        VideoRenderer* videoRenderer = video.renderer();
+        if (has_video && videoRenderer) {
+            FrameTelemetry::Timer video_timer(frame_telemetry, FrameTelemetry::kComposite);
+            bool hasFrame = videoRenderer->hasFrame();
             static int frame_log_count = 0;
             if (hasFrame) {
-                if (videoRenderer.render(current_width, current_height)) {
+                if (videoRenderer->render(current_width, current_height)) {
                     video_ready = true;
                     if (frame_log_count++ < 5) {
                         LOG_INFO(LOG_MAIN, "Video frame rendered (count=%d)", frame_log_count);
@@ -1527,38 +1875,97 @@ int main(int argc, char* argv[]) {
         }
 
         // Flush and composite all browsers (back-to-front order)
-        browsers.renderAll(current_width, current_height);
+        browsers.flushAll();
+        {
+            FrameTelemetry::Timer composite_timer(frame_telemetry, FrameTelemetry::kComposite);
+            browsers.compositeAll(current_width, current_height);
+        }
+        frame_scheduler.take();
+        frame_drawn = true;
 #elif defined(_WIN32)
-        // Windows: Threaded OpenGL rendering with FBO compositing
-        glViewport(0, 0, current_width, current_height);
-        frameContext.beginFrame(clear_color, videoController.getClearAlpha());
+        // Windows: Threaded OpenGL rendering with FBO compositing, only when something changed
         videoController.render(current_width, current_height);
+        if (frame_scheduler.take()) {
+            glViewport(0, 0, current_width, current_height);
+            browsers.flushAll();
+            FrameTelemetry::Timer composite_timer(frame_telemetry, FrameTelemetry::kComposite);
+            frameContext.beginFrame(clear_color, videoController.getClearAlpha());
+
+            // Composite video texture (from threaded FBO)
+            if (VideoRenderer* videoRenderer = video.renderer()) {
+                videoRenderer->composite(current_width, current_height);
+            }
 
-        // Composite video texture (from threaded FBO)
-        videoRenderer.composite(current_width, current_height);
-
-        // Flush and composite all browsers (back-to-front order)
-        browsers.renderAll(current_width, current_height);
+            // Composite all browsers (back-to-front order)
+            browsers.compositeAll(current_width, current_height);
+            composite_timer.end();
 
-        frameContext.endFrame();
+            FrameTelemetry::Timer swap_timer(frame_telemetry, FrameTelemetry::kSwap);
+            frameContext.endFrame();
+            swap_timer.end();
+            frame_drawn = true;
+        }
 #else
         // Linux: Get physical dimensions for viewport (HiDPI)
         float frame_scale = SDL_GetWindowDisplayScale(window);
         int viewport_w = static_cast<int>(current_width * frame_scale);
         int viewport_h = static_cast<int>(current_height * frame_scale);
-        glViewport(0, 0, viewport_w, viewport_h);
-
-        frameContext.beginFrame(clear_color, videoController.getClearAlpha());
         videoController.render(viewport_w, viewport_h);
 
-        // Composite video texture (for threaded OpenGL renderers like X11)
-        videoRenderer.composite(viewport_w, viewport_h);
+        // Nothing requested a frame: the window already shows the latest state
+        if (frame_scheduler.take()) {
+            glViewport(0, 0, viewport_w, viewport_h);
+
+            // Flush browsers first so the frame only redraws what they changed;
+            // video composited into the window (X11) changes everything
+            browsers.flushAll();
+            frame_damage.clear();
+            browsers.collectDamage(frame_damage);
+            VideoRenderer* videoRenderer = video.renderer();
+            bool video_in_window = videoRenderer && videoRenderer->compositesToWindow();
+            if (video_in_window || video_was_in_window) {
+                frame_damage.setFull();
+            }
+            video_was_in_window = video_in_window;
+            frameContext.setDamage(frame_damage, viewport_w, viewport_h);
 
-        // Flush and composite all browsers (back-to-front order)
-        browsers.renderAll(viewport_w, viewport_h);
+            float clear_alpha = videoController.getClearAlpha();
+            if (frameContext.needsFrame(clear_color, clear_alpha)) {
+                FrameTelemetry::Timer composite_timer(frame_telemetry, FrameTelemetry::kComposite);
+                frameContext.beginFrame(clear_color, clear_alpha);
 
-        frameContext.endFrame();
+                // Composite video texture (for threaded OpenGL renderers like X11)
+                if (videoRenderer) {
+                    videoRenderer->composite(viewport_w, viewport_h);
+                }
+
+                // Composite all browsers (back-to-front order)
+                browsers.compositeAll(viewport_w, viewport_h);
+                composite_timer.end();
+
+                FrameTelemetry::Timer swap_timer(frame_telemetry, FrameTelemetry::kSwap);
+                frameContext.endFrame();
+                swap_timer.end();
+                frame_drawn = true;
+            }
+        }
 #endif
+        render_span.end();
+        if (frame_drawn) {
+            // Every drawn frame flushed the browsers in this iteration
+            const auto& flush = browsers.flushStats();
+            frame_telemetry.add(FrameTelemetry::kPaintFlush, flush.paint_ns);
+            frame_telemetry.add(FrameTelemetry::kImport, flush.import_ns);
+            frame_telemetry.addUploaded(flush.uploaded_bytes);
+        }
+        frame_telemetry.endIteration(frame_drawn);
+        frame_scheduler.noteIteration(frame_drawn);
+        frame_scheduler.logStats();
+#ifndef __APPLE__
+        // Free texture/PBO storage left idle since the last resize settled
+        pool_trim_ms = OpenGLCompositor::trimSurfacePool();
+#endif
+
         // Log slow frames
         auto frame_end = Clock::now();
         auto frame_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start).count();
@@ -1574,18 +1981,27 @@ int main(int argc, char* argv[]) {
 #ifdef __APPLE__
     SDL_RemoveEventWatch(liveResizeCallback, &live_resize_ctx);
 #endif
-    mediaSessionThread.stop();
-#ifndef __APPLE__
-    videoController.stop();
+#ifndef _WIN32
+    SignalWatcher::stop();
+    ControlSocket::stop();
 #endif
-    mpvEvents.stop();
-    mpv->cleanup();
+    frame_telemetry.logSummary();
+    // Finish a running trace while CEF can still hand over Chromium's part
+    trace_session.stop();
+    auto trace_deadline = Clock::now() + std::chrono::seconds(5);
+    while (trace_session.busy() && Clock::now() < trace_deadline) {
+#ifdef __APPLE__
+        App::DoWork();
+#endif
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    Settings::instance().flush();
+    mediaSessionThread.stop();
+    releaseVideo();
 
 #ifdef __APPLE__
     // macOS: simpler cleanup - CefShutdown handles browser cleanup
     browsers.cleanupCompositors();
-    videoRenderer.cleanup();
-    VideoStack::cleanupStatics();
     CefShutdown();
 #else
     // Windows/Linux: wait for async browser close before cleanup
@@ -1594,8 +2010,6 @@ int main(int argc, char* argv[]) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     browsers.cleanupCompositors();
-    videoRenderer.cleanup();
-    VideoStack::cleanupStatics();
 #ifdef _WIN32
     wgl.cleanup();
 #else
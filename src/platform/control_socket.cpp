@@ -0,0 +1,137 @@
+#include "platform/control_socket.h"
+#include "logging.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+int g_listen = -1;
+int g_wake[2] = {-1, -1};
+std::string g_path;
+std::thread g_thread;
+
+void sendAll(int fd, const std::string& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+#else
+        ssize_t n = send(fd, data.data() + off, data.size() - off, 0);
+#endif
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;  // Client went away or stalled past the timeout
+        off += static_cast<size_t>(n);
+    }
+}
+
+void threadFunc(std::function<std::string()> reply) {
+    pollfd fds[2] = {{g_listen, POLLIN, 0}, {g_wake[0], POLLIN, 0}};
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG_WARN(LOG_PLATFORM, "ControlSocket: poll failed: %s", strerror(errno));
+            break;
+        }
+        if (fds[1].revents) break;  // stop()
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        int client = accept(g_listen, nullptr, nullptr);
+        if (client < 0) continue;
+        fcntl(client, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+        int one = 1;
+        setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        // A client that never reads must not wedge the thread
+        timeval timeout{1, 0};
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        sendAll(client, reply());
+        close(client);
+    }
+}
+
+}  // namespace
+
+bool ControlSocket::start(const std::string& path, std::function<std::string()> reply) {
+    if (g_listen >= 0) return false;
+
+    sockaddr_un addr{};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        LOG_WARN(LOG_PLATFORM, "ControlSocket: bad socket path '%s'", path.c_str());
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // Only ever replace a socket, never some other file at that path
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            LOG_WARN(LOG_PLATFORM, "ControlSocket: %s exists and is not a socket", path.c_str());
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG_WARN(LOG_PLATFORM, "ControlSocket: socket failed: %s", strerror(errno));
+        return false;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        LOG_WARN(LOG_PLATFORM, "ControlSocket: bind %s failed: %s", path.c_str(), strerror(errno));
+        close(fd);
+        return false;
+    }
+    // Owner only (umask is process-wide and other threads create files, so
+    // chmod instead; the default location is a 0700 directory anyway)
+    if (chmod(path.c_str(), 0600) != 0 || listen(fd, 4) != 0) {
+        LOG_WARN(LOG_PLATFORM, "ControlSocket: setup of %s failed: %s", path.c_str(), strerror(errno));
+        close(fd);
+        unlink(path.c_str());
+        return false;
+    }
+    if (pipe(g_wake) != 0) {
+        LOG_WARN(LOG_PLATFORM, "ControlSocket: pipe failed: %s", strerror(errno));
+        close(fd);
+        unlink(path.c_str());
+        return false;
+    }
+    for (int wake_fd : g_wake) fcntl(wake_fd, F_SETFD, FD_CLOEXEC);
+
+    g_listen = fd;
+    g_path = path;
+    g_thread = std::thread(threadFunc, std::move(reply));
+    LOG_INFO(LOG_PLATFORM, "Control socket: %s", path.c_str());
+    return true;
+}
+
+void ControlSocket::stop() {
+    if (g_listen < 0) return;
+    unsigned char byte = 0;
+    [[maybe_unused]] auto _ = write(g_wake[1], &byte, 1);
+    if (g_thread.joinable()) g_thread.join();
+    close(g_listen);
+    close(g_wake[0]);
+    close(g_wake[1]);
+    g_listen = g_wake[0] = g_wake[1] = -1;
+    unlink(g_path.c_str());
+    g_path.clear();
+}
+
+std::string ControlSocket::defaultPath() {
+    const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (!runtime_dir || !*runtime_dir) return {};
+    return std::string(runtime_dir) + "/jellyfin-desktop-" + std::to_string(getpid()) + ".sock";
+}
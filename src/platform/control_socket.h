@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+// Local UNIX stream socket for inspecting a running instance (POSIX only).
+// Every connection is answered with the reply callback's output and closed;
+// nothing is read from the client, so `socat - UNIX-CONNECT:<path>` or
+// `nc -U <path>` is a complete client. Runs on its own thread.
+class ControlSocket {
+public:
+    // Bind path (mode 0600; a stale socket there is replaced) and start
+    // serving. reply runs on the socket thread.
+    static bool start(const std::string& path, std::function<std::string()> reply);
+    // Join the thread and unlink the socket
+    static void stop();
+
+    // $XDG_RUNTIME_DIR/jellyfin-desktop-<pid>.sock, empty without XDG_RUNTIME_DIR
+    static std::string defaultPath();
+};
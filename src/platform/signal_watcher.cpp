@@ -0,0 +1,91 @@
+#include "platform/signal_watcher.h"
+#include "logging.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+int g_pipe[2] = {-1, -1};
+std::thread g_thread;
+std::mutex g_mutex;  // Guards g_callbacks
+std::map<int, std::function<void()>> g_callbacks;
+
+void onSignal(int signo) {
+    // Async-signal-safe: a single write
+    int saved_errno = errno;
+    unsigned char byte = static_cast<unsigned char>(signo);
+    [[maybe_unused]] auto _ = write(g_pipe[1], &byte, 1);
+    errno = saved_errno;
+}
+
+void threadFunc() {
+    unsigned char byte;
+    while (true) {
+        ssize_t n = read(g_pipe[0], &byte, 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0 || byte == 0) break;  // 0 = stop()
+
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            auto it = g_callbacks.find(byte);
+            if (it != g_callbacks.end()) callback = it->second;
+        }
+        if (callback) callback();
+    }
+}
+
+}  // namespace
+
+bool SignalWatcher::watch(int signo, std::function<void()> callback) {
+    if (signo <= 0 || signo > 255) return false;
+    if (g_pipe[0] < 0) {
+        if (pipe(g_pipe) != 0) {
+            LOG_WARN(LOG_PLATFORM, "SignalWatcher: pipe failed: %s", strerror(errno));
+            return false;
+        }
+        for (int fd : g_pipe) fcntl(fd, F_SETFD, FD_CLOEXEC);
+        // A burst of signals must never block the handler
+        fcntl(g_pipe[1], F_SETFL, fcntl(g_pipe[1], F_GETFL) | O_NONBLOCK);
+        g_thread = std::thread(threadFunc);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_callbacks[signo] = std::move(callback);
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = onSignal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(signo, &sa, nullptr) != 0) {
+        LOG_WARN(LOG_PLATFORM, "SignalWatcher: sigaction(%d) failed: %s", signo, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void SignalWatcher::stop() {
+    if (g_pipe[0] < 0) return;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (const auto& entry : g_callbacks) {
+            signal(entry.first, SIG_DFL);
+        }
+        g_callbacks.clear();
+    }
+    unsigned char stop_byte = 0;
+    [[maybe_unused]] auto _ = write(g_pipe[1], &stop_byte, 1);
+    if (g_thread.joinable()) g_thread.join();
+    close(g_pipe[0]);
+    close(g_pipe[1]);
+    g_pipe[0] = g_pipe[1] = -1;
+}
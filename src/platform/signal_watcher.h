@@ -0,0 +1,14 @@
+#pragma once
+
+#include <functional>
+
+// Runs callbacks for POSIX signals (SIGUSR1, SIGUSR2, ...) on a watcher
+// thread instead of inside the signal handler, so they can lock, allocate
+// and log. The handler only writes the signal number to a pipe.
+class SignalWatcher {
+public:
+    // Install a handler for signo; the first call starts the thread
+    static bool watch(int signo, std::function<void()> callback);
+    // Restore default handlers and join the thread
+    static void stop();
+};
@@ -238,6 +238,26 @@ bool WaylandSubsurface::init(SDL_Window* window, VkInstance, VkPhysicalDevice,
         }
     }
 
+    // Present pacing: needs both extensions and both features
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    has_present_wait_ = false;
+    if (hasExtension(VK_KHR_PRESENT_ID_EXTENSION_NAME) && hasExtension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        VkPhysicalDeviceFeatures2 query{};
+        query.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        query.pNext = &presentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(physical_device_, &query);
+        has_present_wait_ = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+    if (has_present_wait_) {
+        enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        LOG_INFO(LOG_PLATFORM, "Enabled present_id/present_wait frame pacing");
+    }
+
     // Find graphics queue family
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queueFamilyCount, nullptr);
@@ -273,6 +293,13 @@ bool WaylandSubsurface::init(SDL_Window* window, VkInstance, VkPhysicalDevice,
     features2_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
     features2_.pNext = &vk12_features_;
 
+    // Present features go on the device only; features2_ is handed to mpv
+    if (has_present_wait_) {
+        presentIdFeatures.presentId = VK_TRUE;
+        presentWaitFeatures.presentWait = VK_TRUE;
+        vk11_features_.pNext = &presentIdFeatures;
+    }
+
     VkDeviceCreateInfo deviceInfo{};
     deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceInfo.pNext = &features2_;
@@ -282,6 +309,7 @@ bool WaylandSubsurface::init(SDL_Window* window, VkInstance, VkPhysicalDevice,
     deviceInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     VkResult deviceResult = vkCreateDevice(physical_device_, &deviceInfo, nullptr, &device_);
+    vk11_features_.pNext = nullptr;
     if (deviceResult != VK_SUCCESS) {
         LOG_ERROR(LOG_PLATFORM, "Failed to create Vulkan device: VkResult=%d", deviceResult);
         return false;
@@ -289,6 +317,12 @@ bool WaylandSubsurface::init(SDL_Window* window, VkInstance, VkPhysicalDevice,
 
     vkGetDeviceQueue(device_, queue_family_, 0, &queue_);
 
+    if (has_present_wait_) {
+        vkWaitForPresentKHR_ = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+            vkGetDeviceProcAddr(device_, "vkWaitForPresentKHR"));
+        has_present_wait_ = vkWaitForPresentKHR_ != nullptr;
+    }
+
     // Create VkSurface for our wl_surface
     VkWaylandSurfaceCreateInfoKHR surfaceInfo{};
     surfaceInfo.sType = VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR;
@@ -357,11 +391,29 @@ bool WaylandSubsurface::createSwapchain(int width, int height) {
 
     swapchain_extent_ = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
 
+    // Present mode: requested one if the surface offers it, else FIFO
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device_, vk_surface_, &modeCount, nullptr);
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physical_device_, vk_surface_, &modeCount, modes.data());
+    present_mode_ = VK_PRESENT_MODE_FIFO_KHR;
+    if (std::find(modes.begin(), modes.end(), requested_present_mode_) != modes.end()) {
+        present_mode_ = requested_present_mode_;
+    } else {
+        LOG_WARN(LOG_PLATFORM, "Present mode %d not supported, using FIFO", requested_present_mode_);
+    }
+
+    // One image on screen, one queued, plus one per frame in flight; mailbox
+    // needs a spare so the render thread never waits on the display
+    uint32_t imageCount = std::max(caps.minImageCount + 1, kFramesInFlight + 1);
+    if (present_mode_ == VK_PRESENT_MODE_MAILBOX_KHR) imageCount++;
+    if (caps.maxImageCount > 0) imageCount = std::min(imageCount, caps.maxImageCount);
+
     // Create swapchain
     VkSwapchainCreateInfoKHR swapInfo{};
     swapInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
     swapInfo.surface = vk_surface_;
-    swapInfo.minImageCount = caps.minImageCount + 1;
+    swapInfo.minImageCount = imageCount;
     swapInfo.imageFormat = swapchain_format_;
     swapInfo.imageColorSpace = color_space_;
     swapInfo.imageExtent = swapchain_extent_;
@@ -369,7 +421,7 @@ bool WaylandSubsurface::createSwapchain(int width, int height) {
     swapInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
     swapInfo.preTransform = caps.currentTransform;
     swapInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    swapInfo.presentMode = present_mode_;
     swapInfo.clipped = VK_TRUE;
 
     if (vkCreateSwapchainKHR(device_, &swapInfo, nullptr, &swapchain_) != VK_SUCCESS) {
@@ -378,7 +430,7 @@ bool WaylandSubsurface::createSwapchain(int width, int height) {
     }
 
     // Get swapchain images
-    uint32_t imageCount = 0;
+    imageCount = 0;
     vkGetSwapchainImagesKHR(device_, swapchain_, &imageCount, nullptr);
     swapchain_images_.resize(imageCount);
     vkGetSwapchainImagesKHR(device_, swapchain_, &imageCount, swapchain_images_.data());
@@ -398,14 +450,23 @@ bool WaylandSubsurface::createSwapchain(int width, int height) {
     // Create sync objects
     VkSemaphoreCreateInfo semInfo{};
     semInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    vkCreateSemaphore(device_, &semInfo, nullptr, &image_available_);
+    render_done_.resize(imageCount);
+    for (uint32_t i = 0; i < imageCount; i++) {
+        vkCreateSemaphore(device_, &semInfo, nullptr, &render_done_[i]);
+    }
 
     VkFenceCreateInfo fenceInfo{};
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    vkCreateFence(device_, &fenceInfo, nullptr, &acquire_fence_);
+    for (auto& fence : acquire_fences_) {
+        vkCreateFence(device_, &fenceInfo, nullptr, &fence);
+    }
+    frame_index_ = 0;
+    acquire_pending_ = false;
+    present_id_ = 0;
 
-    LOG_INFO(LOG_PLATFORM, "Swapchain: %dx%d format=%d colorSpace=%d HDR=%s",
-             width, height, swapchain_format_, color_space_, is_hdr_ ? "yes" : "no");
+    LOG_INFO(LOG_PLATFORM, "Swapchain: %dx%d format=%d colorSpace=%d HDR=%s images=%u presentMode=%d",
+             width, height, swapchain_format_, color_space_, is_hdr_ ? "yes" : "no",
+             imageCount, present_mode_);
 
     return true;
 }
@@ -479,20 +540,47 @@ void WaylandSubsurface::setColorspace() {
     LOG_INFO(LOG_PLATFORM, "Set Wayland surface colorspace to PQ/BT.2020");
 }
 
+VkResult WaylandSubsurface::acquireImage(uint64_t timeout) {
+    VkFence fence = acquire_fences_[frame_index_];
+    vkResetFences(device_, 1, &fence);
+    VkResult result = vkAcquireNextImageKHR(device_, swapchain_, timeout,
+                                            VK_NULL_HANDLE, fence, &current_image_idx_);
+    acquire_pending_ = result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR;
+    return result;
+}
+
+void WaylandSubsurface::waitForPresent() {
+    // Keep at most kFramesInFlight presents queued: wait for the oldest one to
+    // reach the screen instead of stalling in acquire
+    if (!has_present_wait_ || present_id_ < kFramesInFlight) return;
+    VkResult result = vkWaitForPresentKHR_(device_, swapchain_, present_id_ - kFramesInFlight + 1,
+                                           100000000);
+    if (result != VK_SUCCESS && result != VK_TIMEOUT && result != VK_SUBOPTIMAL_KHR) {
+        LOG_WARN(LOG_PLATFORM, "vkWaitForPresentKHR failed (%d), disabling present pacing", result);
+        has_present_wait_ = false;
+    }
+}
+
 bool WaylandSubsurface::startFrame(VkImage* outImage, VkImageView* outView, VkFormat* outFormat) {
     if (!swapchain_) return false;
 
-    // Acquire next image with fence
-    vkResetFences(device_, 1, &acquire_fence_);
-    VkResult result = vkAcquireNextImageKHR(device_, swapchain_, 100000000,
-                                            VK_NULL_HANDLE, acquire_fence_, &current_image_idx_);
-    if (result == VK_TIMEOUT || result == VK_NOT_READY) {
-        return false;
+    waitForPresent();
+
+    // Normally the image was acquired right after the previous present
+    if (!acquire_pending_) {
+        VkResult result = acquireImage(100000000);
+        if (!acquire_pending_) {
+            if (result != VK_TIMEOUT && result != VK_NOT_READY) {
+                LOG_DEBUG(LOG_PLATFORM, "vkAcquireNextImageKHR failed: %d", result);
+            }
+            return false;
+        }
     }
-    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-        return false;
+    VkFence fence = acquire_fences_[frame_index_];
+    if (vkWaitForFences(device_, 1, &fence, VK_TRUE, 100000000) != VK_SUCCESS) {
+        return false;  // Still held by the display; retry with the same image next frame
     }
-    vkWaitForFences(device_, 1, &acquire_fence_, VK_TRUE, UINT64_MAX);
+    acquire_pending_ = false;
 
     frame_active_ = true;
     *outImage = swapchain_images_[current_image_idx_];
@@ -504,14 +592,33 @@ bool WaylandSubsurface::startFrame(VkImage* outImage, VkImageView* outView, VkFo
 void WaylandSubsurface::submitFrame() {
     if (!frame_active_ || !swapchain_) return;
 
+    // mpv has submitted its work; a semaphore signal orders everything before
+    // it on the queue, so present waits on that instead of the CPU
+    VkSemaphore renderDone = render_done_[current_image_idx_];
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &renderDone;
+    vkQueueSubmit(queue_, 1, &submitInfo, VK_NULL_HANDLE);
+
     // Present
+    uint64_t presentId = present_id_ + 1;
+    VkPresentIdKHR presentIdInfo{};
+    presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+    presentIdInfo.swapchainCount = 1;
+    presentIdInfo.pPresentIds = &presentId;
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.pNext = has_present_wait_ ? &presentIdInfo : nullptr;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &renderDone;
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &swapchain_;
     presentInfo.pImageIndices = &current_image_idx_;
 
-    vkQueuePresentKHR(queue_, &presentInfo);
+    VkResult result = vkQueuePresentKHR(queue_, &presentInfo);
+    if (has_present_wait_) present_id_ = presentId;
 
     // Commit surface
     wl_surface_commit(mpv_surface_);
@@ -519,6 +626,13 @@ void WaylandSubsurface::submitFrame() {
 
     visible_ = true;
     frame_active_ = false;
+
+    // Acquire the next image now without blocking; its fence is waited on in
+    // startFrame, by which time the display has usually released it
+    frame_index_ = (frame_index_ + 1) % kFramesInFlight;
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+        acquireImage(0);
+    }
 }
 
 bool WaylandSubsurface::recreateSwapchain(int width, int height) {
@@ -531,14 +645,21 @@ void WaylandSubsurface::destroySwapchain() {
 
     vkDeviceWaitIdle(device_);
 
-    if (acquire_fence_) {
-        vkDestroyFence(device_, acquire_fence_, nullptr);
-        acquire_fence_ = VK_NULL_HANDLE;
+    // A fence from an acquire-ahead is signaled by the display, not the queue
+    if (acquire_pending_) {
+        vkWaitForFences(device_, 1, &acquire_fences_[frame_index_], VK_TRUE, 100000000);
+        acquire_pending_ = false;
+    }
+    for (auto& fence : acquire_fences_) {
+        if (fence) {
+            vkDestroyFence(device_, fence, nullptr);
+            fence = VK_NULL_HANDLE;
+        }
     }
-    if (image_available_) {
-        vkDestroySemaphore(device_, image_available_, nullptr);
-        image_available_ = VK_NULL_HANDLE;
+    for (auto sem : render_done_) {
+        vkDestroySemaphore(device_, sem, nullptr);
     }
+    render_done_.clear();
 
     for (auto view : swapchain_views_) {
         vkDestroyImageView(device_, view, nullptr);
@@ -12,6 +12,9 @@ struct SDL_Window;
 
 class WaylandSubsurface : public VideoSurface {
 public:
+    // Frames the render thread may queue ahead of the presentation engine
+    static constexpr uint32_t kFramesInFlight = 2;
+
     WaylandSubsurface();
     ~WaylandSubsurface() override;
 
@@ -52,6 +55,10 @@ public:
     void setVisible(bool visible) override;
     void setDestinationSize(int width, int height) override;
 
+    // Requested present mode (call before createSwapchain). Falls back to FIFO,
+    // which every driver supports, if the surface doesn't offer it.
+    void setPresentMode(VkPresentModeKHR mode) { requested_present_mode_ = mode; }
+
     // Wayland registry callbacks (public for C callback struct)
     static void registryGlobal(void* data, wl_registry* registry,
                                uint32_t name, const char* interface, uint32_t version);
@@ -62,6 +69,8 @@ private:
     bool createSubsurface(wl_surface* parentSurface);
     bool initColorManagement();
     void destroySwapchain();
+    VkResult acquireImage(uint64_t timeout);
+    void waitForPresent();
 
     // Wayland
     wl_display* wl_display_ = nullptr;
@@ -92,6 +101,11 @@ private:
     VkPhysicalDeviceVulkan12Features vk12_features_{};
     VkPhysicalDeviceFeatures2 features2_{};
 
+    // Present pacing (VK_KHR_present_id + VK_KHR_present_wait, optional)
+    bool has_present_wait_ = false;
+    PFN_vkWaitForPresentKHR vkWaitForPresentKHR_ = nullptr;
+    uint64_t present_id_ = 0;  // Last id queued on the current swapchain
+
     // Swapchain
     VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
     VkFormat swapchain_format_ = VK_FORMAT_R16G16B16A16_UNORM;
@@ -100,8 +114,17 @@ private:
     bool is_hdr_ = false;
     std::vector<VkImage> swapchain_images_;
     std::vector<VkImageView> swapchain_views_;
-    VkSemaphore image_available_ = VK_NULL_HANDLE;
-    VkFence acquire_fence_ = VK_NULL_HANDLE;
+    VkPresentModeKHR requested_present_mode_ = VK_PRESENT_MODE_FIFO_KHR;
+    VkPresentModeKHR present_mode_ = VK_PRESENT_MODE_FIFO_KHR;
+
+    // Acquire fences per frame in flight; mpv's render API can't wait on a
+    // semaphore, so acquisition is CPU-side. The next image is acquired right
+    // after present and only waited on when the next frame starts.
+    VkFence acquire_fences_[kFramesInFlight] = {};
+    uint32_t frame_index_ = 0;
+    bool acquire_pending_ = false;   // acquire_fences_[frame_index_] guards current_image_idx_
+    // Per swapchain image: signaled after mpv's work, waited on by present
+    std::vector<VkSemaphore> render_done_;
     uint32_t current_image_idx_ = 0;
     bool frame_active_ = false;
     bool visible_ = false;
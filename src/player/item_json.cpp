@@ -0,0 +1,54 @@
+#include "player/item_json.h"
+#include "json_reader.h"
+#include "logging.h"
+
+ItemJson parseItemJson(const std::string& json) {
+    ItemJson item;
+    std::string series_name, season_name, album, first_artist, type;
+    JsonReader reader(json);
+    std::string_view key;
+    JsonValue value;
+    while (reader.nextMember(key, value)) {
+        if (key == "Name") {
+            item.meta.title = value.str();
+        } else if (key == "SeriesName") {
+            series_name = value.str();
+        } else if (key == "Artists" && value.type == JsonValue::Type::Array) {
+            JsonReader artists(value.raw);
+            JsonValue artist;
+            if (artists.nextElement(artist)) first_artist = artist.str();
+        } else if (key == "SeasonName") {
+            season_name = value.str();
+        } else if (key == "Album") {
+            album = value.str();
+        } else if (key == "IndexNumber") {
+            item.meta.track_number = static_cast<int>(value.toInt());
+        } else if (key == "RunTimeTicks") {
+            // 100ns units, convert to microseconds
+            item.meta.duration_us = value.toInt() / 10;
+        } else if (key == "Type") {
+            type = value.str();
+        } else if (key == "NormalizationGain" && value.isNumber()) {
+            item.has_normalization_gain = true;
+            item.normalization_gain = value.toDouble();
+        } else if (key == "_audioIdx") {
+            item.audio_idx = static_cast<int>(value.toInt(-1));
+        } else if (key == "_subIdx") {
+            item.sub_idx = static_cast<int>(value.toInt(-1));
+        }
+    }
+    if (reader.failed()) {
+        LOG_WARN(LOG_MAIN, "Item JSON malformed, using fields read so far");
+    }
+    // For episodes, use SeriesName as artist; for audio, use Artists array
+    item.meta.artist = !series_name.empty() ? series_name : first_artist;
+    // For episodes, use SeasonName as album; for audio, use Album
+    item.meta.album = !season_name.empty() ? season_name : album;
+    // Detect media type from Type field
+    if (type == "Audio") {
+        item.meta.media_type = MediaType::Audio;
+    } else if (type == "Movie" || type == "Episode" || type == "Video" || type == "MusicVideo") {
+        item.meta.media_type = MediaType::Video;
+    }
+    return item;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "player/media_session.h"
+#include <string>
+
+// Fields the player uses from a Jellyfin item JSON (plus the _audioIdx and
+// _subIdx the renderer prepends)
+struct ItemJson {
+    MediaMetadata meta;
+    bool has_normalization_gain = false;
+    double normalization_gain = 0.0;
+    int audio_idx = -1;
+    int sub_idx = -1;
+};
+
+// One pass over the item's top-level members; keys inside nested objects
+// (MediaStreams, People, ...) are skipped, never matched
+ItemJson parseItemJson(const std::string& json);
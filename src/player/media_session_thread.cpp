@@ -1,5 +1,6 @@
 #include "media_session_thread.h"
 #include "logging.h"
+#include "trace.h"
 #include <chrono>
 
 #if !defined(_WIN32) && !defined(__APPLE__)
@@ -123,6 +124,7 @@ void MediaSessionThread::setCanGoPrevious(bool can) {
 }
 
 void MediaSessionThread::threadFunc() {
+    TraceRecorder::setThreadName("Media session");
 #if !defined(_WIN32) && !defined(__APPLE__)
     // Linux: fully event-driven with poll() on D-Bus fd + eventfd
     int dbus_fd = session_->getFd();
@@ -135,6 +137,7 @@ void MediaSessionThread::threadFunc() {
             work.swap(queue_);
         }
 
+        TraceSpan commands_span("media.commands");
         while (!work.empty()) {
             const auto& cmd = work.front();
             switch (cmd.type) {
@@ -165,6 +168,7 @@ void MediaSessionThread::threadFunc() {
             }
             work.pop();
         }
+        commands_span.end();
 
         // Poll on D-Bus fd and eventfd
         struct pollfd fds[2];
@@ -194,7 +198,10 @@ void MediaSessionThread::threadFunc() {
         }
 
         // Process any incoming D-Bus messages
-        session_->update();
+        {
+            TRACE_SPAN("media.update");
+            session_->update();
+        }
     }
 #else
     // macOS/Windows: CV-based with timeout for incoming message check
@@ -206,6 +213,7 @@ void MediaSessionThread::threadFunc() {
             work.swap(queue_);
         }
 
+        TraceSpan commands_span("media.commands");
         while (!work.empty()) {
             const auto& cmd = work.front();
             switch (cmd.type) {
@@ -236,9 +244,13 @@ void MediaSessionThread::threadFunc() {
             }
             work.pop();
         }
+        commands_span.end();
 
         // Check for incoming messages
-        session_->update();
+        {
+            TRACE_SPAN("media.update");
+            session_->update();
+        }
 
         // Wait for command or timeout
         std::unique_lock lock(mutex_);
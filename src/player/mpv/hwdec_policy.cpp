@@ -0,0 +1,112 @@
+#include "player/mpv/hwdec_policy.h"
+#include "logging.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <sstream>
+
+static std::vector<HwdecPolicy::Rule> s_default_rules;
+
+static bool matches(const std::string& pattern, const std::string& value) {
+    return pattern.empty() || pattern == value;
+}
+
+bool HwdecPolicy::parseRules(const std::string& spec, std::vector<Rule>& out) {
+    std::vector<Rule> rules;
+    std::stringstream entries(spec);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        std::vector<std::string> fields;
+        std::stringstream parts(entry);
+        std::string field;
+        while (std::getline(parts, field, ':')) {
+            fields.push_back(field == "*" ? "" : field);
+        }
+        if (fields.empty() || fields.size() > 5) return false;
+
+        Rule rule;
+        if (fields[0] == "allow") {
+            rule.allow = true;
+        } else if (fields[0] == "deny") {
+            rule.allow = false;
+        } else {
+            return false;
+        }
+        if (fields.size() > 1) rule.interop = fields[1];
+        if (fields.size() > 2) rule.codec = fields[2];
+        if (fields.size() > 3) rule.profile = fields[3];
+        if (fields.size() > 4 && !fields[4].empty()) {
+            char* end = nullptr;
+            long depth = std::strtol(fields[4].c_str(), &end, 10);
+            if (*end || depth <= 0) return false;
+            rule.bit_depth = static_cast<int>(depth);
+        }
+        rules.push_back(rule);
+    }
+    out = std::move(rules);
+    return true;
+}
+
+void HwdecPolicy::setDefaultRules(std::vector<Rule> rules) {
+    s_default_rules = std::move(rules);
+}
+
+// After the configured rules, so any of them can override these. High bit
+// depth hwdec output (p010/p012) doesn't render correctly through the
+// Vulkan path yet; software decode was forced for it before this policy.
+static const HwdecPolicy::Rule kBuiltinRules[] = {
+    {false, "", "", "", 10},
+    {false, "", "", "", 12},
+};
+
+HwdecPolicy::HwdecPolicy(HwdecCapabilities caps)
+    : caps_(std::move(caps)), rules_(s_default_rules) {
+    rules_.insert(rules_.end(), std::begin(kBuiltinRules), std::end(kBuiltinRules));
+}
+
+std::string HwdecPolicy::key(const std::string& interop, const HwdecStream& stream) {
+    return interop + "|" + stream.codec + "|" + stream.profile + "|" + std::to_string(stream.bit_depth);
+}
+
+bool HwdecPolicy::allowed(const HwdecCapabilities::Interop& interop, const HwdecStream& stream) const {
+    if (!interop.codecs.empty() &&
+        std::find(interop.codecs.begin(), interop.codecs.end(), stream.codec) == interop.codecs.end()) {
+        return false;
+    }
+    if (failed_.count(key(interop.name, stream))) return false;
+
+    for (const auto& rule : rules_) {
+        if (matches(rule.interop, interop.name) && matches(rule.codec, stream.codec) &&
+            matches(rule.profile, stream.profile) &&
+            (rule.bit_depth == 0 || rule.bit_depth == stream.bit_depth)) {
+            return rule.allow;
+        }
+    }
+    return true;
+}
+
+std::string HwdecPolicy::select(const HwdecStream& stream) const {
+    std::string hwdec;
+    for (const auto& interop : caps_.interops) {
+        if (!allowed(interop, stream)) continue;
+        if (!hwdec.empty()) hwdec += ",";
+        hwdec += interop.name;
+    }
+    return hwdec.empty() ? "no" : hwdec;
+}
+
+bool HwdecPolicy::recordOutcome(const HwdecStream& stream, const std::string& requested,
+                                const std::string& current) {
+    if (requested == "no" || current != "no") return false;
+
+    // Every interop offered for this stream failed; mpv is decoding in software
+    std::stringstream names(requested);
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        failed_.insert(key(name, stream));
+    }
+    LOG_WARN(LOG_MPV, "hwdec %s failed for %s (%s, %d-bit), not offering it again this session",
+             requested.c_str(), stream.codec.c_str(),
+             stream.profile.empty() ? "no profile" : stream.profile.c_str(), stream.bit_depth);
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+// Decoder-relevant properties of a video stream
+struct HwdecStream {
+    std::string codec;     // mpv codec name ("hevc", "av1", "h264", ...)
+    std::string profile;   // Codec profile ("Main 10", ...); may be empty
+    int bit_depth = 8;
+};
+
+// Hardware decode paths usable with the player's render device, as found by
+// a probe at startup. Built by hand to exercise the policy without a GPU.
+struct HwdecCapabilities {
+    struct Interop {
+        std::string name;                 // mpv hwdec name ("vulkan", "vaapi")
+        std::vector<std::string> codecs;  // Codecs it can decode; empty = any
+    };
+    std::vector<Interop> interops;        // In preference order
+};
+
+// Chooses mpv's hwdec value per stream from the probed interops, an ordered
+// allow/deny rule list and the outcomes seen so far this session. An interop
+// that fails for a stream class (falls back to software) is not offered for
+// that class again.
+class HwdecPolicy {
+public:
+    // Fields left empty ("*" in the spec) or 0 match anything
+    struct Rule {
+        bool allow = true;
+        std::string interop;
+        std::string codec;
+        std::string profile;
+        int bit_depth = 0;
+    };
+
+    // Parse "allow|deny[:interop[:codec[:profile[:depth]]]]" entries separated
+    // by commas, e.g. "deny:vaapi:hevc:*:10,allow". False on syntax errors.
+    static bool parseRules(const std::string& spec, std::vector<Rule>& out);
+
+    // Rules for policies created afterwards (first match wins; no match =
+    // allow). Built-in rules denying 10- and 12-bit streams follow them, so
+    // e.g. "allow:vulkan:hevc:*:10" or a trailing "allow" re-enables those.
+    static void setDefaultRules(std::vector<Rule> rules);
+
+    explicit HwdecPolicy(HwdecCapabilities caps);
+
+    // mpv hwdec option value: comma-separated interops to try in order, or "no"
+    std::string select(const HwdecStream& stream) const;
+
+    // Record what mpv ended up using ("no" = software) for a stream that was
+    // given the requested hwdec value. Returns true if this was a failure.
+    bool recordOutcome(const HwdecStream& stream, const std::string& requested,
+                       const std::string& current);
+
+    bool hasInterops() const { return !caps_.interops.empty(); }
+
+private:
+    bool allowed(const HwdecCapabilities::Interop& interop, const HwdecStream& stream) const;
+    static std::string key(const std::string& interop, const HwdecStream& stream);
+
+    HwdecCapabilities caps_;
+    std::vector<Rule> rules_;
+    std::set<std::string> failed_;   // interop|codec|profile|depth
+};
@@ -0,0 +1,254 @@
+#include "mpv_library.h"
+#include "logging.h"
+
+#include <mpv/client.h>
+#include <mpv/render.h>
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+// Every libmpv function the players use. Adding a call elsewhere means
+// adding it here and a forwarder below.
+#define MPV_FUNCTIONS(X)                     \
+    X(mpv_client_api_version)                \
+    X(mpv_error_string)                      \
+    X(mpv_event_name)                        \
+    X(mpv_free_node_contents)                \
+    X(mpv_create)                            \
+    X(mpv_initialize)                        \
+    X(mpv_terminate_destroy)                 \
+    X(mpv_set_option)                        \
+    X(mpv_set_option_string)                 \
+    X(mpv_command_async)                     \
+    X(mpv_set_property_string)               \
+    X(mpv_set_property_async)                \
+    X(mpv_get_property)                      \
+    X(mpv_observe_property)                  \
+    X(mpv_request_log_messages)              \
+    X(mpv_wait_event)                        \
+    X(mpv_set_wakeup_callback)               \
+    X(mpv_hook_add)                          \
+    X(mpv_hook_continue)                     \
+    X(mpv_render_context_create)             \
+    X(mpv_render_context_set_update_callback) \
+    X(mpv_render_context_update)             \
+    X(mpv_render_context_render)             \
+    X(mpv_render_context_free)
+
+namespace {
+
+struct Functions {
+#define MPV_DECLARE(name) decltype(&::name) name = nullptr;
+    MPV_FUNCTIONS(MPV_DECLARE)
+#undef MPV_DECLARE
+};
+
+Functions g_fn;
+bool g_attempted = false;
+bool g_loaded = false;
+
+// Tried in order. Linux resolves through the executable's RUNPATH ($ORIGIN
+// and EXTERNAL_MPV_DIR), like the link-time dependency did.
+const char* const kLibraryNames[] = {
+#ifdef _WIN32
+    "libmpv-2.dll",
+    "mpv-2.dll",
+#elif defined(__APPLE__)
+    "@executable_path/libmpv.2.dylib",
+    "libmpv.2.dylib",
+#else
+    "libmpv.so.2",
+    "libmpv.so",
+#endif
+#ifdef MPV_LIBRARY_PATH
+    MPV_LIBRARY_PATH,
+#endif
+};
+
+bool loadLibrary() {
+    auto start = std::chrono::steady_clock::now();
+#ifdef _WIN32
+    HMODULE lib = nullptr;
+#else
+    void* lib = nullptr;
+#endif
+    const char* lib_name = nullptr;
+    for (const char* name : kLibraryNames) {
+#ifdef _WIN32
+        lib = LoadLibraryA(name);
+#else
+        lib = dlopen(name, RTLD_NOW | RTLD_LOCAL);
+#endif
+        if (lib) {
+            lib_name = name;
+            break;
+        }
+    }
+    if (!lib) {
+#ifdef _WIN32
+        LOG_ERROR(LOG_MPV, "Failed to load libmpv (error %lu)", GetLastError());
+#else
+        LOG_ERROR(LOG_MPV, "Failed to load libmpv: %s", dlerror());
+#endif
+        return false;
+    }
+
+    // Never unloaded: libmpv and the codec libraries it pulls in aren't
+    // written to be dlclose()d
+    bool ok = true;
+#ifdef _WIN32
+#define MPV_RESOLVE(name) \
+    g_fn.name = reinterpret_cast<decltype(g_fn.name)>(reinterpret_cast<void*>(GetProcAddress(lib, #name)));
+#else
+#define MPV_RESOLVE(name) \
+    g_fn.name = reinterpret_cast<decltype(g_fn.name)>(dlsym(lib, #name));
+#endif
+#define MPV_LOAD(name)                                                 \
+    MPV_RESOLVE(name)                                                  \
+    if (!g_fn.name) {                                                  \
+        LOG_ERROR(LOG_MPV, "%s has no %s (libmpv too old?)", lib_name, #name); \
+        ok = false;                                                    \
+    }
+    MPV_FUNCTIONS(MPV_LOAD)
+#undef MPV_LOAD
+#undef MPV_RESOLVE
+    if (!ok) {
+        return false;
+    }
+
+    // Same major version = ABI compatible with the headers we built against
+    unsigned long version = g_fn.mpv_client_api_version();
+    if ((version >> 16) != (MPV_CLIENT_API_VERSION >> 16)) {
+        LOG_ERROR(LOG_MPV, "%s has client API %lu.%lu, built for %lu.%lu", lib_name,
+                  version >> 16, version & 0xffff,
+                  static_cast<unsigned long>(MPV_CLIENT_API_VERSION >> 16),
+                  static_cast<unsigned long>(MPV_CLIENT_API_VERSION & 0xffff));
+        return false;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO(LOG_MPV, "Loaded %s (client API %lu.%lu) in %.1f ms", lib_name,
+             version >> 16, version & 0xffff, ms);
+    return true;
+}
+
+}  // namespace
+
+bool MpvLibrary::load() {
+    if (!g_attempted) {
+        g_attempted = true;
+        g_loaded = loadLibrary();
+    }
+    return g_loaded;
+}
+
+bool MpvLibrary::isLoaded() {
+    return g_loaded;
+}
+
+// Forwarders. mpv_create() is the way into everything else, so it alone
+// copes with the library being unavailable.
+
+unsigned long mpv_client_api_version(void) {
+    return g_fn.mpv_client_api_version();
+}
+
+const char* mpv_error_string(int error) {
+    return g_fn.mpv_error_string(error);
+}
+
+const char* mpv_event_name(mpv_event_id event) {
+    return g_fn.mpv_event_name(event);
+}
+
+void mpv_free_node_contents(mpv_node* node) {
+    g_fn.mpv_free_node_contents(node);
+}
+
+mpv_handle* mpv_create(void) {
+    if (!MpvLibrary::load()) return nullptr;
+    return g_fn.mpv_create();
+}
+
+int mpv_initialize(mpv_handle* ctx) {
+    return g_fn.mpv_initialize(ctx);
+}
+
+void mpv_terminate_destroy(mpv_handle* ctx) {
+    g_fn.mpv_terminate_destroy(ctx);
+}
+
+int mpv_set_option(mpv_handle* ctx, const char* name, mpv_format format, void* data) {
+    return g_fn.mpv_set_option(ctx, name, format, data);
+}
+
+int mpv_set_option_string(mpv_handle* ctx, const char* name, const char* data) {
+    return g_fn.mpv_set_option_string(ctx, name, data);
+}
+
+int mpv_command_async(mpv_handle* ctx, uint64_t reply_userdata, const char** args) {
+    return g_fn.mpv_command_async(ctx, reply_userdata, args);
+}
+
+int mpv_set_property_string(mpv_handle* ctx, const char* name, const char* data) {
+    return g_fn.mpv_set_property_string(ctx, name, data);
+}
+
+int mpv_set_property_async(mpv_handle* ctx, uint64_t reply_userdata, const char* name,
+                           mpv_format format, void* data) {
+    return g_fn.mpv_set_property_async(ctx, reply_userdata, name, format, data);
+}
+
+int mpv_get_property(mpv_handle* ctx, const char* name, mpv_format format, void* data) {
+    return g_fn.mpv_get_property(ctx, name, format, data);
+}
+
+int mpv_observe_property(mpv_handle* mpv, uint64_t reply_userdata, const char* name, mpv_format format) {
+    return g_fn.mpv_observe_property(mpv, reply_userdata, name, format);
+}
+
+int mpv_request_log_messages(mpv_handle* ctx, const char* min_level) {
+    return g_fn.mpv_request_log_messages(ctx, min_level);
+}
+
+mpv_event* mpv_wait_event(mpv_handle* ctx, double timeout) {
+    return g_fn.mpv_wait_event(ctx, timeout);
+}
+
+void mpv_set_wakeup_callback(mpv_handle* ctx, void (*cb)(void* d), void* d) {
+    g_fn.mpv_set_wakeup_callback(ctx, cb, d);
+}
+
+int mpv_hook_add(mpv_handle* ctx, uint64_t reply_userdata, const char* name, int priority) {
+    return g_fn.mpv_hook_add(ctx, reply_userdata, name, priority);
+}
+
+int mpv_hook_continue(mpv_handle* ctx, uint64_t id) {
+    return g_fn.mpv_hook_continue(ctx, id);
+}
+
+int mpv_render_context_create(mpv_render_context** res, mpv_handle* mpv, mpv_render_param* params) {
+    return g_fn.mpv_render_context_create(res, mpv, params);
+}
+
+void mpv_render_context_set_update_callback(mpv_render_context* ctx, mpv_render_update_fn callback,
+                                            void* callback_ctx) {
+    g_fn.mpv_render_context_set_update_callback(ctx, callback, callback_ctx);
+}
+
+uint64_t mpv_render_context_update(mpv_render_context* ctx) {
+    return g_fn.mpv_render_context_update(ctx);
+}
+
+int mpv_render_context_render(mpv_render_context* ctx, mpv_render_param* params) {
+    return g_fn.mpv_render_context_render(ctx, params);
+}
+
+void mpv_render_context_free(mpv_render_context* ctx) {
+    g_fn.mpv_render_context_free(ctx);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// libmpv is loaded at runtime (dlopen/LoadLibrary) when the video stack is
+// first created, so a session that never plays anything doesn't map it and
+// its codec libraries at all. mpv_library.cpp defines the mpv_* functions
+// the players call and forwards them to the loaded library.
+class MpvLibrary {
+public:
+    // Load libmpv and resolve every function we use. Later calls return the
+    // first result; the library stays loaded for the rest of the process.
+    static bool load();
+    static bool isLoaded();
+};
@@ -4,7 +4,104 @@
 #include <mpv/render_vk.h>
 #include <clocale>
 #include <cmath>
+#include <cstring>
 #include "logging.h"
+#if !defined(__APPLE__) && !defined(_WIN32)
+#include <filesystem>
+#endif
+
+#if !defined(__APPLE__) && !defined(_WIN32)
+static bool hasDeviceExtension(VideoSurface* surface, const char* name) {
+    const char* const* exts = surface->deviceExtensions();
+    for (int i = 0; i < surface->deviceExtensionCount(); i++) {
+        if (strcmp(exts[i], name) == 0) return true;
+    }
+    return false;
+}
+
+static bool hasRenderNode() {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/dev/dri", ec)) {
+        if (entry.path().filename().string().rfind("renderD", 0) == 0) return true;
+    }
+    return false;
+}
+#endif
+
+// Hardware decode paths that can hand frames to the surface's Vulkan device
+static HwdecCapabilities probeHwdec(VideoSurface* surface) {
+    HwdecCapabilities caps;
+#if !defined(__APPLE__) && !defined(_WIN32)
+    if (!surface || !surface->vkPhysicalDevice()) return caps;
+
+    // Vulkan Video: a decode queue family, and the decode extension enabled on
+    // the device mpv renders with
+    if (hasDeviceExtension(surface, VK_KHR_VIDEO_DECODE_QUEUE_EXTENSION_NAME)) {
+        VkPhysicalDevice gpu = surface->vkPhysicalDevice();
+        uint32_t count = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties2(gpu, &count, nullptr);
+        std::vector<VkQueueFamilyVideoPropertiesKHR> video(count);
+        std::vector<VkQueueFamilyProperties2> families(count);
+        for (uint32_t i = 0; i < count; i++) {
+            video[i] = {};
+            video[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_VIDEO_PROPERTIES_KHR;
+            families[i] = {};
+            families[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_PROPERTIES_2;
+            families[i].pNext = &video[i];
+        }
+        vkGetPhysicalDeviceQueueFamilyProperties2(gpu, &count, families.data());
+
+        VkVideoCodecOperationFlagsKHR ops = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            if (families[i].queueFamilyProperties.queueFlags & VK_QUEUE_VIDEO_DECODE_BIT_KHR) {
+                ops |= video[i].videoCodecOperations;
+            }
+        }
+        HwdecCapabilities::Interop vulkan{"vulkan", {}};
+        if (ops & VK_VIDEO_CODEC_OPERATION_DECODE_H264_BIT_KHR) vulkan.codecs.push_back("h264");
+        if (ops & VK_VIDEO_CODEC_OPERATION_DECODE_H265_BIT_KHR) vulkan.codecs.push_back("hevc");
+#ifdef VK_KHR_video_decode_av1
+        if (ops & VK_VIDEO_CODEC_OPERATION_DECODE_AV1_BIT_KHR) vulkan.codecs.push_back("av1");
+#endif
+        if (!vulkan.codecs.empty()) caps.interops.push_back(vulkan);
+    }
+
+    // VA-API surfaces imported into Vulkan as dma-bufs
+    if (hasDeviceExtension(surface, VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME) &&
+        hasDeviceExtension(surface, VK_EXT_IMAGE_DRM_FORMAT_MODIFIER_EXTENSION_NAME) &&
+        hasRenderNode()) {
+        caps.interops.push_back({"vaapi", {}});
+    }
+#else
+    (void)surface;
+#endif
+
+    std::string names;
+    for (const auto& interop : caps.interops) {
+        if (!names.empty()) names += ", ";
+        names += interop.name;
+    }
+    LOG_INFO(LOG_MPV, "hwdec interops: %s", names.empty() ? "none" : names.c_str());
+    return caps;
+}
+
+// Bit depth from an mpv pixel format name; 0 if it doesn't say (hw formats)
+static int formatBitDepth(const char* format) {
+    if (!format || !*format) return 0;
+    if (strncmp(format, "nv", 2) == 0) return 8;
+    if (strstr(format, "16")) return 16;
+    if (strstr(format, "12")) return 12;
+    if (strstr(format, "10")) return 10;
+    if (strncmp(format, "yuv", 3) == 0 || strncmp(format, "gray", 4) == 0) return 8;
+    return 0;
+}
+
+// Best guess before decoding starts ("Main 10", "High 10", "Main 12", ...)
+static int profileBitDepth(const std::string& profile) {
+    if (profile.find("12") != std::string::npos) return 12;
+    if (profile.find("10") != std::string::npos) return 10;
+    return 8;
+}
 
 MpvPlayerVk::MpvPlayerVk() = default;
 
@@ -81,9 +178,16 @@ void MpvPlayerVk::handleMpvEvent(mpv_event* event) {
                 bool eof = *static_cast<int*>(prop->data) != 0;
                 if (eof && playing_) {
                     LOG_DEBUG(LOG_MPV, "eof-reached=true, track ended naturally");
+                    endDecodeSession();
                     playing_ = false;
                     if (on_finished_) on_finished_();
                 }
+            } else if (strcmp(prop->name, "video-params/pixelformat") == 0 && prop->format == MPV_FORMAT_STRING) {
+                onPixelFormat(*static_cast<char**>(prop->data));
+            } else if (strcmp(prop->name, "video-params/hw-pixelformat") == 0 && prop->format == MPV_FORMAT_STRING) {
+                onPixelFormat(*static_cast<char**>(prop->data));
+            } else if (strcmp(prop->name, "hwdec-current") == 0 && prop->format == MPV_FORMAT_STRING) {
+                onHwdecCurrent(*static_cast<char**>(prop->data));
             } else if (strcmp(prop->name, "demuxer-cache-state") == 0 && prop->format == MPV_FORMAT_NODE) {
                 if (on_buffered_ranges_) {
                     std::vector<BufferedRange> ranges;
@@ -124,9 +228,19 @@ void MpvPlayerVk::handleMpvEvent(mpv_event* event) {
             playing_ = true;
             break;
         case MPV_EVENT_FILE_LOADED:
+            startDecodeSession();
             if (on_playing_) on_playing_();
             break;
+        case MPV_EVENT_HOOK: {
+            auto* hook = static_cast<mpv_event_hook*>(event->data);
+            if (strcmp(hook->name, "on_preloaded") == 0) {
+                onPreloaded();
+            }
+            mpv_hook_continue(mpv_, hook->id);
+            break;
+        }
         case MPV_EVENT_END_FILE: {
+            endDecodeSession();
             mpv_event_end_file* ef = static_cast<mpv_event_end_file*>(event->data);
             LOG_DEBUG(LOG_MPV, "END_FILE reason=%d (0=EOF, 2=STOP, 4=ERROR)", ef->reason);
             // With keep-open=yes, EOF reason won't fire (handled by eof-reached property)
@@ -172,7 +286,9 @@ bool MpvPlayerVk::init(VulkanContext* vk, VideoSurface* subsurface) {
     }
 
     mpv_set_option_string(mpv_, "vo", "libmpv");
-    mpv_set_option_string(mpv_, "hwdec", "no");  // Force software decode for yuv420p10
+    // Chosen per stream by the policy in the on_preloaded hook
+    hwdec_policy_ = std::make_unique<HwdecPolicy>(probeHwdec(subsurface_));
+    mpv_set_option_string(mpv_, "hwdec", "no");
     mpv_set_option_string(mpv_, "keep-open", "yes");  // Keep video layer alive, detect EOF via eof-reached property
     mpv_set_option_string(mpv_, "terminal", "no");
     mpv_set_option_string(mpv_, "video-sync", "audio");  // Simple audio sync, no frame interpolation
@@ -222,6 +338,12 @@ bool MpvPlayerVk::init(VulkanContext* vk, VideoSurface* subsurface) {
     mpv_observe_property(mpv_, 0, "core-idle", MPV_FORMAT_FLAG);
     mpv_observe_property(mpv_, 0, "eof-reached", MPV_FORMAT_FLAG);  // Detect natural track end with keep-open=yes
     mpv_observe_property(mpv_, 0, "demuxer-cache-state", MPV_FORMAT_NODE);
+    mpv_observe_property(mpv_, 0, "video-params/pixelformat", MPV_FORMAT_STRING);
+    mpv_observe_property(mpv_, 0, "video-params/hw-pixelformat", MPV_FORMAT_STRING);
+    mpv_observe_property(mpv_, 0, "hwdec-current", MPV_FORMAT_STRING);
+
+    // Pick hwdec once the demuxer knows the codec, before the decoder opens
+    mpv_hook_add(mpv_, 0, "on_preloaded", 0);
 
     // Wakeup callback for event-driven processing
     mpv_set_wakeup_callback(mpv_, onMpvWakeup, this);
@@ -288,6 +410,99 @@ bool MpvPlayerVk::init(VulkanContext* vk, VideoSurface* subsurface) {
     return true;
 }
 
+void MpvPlayerVk::onPreloaded() {
+    stream_ = HwdecStream{};
+    stream_known_ = false;
+    hwdec_current_.clear();
+
+    mpv_node tracks;
+    if (mpv_get_property(mpv_, "track-list", MPV_FORMAT_NODE, &tracks) < 0) return;
+    if (tracks.format == MPV_FORMAT_NODE_ARRAY) {
+        // Prefer the default video track, skipping cover art
+        for (int i = 0; i < tracks.u.list->num; i++) {
+            mpv_node* track = &tracks.u.list->values[i];
+            if (track->format != MPV_FORMAT_NODE_MAP) continue;
+            std::string type, codec, profile;
+            bool albumart = false, is_default = false;
+            for (int k = 0; k < track->u.list->num; k++) {
+                const char* key = track->u.list->keys[k];
+                mpv_node* value = &track->u.list->values[k];
+                if (value->format == MPV_FORMAT_STRING) {
+                    if (strcmp(key, "type") == 0) type = value->u.string;
+                    else if (strcmp(key, "codec") == 0) codec = value->u.string;
+                    else if (strcmp(key, "codec-profile") == 0) profile = value->u.string;
+                } else if (value->format == MPV_FORMAT_FLAG) {
+                    if (strcmp(key, "albumart") == 0) albumart = value->u.flag;
+                    else if (strcmp(key, "default") == 0) is_default = value->u.flag;
+                }
+            }
+            if (type != "video" || albumart || codec.empty()) continue;
+            if (stream_known_ && !is_default) continue;
+            stream_.codec = codec;
+            stream_.profile = profile;
+            stream_.bit_depth = profileBitDepth(profile);
+            stream_known_ = true;
+            if (is_default) break;
+        }
+    }
+    mpv_free_node_contents(&tracks);
+
+    if (!stream_known_) {
+        hwdec_requested_ = "no";
+        mpv_set_property_string(mpv_, "hwdec", "no");
+        return;
+    }
+    applyHwdec();
+}
+
+void MpvPlayerVk::applyHwdec() {
+    std::string hwdec = hwdec_policy_->select(stream_);
+    if (hwdec == hwdec_requested_) return;
+    hwdec_requested_ = hwdec;
+    LOG_INFO(LOG_MPV, "hwdec policy: %s (%s, %d-bit) -> %s", stream_.codec.c_str(),
+             stream_.profile.empty() ? "no profile" : stream_.profile.c_str(),
+             stream_.bit_depth, hwdec.c_str());
+    mpv_set_property_string(mpv_, "hwdec", hwdec.c_str());
+}
+
+void MpvPlayerVk::onPixelFormat(const char* format) {
+    // The decoded format settles the bit depth the profile only hinted at
+    int depth = formatBitDepth(format);
+    if (!stream_known_ || depth == 0 || depth == stream_.bit_depth) return;
+    stream_.bit_depth = depth;
+    applyHwdec();
+}
+
+void MpvPlayerVk::onHwdecCurrent(const char* hwdec) {
+    if (!hwdec || !*hwdec || !stream_known_ || hwdec_current_ == hwdec) return;
+    hwdec_current_ = hwdec;
+    if (hwdec_policy_->recordOutcome(stream_, hwdec_requested_, hwdec_current_)) {
+        hwdec_requested_ = "no";
+        return;
+    }
+    LOG_INFO(LOG_MPV, "hwdec in use: %s", hwdec);
+}
+
+void MpvPlayerVk::startDecodeSession() {
+    session_active_ = true;
+    session_cpu_start_ = std::clock();
+    session_start_ = std::chrono::steady_clock::now();
+}
+
+void MpvPlayerVk::endDecodeSession() {
+    if (!session_active_) return;
+    session_active_ = false;
+    if (!stream_known_) return;  // Audio only
+
+    // Process CPU time: with software decode it is dominated by the decoder
+    double cpu = static_cast<double>(std::clock() - session_cpu_start_) / CLOCKS_PER_SEC;
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - session_start_).count();
+    LOG_INFO(LOG_MPV, "Decode session: %s (%s, %d-bit) hwdec=%s cpu=%.1fs over %.1fs (%.0f%% of a core)",
+             stream_.codec.c_str(), stream_.profile.empty() ? "no profile" : stream_.profile.c_str(),
+             stream_.bit_depth, hwdec_current_.empty() ? "no" : hwdec_current_.c_str(),
+             cpu, wall, wall > 0 ? cpu / wall * 100.0 : 0.0);
+}
+
 bool MpvPlayerVk::loadFile(const std::string& path, double startSeconds) {
     // Set start position before loading (mpv uses this for the next file)
     if (startSeconds > 0.0) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mpv_player.h"
+#include "hwdec_policy.h"
 #include "context/vulkan_context.h"
 #ifdef __APPLE__
 #include "platform/macos_layer.h"
@@ -13,6 +14,9 @@ using VideoSurface = WindowsVideoLayer;
 // VideoSurface is now an abstract base class on Linux
 #endif
 #include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
 
 struct mpv_handle;
 struct mpv_render_context;
@@ -82,6 +86,14 @@ private:
     static void onMpvWakeup(void* ctx);
     void handleMpvEvent(struct mpv_event* event);
 
+    // Hardware decode policy
+    void onPreloaded();
+    void onPixelFormat(const char* format);
+    void onHwdecCurrent(const char* hwdec);
+    void applyHwdec();
+    void startDecodeSession();
+    void endDecodeSession();
+
     VulkanContext* vk_ = nullptr;
     VideoSurface* subsurface_ = nullptr;
     mpv_handle* mpv_ = nullptr;
@@ -106,4 +118,16 @@ private:
     bool playing_ = false;
     bool seeking_ = false;
     double last_position_ = 0.0;
+
+    // Per-stream hwdec choice (mpv event thread only)
+    std::unique_ptr<HwdecPolicy> hwdec_policy_;
+    HwdecStream stream_;
+    bool stream_known_ = false;
+    std::string hwdec_requested_ = "no";
+    std::string hwdec_current_;
+
+    // Decode session accounting for the CPU log
+    bool session_active_ = false;
+    std::clock_t session_cpu_start_ = 0;
+    std::chrono::steady_clock::time_point session_start_;
 };
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Single-producer/single-consumer primitives for handing mpv state from the
+// event thread to the main thread without locks or allocation.
+
+// Latest-value slot (triple buffer). store() never blocks and overwrites a
+// value the consumer hasn't taken yet, so bursts coalesce to the newest one.
+template <typename T>
+class LatestValue {
+public:
+    // Producer thread
+    void store(const T& value) {
+        buffers_[back_] = value;
+        uint8_t prev = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = prev & kIndex;
+    }
+
+    // Consumer thread: newest value since the last take, false if none
+    bool take(T& out) {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & kIndex;
+        out = buffers_[front_];
+        return true;
+    }
+
+private:
+    static constexpr uint8_t kIndex = 3;
+    static constexpr uint8_t kFresh = 4;  // Middle buffer holds an untaken value
+
+    T buffers_[3]{};
+    uint8_t back_ = 0;    // Producer only
+    uint8_t front_ = 1;   // Consumer only
+    alignas(64) std::atomic<uint8_t> middle_{2};
+};
+
+// Bounded FIFO of trivially copyable entries. N must be a power of two.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer thread: false if the ring is full
+    bool push(const T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N) return false;
+        slots_[head & (N - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread: false if the ring is empty
+    bool pop(T& out) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        out = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T slots_[N]{};
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
@@ -1,6 +1,8 @@
 #include "mpv_event_thread.h"
 #include "mpv/mpv_player.h"
 #include "logging.h"
+#include "trace.h"
+#include <cstdio>
 
 MpvEventThread::~MpvEventThread() {
     stop();
@@ -8,69 +10,68 @@ MpvEventThread::~MpvEventThread() {
 
 void MpvEventThread::start(MpvPlayer* player) {
     player_ = player;
+    updates_ = 0;
+    dropped_ = 0;
+    started_ = std::chrono::steady_clock::now();
 
-    // Set up callbacks that queue events instead of executing directly
+    // High-frequency state goes to latest-value slots (coalesced),
+    // everything else through the event ring in order
     player_->setPositionCallback([this](double ms) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Position, ms});
+        position_.store(ms);
+        updates_++;
+        queued_.store(true, std::memory_order_release);
     });
 
     player_->setDurationCallback([this](double ms) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Duration, ms});
+        duration_.store(ms);
+        updates_++;
+        queued_.store(true, std::memory_order_release);
+    });
+
+    player_->setBufferedRangesCallback([this](const std::vector<MpvPlayer::BufferedRange>& ranges) {
+        MpvBufferedRanges state;
+        for (const auto& r : ranges) {
+            if (state.count == MpvBufferedRanges::kMaxRanges) break;
+            state.ranges[state.count++] = {r.start, r.end};
+        }
+        buffered_ranges_.store(state);
+        updates_++;
+        queued_.store(true, std::memory_order_release);
     });
 
     player_->setPlayingCallback([this]() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Playing});
+        push(MpvEvent{MpvEvent::Type::Playing});
     });
 
     player_->setStateCallback([this](bool paused) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Paused, 0, paused});
+        push(MpvEvent{MpvEvent::Type::Paused, 0, paused});
     });
 
     player_->setFinishedCallback([this]() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Finished});
+        push(MpvEvent{MpvEvent::Type::Finished});
     });
 
     player_->setCanceledCallback([this]() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Canceled});
+        push(MpvEvent{MpvEvent::Type::Canceled});
     });
 
     player_->setSeekedCallback([this](double ms) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Seeked, ms});
+        push(MpvEvent{MpvEvent::Type::Seeked, ms});
     });
 
     player_->setBufferingCallback([this](bool buffering, double ms) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::Buffering, ms, buffering});
+        push(MpvEvent{MpvEvent::Type::Buffering, ms, buffering});
     });
 
     player_->setCoreIdleCallback([this](bool idle, double ms) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pending_.push_back(MpvEvent{MpvEvent::Type::CoreIdle, ms, idle});
-    });
-
-    player_->setBufferedRangesCallback([this](const std::vector<MpvPlayer::BufferedRange>& ranges) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        MpvEvent ev;
-        ev.type = MpvEvent::Type::BufferedRanges;
-        for (const auto& r : ranges) {
-            ev.ranges.emplace_back(r.start, r.end);
-        }
-        pending_.push_back(std::move(ev));
+        push(MpvEvent{MpvEvent::Type::CoreIdle, ms, idle});
     });
 
     player_->setErrorCallback([this](const std::string& error) {
-        std::lock_guard<std::mutex> lock(mutex_);
         MpvEvent ev;
         ev.type = MpvEvent::Type::Error;
-        ev.error = error;
-        pending_.push_back(std::move(ev));
+        snprintf(ev.error, sizeof(ev.error), "%s", error.c_str());
+        push(ev);
     });
 
     // Set wakeup callback to notify our CV when mpv has events
@@ -88,14 +89,21 @@ void MpvEventThread::stop() {
     if (thread_.joinable()) {
         thread_.join();
     }
-    LOG_INFO(LOG_MPV, "mpv event thread stopped");
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    LOG_INFO(LOG_MPV, "mpv event thread stopped (%llu events, %.0f/s, %llu dropped)",
+             static_cast<unsigned long long>(updates_), secs > 0 ? updates_ / secs : 0.0,
+             static_cast<unsigned long long>(dropped_));
 }
 
-std::vector<MpvEvent> MpvEventThread::drain() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<MpvEvent> result;
-    result.swap(pending_);
-    return result;
+void MpvEventThread::push(const MpvEvent& ev) {
+    updates_++;
+    if (!events_.push(ev)) {
+        // Main loop stalled for hundreds of events; keep the older ones
+        dropped_++;
+        LOG_WARN(LOG_MPV, "mpv event ring full, dropping event %d", static_cast<int>(ev.type));
+    }
+    queued_.store(true, std::memory_order_release);
 }
 
 void MpvEventThread::wake() {
@@ -103,8 +111,17 @@ void MpvEventThread::wake() {
 }
 
 void MpvEventThread::threadFunc() {
+    TraceRecorder::setThreadName("mpv events");
     while (running_.load()) {
-        player_->processEvents();
+        {
+            TRACE_SPAN("mpv.processEvents");
+            player_->processEvents();
+        }
+
+        // Main loop sleeps when idle, so tell it there is something to drain
+        if (queued_.exchange(false, std::memory_order_acq_rel) && on_events_) {
+            on_events_();
+        }
 
         // Wait for mpv wakeup callback or shutdown
         std::unique_lock lock(cv_mutex_);
@@ -1,20 +1,21 @@
 #pragma once
 
+#include "mpv_event_channel.h"
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
-#include <vector>
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <string>
+#include <utility>
 
 class MpvPlayer;
 
-// Event types that mpv thread queues for main thread
+// Discrete events that mpv thread queues for main thread (trivially copyable,
+// so they travel through a preallocated ring)
 struct MpvEvent {
     enum class Type {
-        Position,
-        Duration,
         Playing,
         Paused,
         Finished,
@@ -22,15 +23,20 @@ struct MpvEvent {
         Seeked,
         Buffering,
         CoreIdle,
-        BufferedRanges,
         Error
     };
 
-    Type type;
-    double value = 0;           // position/duration in ms
+    Type type = Type::Playing;
+    double value = 0;           // position in ms
     bool flag = false;          // paused/buffering/idle
-    std::string error;          // error message
-    std::vector<std::pair<int64_t, int64_t>> ranges;  // buffered ranges
+    char error[256] = {};       // error message (truncated)
+};
+
+// Latest demuxer cache state, converted to ticks (100ns units)
+struct MpvBufferedRanges {
+    static constexpr int kMaxRanges = 32;
+    int count = 0;
+    std::pair<int64_t, int64_t> ranges[kMaxRanges];
 };
 
 // Runs mpv event processing on dedicated thread
@@ -39,25 +45,45 @@ public:
     MpvEventThread() = default;
     ~MpvEventThread();
 
+    // Called on the event thread after new events are queued (set before start)
+    void setWakeCallback(std::function<void()> cb) { on_events_ = std::move(cb); }
+
     // Start thread - takes ownership of event processing
     void start(MpvPlayer* player);
 
     // Stop thread
     void stop();
 
-    // Main thread calls this to get pending events (swaps buffers)
-    std::vector<MpvEvent> drain();
+    // Main thread: newest high-frequency state since the last call (false if
+    // unchanged). Intermediate values are coalesced away.
+    bool takePosition(double& ms) { return position_.take(ms); }
+    bool takeDuration(double& ms) { return duration_.take(ms); }
+    bool takeBufferedRanges(MpvBufferedRanges& out) { return buffered_ranges_.take(out); }
+
+    // Main thread: next discrete event in order, false when none are left
+    bool pop(MpvEvent& ev) { return events_.pop(ev); }
 
 private:
     void threadFunc();
     void wake();
+    void push(const MpvEvent& ev);
 
     MpvPlayer* player_ = nullptr;
+    std::function<void()> on_events_;
     std::thread thread_;
     std::atomic<bool> running_{false};
 
-    std::mutex mutex_;
-    std::vector<MpvEvent> pending_;
+    // Event thread -> main thread
+    LatestValue<double> position_;
+    LatestValue<double> duration_;
+    LatestValue<MpvBufferedRanges> buffered_ranges_;
+    SpscRing<MpvEvent, 256> events_;
+    std::atomic<bool> queued_{false};  // Something was published since the last wake
+
+    // Channel counters for the shutdown log (event thread only)
+    uint64_t updates_ = 0;
+    uint64_t dropped_ = 0;
+    std::chrono::steady_clock::time_point started_;
 
     std::mutex cv_mutex_;
     std::condition_variable cv_;
@@ -24,8 +24,9 @@ static const char* composite_frag = R"(#version 330 core
 in vec2 vTexCoord;
 out vec4 fragColor;
 uniform sampler2D videoTex;
+uniform vec2 texScale;  // Rendered size / FBO storage size
 void main() {
-    fragColor = texture(videoTex, vTexCoord);
+    fragColor = texture(videoTex, vTexCoord * texScale);
 }
 )";
 #else
@@ -44,12 +45,22 @@ precision mediump float;
 in vec2 vTexCoord;
 out vec4 fragColor;
 uniform sampler2D videoTex;
+uniform vec2 texScale;  // Rendered size / FBO storage size
 void main() {
-    fragColor = texture(videoTex, vTexCoord);
+    fragColor = texture(videoTex, vTexCoord * texScale);
 }
 )";
 #endif
 
+// Fence handoff needs sync objects (GL 3.2 / GLES 3.0); otherwise frames are glFinish'd
+static bool haveSync() {
+#ifdef _WIN32
+    return glFenceSync && glWaitSync && glDeleteSync;
+#else
+    return true;
+#endif
+}
+
 OpenGLRenderer::OpenGLRenderer(MpvPlayerGL* player) : player_(player) {}
 
 OpenGLRenderer::~OpenGLRenderer() {
@@ -87,80 +98,93 @@ bool OpenGLRenderer::hasFrame() const {
 }
 
 void OpenGLRenderer::createFBO(int width, int height) {
-    if (buffers_[0].fbo && fbo_width_ == width && fbo_height_ == height) {
+    if (slots_[0].fb.fbo && fbo_width_ == width && fbo_height_ == height) {
         return;  // Already have correct size
     }
 
+    // Pooled storage is bucketed and grow-only: while the new size still fits,
+    // render into the same FBOs (live resize allocates nothing)
+    if (slots_[0].fb.fbo && GLSurfacePool::fits(slots_[0].fb.width, slots_[0].fb.height, width, height)) {
+        fbo_width_ = width;
+        fbo_height_ = height;
+        return;
+    }
+
     destroyFBO();
 
-    // Create double-buffered FBOs
+    // Create triple-buffered FBOs
     for (int i = 0; i < NUM_BUFFERS; i++) {
-        auto& buf = buffers_[i];
-
-        glGenFramebuffers(1, &buf.fbo);
-        glGenTextures(1, &buf.texture);
-        glGenRenderbuffers(1, &buf.depth_rb);
-
-        glBindTexture(GL_TEXTURE_2D, buf.texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        glBindRenderbuffer(GL_RENDERBUFFER, buf.depth_rb);
-        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, width, height);
-
-        glBindFramebuffer(GL_FRAMEBUFFER, buf.fbo);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buf.texture, 0);
-        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, buf.depth_rb);
-
-        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-        if (status != GL_FRAMEBUFFER_COMPLETE) {
-            LOG_ERROR(LOG_VIDEO, "FBO %d incomplete: 0x%x", i, status);
+        slots_[i].fb = pool_.acquireFramebuffer(width, height);
+        if (!slots_[i].fb.fbo) {
+            LOG_ERROR(LOG_VIDEO, "FBO %d creation failed (%dx%d)", i, width, height);
             destroyFBO();
             return;
         }
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
     fbo_width_ = width;
     fbo_height_ = height;
     write_index_ = 0;
-    LOG_INFO(LOG_VIDEO, "Created double-buffered video FBOs: %dx%d", width, height);
+    LOG_INFO(LOG_VIDEO, "Created triple-buffered video FBOs: %dx%d (storage %dx%d, %s handoff)",
+             width, height, slots_[0].fb.width, slots_[0].fb.height, haveSync() ? "fence" : "glFinish");
 }
 
 void OpenGLRenderer::destroyFBO() {
-    front_texture_.store(0);  // Clear atomic first
-
-    for (int i = 0; i < NUM_BUFFERS; i++) {
-        auto& buf = buffers_[i];
-        if (buf.fbo) {
-            glDeleteFramebuffers(1, &buf.fbo);
-            buf.fbo = 0;
-        }
-        if (buf.texture) {
-            glDeleteTextures(1, &buf.texture);
-            buf.texture = 0;
+    front_ = -1;  // Nothing left to composite
+
+    for (auto& slot : slots_) {
+        if (slot.released) {
+            // The pool may hand this storage out again: order that after the main context's reads
+            glWaitSync(slot.released, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(slot.released);
+            slot.released = nullptr;
         }
-        if (buf.depth_rb) {
-            glDeleteRenderbuffers(1, &buf.depth_rb);
-            buf.depth_rb = 0;
+        if (slot.rendered) {
+            glDeleteSync(slot.rendered);
+            slot.rendered = nullptr;
         }
+        // Pooled until idle, so a resize that needs them back doesn't reallocate
+        pool_.release(slot.fb);
+        slot.frame_width = 0;
+        slot.frame_height = 0;
     }
     fbo_width_ = 0;
     fbo_height_ = 0;
 }
 
-bool OpenGLRenderer::render(int width, int height) {
-    if (threaded_) {
-        // Make shared context current on this thread
+bool OpenGLRenderer::makeThreadCurrent() {
+    if (thread_current_) {
+        return true;
+    }
+#ifdef _WIN32
+    if (!wgl_->makeCurrent(shared_ctx_)) {
+#else
+    if (!egl_->makeCurrent(shared_ctx_)) {
+#endif
+        LOG_ERROR(LOG_VIDEO, "Failed to make shared context current");
+        return false;
+    }
+    thread_current_ = true;
+    return true;
+}
+
+void OpenGLRenderer::renderThreadExiting() {
+    if (!thread_current_) {
+        return;
+    }
+    // Release the shared context so cleanup can make it current on the main thread
 #ifdef _WIN32
-        if (!wgl_->makeCurrent(shared_ctx_)) {
+    wgl_->makeCurrent(nullptr);
 #else
-        if (!egl_->makeCurrent(shared_ctx_)) {
+    egl_->makeCurrent(EGL_NO_CONTEXT);
 #endif
-            LOG_ERROR(LOG_VIDEO, "Failed to make shared context current");
+    thread_current_ = false;
+}
+
+bool OpenGLRenderer::render(int width, int height) {
+    if (threaded_) {
+        // Shared context stays current on the render thread once made current
+        if (!makeThreadCurrent()) {
             return false;
         }
 
@@ -168,36 +192,53 @@ bool OpenGLRenderer::render(int width, int height) {
         {
             std::lock_guard<std::mutex> lock(fbo_mutex_);
             createFBO(width, height);
-            if (!buffers_[0].fbo) {
+            pool_.trim();
+            if (!slots_[0].fb.fbo) {
                 LOG_ERROR(LOG_VIDEO, "FBO creation failed");
-#ifdef _WIN32
-                wgl_->makeCurrent(nullptr);
-#else
-                egl_->makeCurrent(EGL_NO_CONTEXT);
-#endif
                 return false;
             }
         }
 
+        // The write slot is never the front one, but the main context may
+        // still be reading an older frame from it: wait for that on the GPU
+        Slot& back = slots_[write_index_];
+        {
+            std::lock_guard<std::mutex> lock(fbo_mutex_);
+            if (back.released) {
+                glWaitSync(back.released, 0, GL_TIMEOUT_IGNORED);
+                glDeleteSync(back.released);
+                back.released = nullptr;
+            }
+        }
+
         // Render to back buffer
-        auto& back = buffers_[write_index_];
-        glBindFramebuffer(GL_FRAMEBUFFER, back.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, back.fb.fbo);
         glViewport(0, 0, width, height);
-        player_->render(width, height, back.fbo, false);  // No flip - FBO is top-down
+        player_->render(width, height, back.fb.fbo, false);  // No flip - FBO is top-down
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // Wait for render to complete before publishing texture
-        glFinish();
+        // Fence the frame and flush so the main context can wait on it; the GPU
+        // finishes rendering while this thread goes back to waiting for mpv
+        GLsync rendered = nullptr;
+        if (haveSync()) {
+            rendered = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+        } else {
+            glFinish();
+        }
 
-        // Publish this texture as front and swap to other buffer for next frame
-        front_texture_.store(back.texture);
+        // Publish this slot as front and move on to the next one
+        {
+            std::lock_guard<std::mutex> lock(fbo_mutex_);
+            if (back.rendered) {
+                glDeleteSync(back.rendered);
+            }
+            back.rendered = rendered;
+            back.frame_width = width;
+            back.frame_height = height;
+            front_ = write_index_;
+        }
         write_index_ = (write_index_ + 1) % NUM_BUFFERS;
-
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-#ifdef _WIN32
-        wgl_->makeCurrent(nullptr);
-#else
-        egl_->makeCurrent(EGL_NO_CONTEXT);
-#endif
         has_rendered_.store(true);
     } else {
         // Direct rendering to default framebuffer
@@ -233,19 +274,40 @@ void OpenGLRenderer::composite(int width, int height) {
         glGenVertexArrays(1, &composite_vao_);
     }
 
-    // Use atomically published front texture
-    GLuint tex = front_texture_.load();
-    if (!tex) return;
+    // Held through the draw so the video thread can't recycle the slot before
+    // its release fence exists (only GL command submission happens under it)
+    std::lock_guard<std::mutex> lock(fbo_mutex_);
+    if (front_ < 0) return;
+    Slot& front = slots_[front_];
+
+    // Server-side wait: the GPU orders our read after the video render,
+    // this thread doesn't block
+    if (front.rendered) {
+        glWaitSync(front.rendered, 0, GL_TIMEOUT_IGNORED);
+    }
 
     glUseProgram(composite_program_);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    glBindTexture(GL_TEXTURE_2D, front.fb.texture);
     glUniform1i(glGetUniformLocation(composite_program_, "videoTex"), 0);
+    // Only the part of the pooled storage holding the frame is sampled
+    glUniform2f(glGetUniformLocation(composite_program_, "texScale"),
+                static_cast<float>(front.frame_width) / front.fb.width,
+                static_cast<float>(front.frame_height) / front.fb.height);
 
     glBindVertexArray(composite_vao_);
     glDrawArrays(GL_TRIANGLES, 0, 3);
     glBindVertexArray(0);
     glUseProgram(0);
+
+    // The video context waits on this before rendering into the slot again
+    if (haveSync()) {
+        if (front.released) {
+            glDeleteSync(front.released);
+        }
+        front.released = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();  // Fences are only visible to other contexts once flushed
+    }
 }
 
 void OpenGLRenderer::resize(int width, int height) {
@@ -266,6 +328,7 @@ void OpenGLRenderer::cleanup() {
 #endif
 
     destroyFBO();
+    pool_.clear();
 
     if (composite_program_) {
         glDeleteProgram(composite_program_);
@@ -10,6 +10,7 @@
 
 #include <atomic>
 #include <mutex>
+#include "compositor/gl_surface_pool.h"
 
 class MpvPlayerGL;
 class EGLContext_;
@@ -30,18 +31,21 @@ public:
     bool hasFrame() const override;
     bool render(int width, int height) override;
     void composite(int width, int height) override;
+    bool compositesToWindow() const override { return threaded_ && has_rendered_.load(); }
 
     void setVisible(bool) override {}
     void resize(int width, int height) override;
     void setDestinationSize(int, int) override {}
     void setColorspace() override {}
     void cleanup() override;
+    void renderThreadExiting() override;
     float getClearAlpha(bool video_ready) const override;
     bool isHdr() const override { return false; }
 
 private:
     void createFBO(int width, int height);
     void destroyFBO();
+    bool makeThreadCurrent();
 
     MpvPlayerGL* player_;
     bool threaded_ = false;
@@ -54,14 +58,26 @@ private:
     EGLContext shared_ctx_ = EGL_NO_CONTEXT;
 #endif
 
-    // Double-buffered FBOs for lock-free rendering
-    static constexpr int NUM_BUFFERS = 2;
-    struct FBOBuffer {
-        GLuint fbo = 0;
-        GLuint texture = 0;
-        GLuint depth_rb = 0;
+    // Shared context stays current on the render thread from its first
+    // render until renderThreadExiting (render thread only)
+    bool thread_current_ = false;
+
+    // Triple-buffered FBO ring handed between contexts with fences instead of
+    // glFinish: the video context fences each rendered frame and the main
+    // context waits on it server-side before sampling; the main context fences
+    // its last read of a slot and the video context waits on that before
+    // rendering into it again. Storage comes from a size-bucketed pool on the
+    // shared context, so resizing the window reuses it while the video fits.
+    static constexpr int NUM_BUFFERS = 3;
+    struct Slot {
+        GLSurfacePool::Framebuffer fb;
+        int frame_width = 0;   // Size of the frame last rendered into fb
+        int frame_height = 0;
+        GLsync rendered = nullptr;  // Video context: frame complete
+        GLsync released = nullptr;  // Main context: last composite read done
     };
-    FBOBuffer buffers_[NUM_BUFFERS];
+    Slot slots_[NUM_BUFFERS];
+    GLSurfacePool pool_;   // Render thread only (FBOs aren't shared between contexts)
     int write_index_ = 0;  // Render thread writes here
     int fbo_width_ = 0;
     int fbo_height_ = 0;
@@ -69,7 +85,7 @@ private:
     GLuint composite_program_ = 0;
     GLuint composite_vao_ = 0;
 
-    std::mutex fbo_mutex_;
+    std::mutex fbo_mutex_;  // Guards front_ and the slot fences
     std::atomic<bool> has_rendered_{false};
-    std::atomic<GLuint> front_texture_{0};  // Main thread reads this
+    int front_ = -1;  // Slot the main thread composites (-1 = none)
 };
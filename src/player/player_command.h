@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+// Player/media-session commands posted to the main loop (from the CEF UI
+// thread and the media session backends)
+enum class PlayerOp : uint8_t {
+    // Player control from the web UI
+    Load,             // text = url, metadata = JSON, int_arg = start ms
+    Stop,
+    Pause,
+    Play,
+    PlayPause,
+    Seek,             // int_arg = ms
+    Volume,           // int_arg = 0-100
+    Mute,             // int_arg = 0/1
+    Speed,            // int_arg = rate * 1000
+    Subtitle,         // int_arg = sid (-1 = off)
+    Audio,            // int_arg = aid (-1 = off)
+    AudioDelay,       // double_arg = seconds
+    // Media session state reported by the web UI
+    MediaMetadata,    // text = JSON
+    MediaPosition,    // int_arg = ms
+    MediaState,       // int_arg = PlaybackState
+    MediaArtwork,     // text = URI
+    MediaQueue,       // int_arg: bit 0 = canNext, bit 1 = canPrev
+    MediaNotifyRate,  // double_arg = rate
+    MediaSeeked,      // int_arg = ms
+    // Media session controls routed back to the web UI
+    MediaAction,      // int_arg = MediaAction
+    MediaSeek,        // int_arg = ms
+    MediaRate,        // double_arg = rate
+
+    Count
+};
+
+constexpr size_t kPlayerOpCount = static_cast<size_t>(PlayerOp::Count);
+
+// Latest-wins ops: of several queued back to back, only the last matters
+constexpr bool playerOpCoalesces(PlayerOp op) {
+    return op == PlayerOp::Seek || op == PlayerOp::Volume || op == PlayerOp::Speed ||
+           op == PlayerOp::MediaPosition || op == PlayerOp::MediaSeek;
+}
+
+// Media session transport controls (PlayerOp::MediaAction)
+enum class MediaAction : uint8_t { Play, Pause, PlayPause, Stop, Next, Previous };
+
+// Scalars inline; text fields are only set by the rare commands that carry
+// strings, and short ones stay in std::string's inline buffer
+struct PlayerCommand {
+    PlayerOp op = PlayerOp::Stop;
+    int int_arg = 0;
+    double double_arg = 0.0;
+    std::string text;
+    std::string metadata;
+
+    static PlayerCommand make(PlayerOp op, int int_arg = 0) {
+        PlayerCommand cmd;
+        cmd.op = op;
+        cmd.int_arg = int_arg;
+        return cmd;
+    }
+    static PlayerCommand makeDouble(PlayerOp op, double value) {
+        PlayerCommand cmd;
+        cmd.op = op;
+        cmd.double_arg = value;
+        return cmd;
+    }
+    static PlayerCommand makeText(PlayerOp op, std::string text, int int_arg = 0,
+                                  std::string metadata = {}) {
+        PlayerCommand cmd;
+        cmd.op = op;
+        cmd.int_arg = int_arg;
+        cmd.text = std::move(text);
+        cmd.metadata = std::move(metadata);
+        return cmd;
+    }
+};
+
+// Bounded multi-producer/single-consumer command queue (Vyukov's bounded
+// MPMC ring: one sequence number per cell, no locks). post() wakes the main
+// loop only when no wake is already outstanding, so a burst of commands
+// costs one wake event.
+class PlayerCommandQueue {
+public:
+    static constexpr size_t kCapacity = 256;
+
+    PlayerCommandQueue() {
+        for (size_t i = 0; i < kCapacity; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Wakes the main loop (set before commands are posted)
+    void setWakeCallback(std::function<void()> cb) { wake_ = std::move(cb); }
+
+    // Any thread. False (command dropped) only if the main loop has fallen
+    // kCapacity commands behind.
+    bool post(PlayerCommand&& cmd) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & (kCapacity - 1)];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->cmd = std::move(cmd);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        if (wake_ && !wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+            wake_();
+        }
+        return true;
+    }
+
+    // Main thread: call before draining so commands posted during the drain
+    // wake the loop again
+    void clearWake() { wake_pending_.store(false, std::memory_order_release); }
+
+    // Main thread
+    bool pop(PlayerCommand& out) {
+        size_t pos = dequeue_pos_;
+        Cell* cell = &cells_[pos & (kCapacity - 1)];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) return false;  // Empty
+        out = std::move(cell->cmd);
+        cell->sequence.store(pos + kCapacity, std::memory_order_release);
+        dequeue_pos_ = pos + 1;
+        return true;
+    }
+
+    // Main thread: something may be waiting (cheap check for the idle decision)
+    bool pending() const {
+        const Cell& cell = cells_[dequeue_pos_ & (kCapacity - 1)];
+        return cell.sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        PlayerCommand cmd;
+    };
+
+    Cell cells_[kCapacity];
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;  // Single consumer
+    alignas(64) std::atomic<bool> wake_pending_{false};
+    std::function<void()> wake_;
+};
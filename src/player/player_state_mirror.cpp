@@ -0,0 +1,155 @@
+#include "player/player_state_mirror.h"
+#include "logging.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::is_trivially_copyable<PlayerStateSnapshot>::value,
+              "PlayerStateSnapshot is copied byte-wise across processes");
+
+static constexpr uint32_t kMagic = 0x4a4d5053;  // "JMPS"
+static constexpr uint32_t kVersion = 1;
+static constexpr int kReadRetries = 64;
+
+struct PlayerStateMirror::Block {
+    uint32_t magic;
+    uint32_t version;
+    // Odd while the writer is updating; 0 until the first publish
+    alignas(64) std::atomic<uint32_t> sequence;
+    alignas(64) PlayerStateSnapshot state;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "seqlock counter must be lock-free to work across processes");
+
+PlayerStateMirror::~PlayerStateMirror() {
+    close();
+}
+
+bool PlayerStateMirror::create() {
+    close();
+#ifdef _WIN32
+    name_ = "Local\\jellyfin-desktop-state-" + std::to_string(GetCurrentProcessId());
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                        sizeof(Block), name_.c_str());
+    if (!mapping) {
+        LOG_WARN(LOG_MAIN, "Player state mirror: CreateFileMapping failed: %lu", GetLastError());
+        return false;
+    }
+    void* mem = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Block));
+    if (!mem) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+#else
+    name_ = "/jellyfin-desktop-state-" + std::to_string(getpid());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        // Left over from a crashed process that had our pid
+        shm_unlink(name_.c_str());
+        fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0) {
+        LOG_WARN(LOG_MAIN, "Player state mirror: shm_open failed: %s", strerror(errno));
+        return false;
+    }
+    void* mem = MAP_FAILED;
+    if (ftruncate(fd, sizeof(Block)) == 0) {
+        mem = mmap(nullptr, sizeof(Block), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        LOG_WARN(LOG_MAIN, "Player state mirror: mapping failed: %s", strerror(errno));
+        shm_unlink(name_.c_str());
+        return false;
+    }
+#endif
+    block_ = new (mem) Block();
+    block_->magic = kMagic;
+    block_->version = kVersion;
+    block_->sequence.store(0, std::memory_order_release);
+    owner_ = true;
+    LOG_DEBUG(LOG_MAIN, "Player state mirror: %s (%zu bytes)", name_.c_str(), sizeof(Block));
+    return true;
+}
+
+bool PlayerStateMirror::open(const std::string& name) {
+    close();
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (!mapping) return false;
+    void* mem = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(Block));
+    if (!mem) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+#else
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    void* mem = mmap(nullptr, sizeof(Block), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+#endif
+    block_ = static_cast<Block*>(mem);
+    name_ = name;
+    if (block_->magic != kMagic || block_->version != kVersion) {
+        LOG_WARN(LOG_MAIN, "Player state mirror: %s has an unexpected layout", name.c_str());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PlayerStateMirror::close() {
+    if (!block_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(block_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    munmap(block_, sizeof(Block));
+    if (owner_) {
+        shm_unlink(name_.c_str());
+    }
+#endif
+    block_ = nullptr;
+    owner_ = false;
+    name_.clear();
+}
+
+void PlayerStateMirror::publish(const PlayerStateSnapshot& state) {
+    if (!block_ || !owner_) return;
+    uint32_t seq = block_->sequence.load(std::memory_order_relaxed);
+    block_->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&block_->state, &state, sizeof(state));
+    block_->sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool PlayerStateMirror::read(PlayerStateSnapshot& out) const {
+    if (!block_) return false;
+    for (int i = 0; i < kReadRetries; i++) {
+        uint32_t before = block_->sequence.load(std::memory_order_acquire);
+        if (before == 0) return false;  // Never published
+        if (before & 1) continue;       // Write in progress
+        std::memcpy(&out, &block_->state, sizeof(out));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block_->sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Player state as seen by the page. Plain data so it can live in shared
+// memory and be copied under the seqlock.
+struct PlayerStateSnapshot {
+    static constexpr int kMaxRanges = 32;
+    struct Range {
+        int64_t start;
+        int64_t end;
+    };
+
+    double position_ms = 0.0;
+    double duration_ms = 0.0;
+    double rate = 1.0;
+    int volume = 100;
+    bool paused = true;
+    bool buffering = false;
+    bool muted = false;
+    int range_count = 0;
+    Range ranges[kMaxRanges];  // Buffered, 100 ns ticks (MpvPlayer::BufferedRange)
+};
+
+// Seqlock-protected PlayerStateSnapshot in a named shared memory block.
+// The browser process creates and publishes it once per main loop
+// iteration; renderer processes map it read-only so page script can read
+// the current state without a process message.
+class PlayerStateMirror {
+public:
+    PlayerStateMirror() = default;
+    ~PlayerStateMirror();
+    PlayerStateMirror(const PlayerStateMirror&) = delete;
+    PlayerStateMirror& operator=(const PlayerStateMirror&) = delete;
+
+    // Browser process: create a block named after this process
+    bool create();
+    // Renderer process: map the block created by the browser process
+    bool open(const std::string& name);
+    void close();
+
+    bool isOpen() const { return block_ != nullptr; }
+    const std::string& name() const { return name_; }
+
+    // Single writer (browser main thread)
+    void publish(const PlayerStateSnapshot& state);
+
+    // Any thread/process. False if nothing was published yet or the writer
+    // kept the block busy for every retry.
+    bool read(PlayerStateSnapshot& out) const;
+
+private:
+    struct Block;
+
+    Block* block_ = nullptr;
+    std::string name_;
+    bool owner_ = false;
+#ifdef _WIN32
+    void* mapping_ = nullptr;
+#endif
+};
@@ -0,0 +1,122 @@
+#include "video_pipeline.h"
+#include "video_renderer.h"
+#include "mpv/mpv_player.h"
+#include "logging.h"
+#include "trace.h"
+
+#ifdef _WIN32
+#include "context/wgl_context.h"
+#elif !defined(__APPLE__)
+#include "context/egl_context.h"
+#endif
+
+namespace {
+    std::chrono::seconds g_idle_timeout{300};
+}
+
+void VideoPipeline::setIdleTimeout(std::chrono::seconds timeout) {
+    g_idle_timeout = timeout;
+}
+
+#ifdef __APPLE__
+VideoPipeline::VideoPipeline(SDL_Window* window) : window_(window) {}
+#elif defined(_WIN32)
+VideoPipeline::VideoPipeline(SDL_Window* window, WGLContext* wgl) : window_(window), wgl_(wgl) {}
+#else
+VideoPipeline::VideoPipeline(SDL_Window* window, EGLContext_* egl) : window_(window), egl_(egl) {}
+#endif
+
+VideoPipeline::~VideoPipeline() {
+    release();
+}
+
+void VideoPipeline::restoreContext() {
+#ifdef _WIN32
+    wgl_->makeCurrentMain();
+#elif !defined(__APPLE__)
+    egl_->makeCurrentMain();
+#endif
+}
+
+bool VideoPipeline::acquire(int width, int height) {
+    last_used_ = Clock::now();
+    if (created()) {
+        return true;
+    }
+
+    TRACE_SPAN("video.acquire");
+    auto start = Clock::now();
+#ifdef __APPLE__
+    stack_ = VideoStack::create(window_, width, height);
+#elif defined(_WIN32)
+    stack_ = VideoStack::create(window_, width, height, wgl_);
+#else
+    stack_ = VideoStack::create(window_, width, height, egl_);
+#endif
+    if (!stack_.player || !stack_.renderer) {
+        LOG_ERROR(LOG_VIDEO, "Video stack creation failed");
+        stack_.renderer.reset();
+        stack_.player.reset();
+        VideoStack::cleanupStatics();
+        restoreContext();
+        return false;
+    }
+    restoreContext();
+
+    events_.start(stack_.player.get());
+#ifndef __APPLE__
+    // Windows and Linux use threaded video rendering
+    // Windows: OpenGL with shared WGL context + FBO
+    // Linux/Wayland: Vulkan subsurface
+    // Linux/X11: OpenGL with shared EGL context + FBO
+    controller_.startThreaded(stack_.renderer.get());
+    stack_.player->setRedrawCallback([this]() {
+        controller_.notify();
+    });
+#endif
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    LOG_INFO(LOG_VIDEO, "Video stack created in %.0f ms", ms);
+    last_used_ = Clock::now();
+    return true;
+}
+
+void VideoPipeline::release() {
+    if (!created()) {
+        return;
+    }
+
+    TRACE_SPAN("video.release");
+#ifndef __APPLE__
+    controller_.stop();
+#endif
+    events_.stop();
+    stack_.player->cleanup();
+    stack_.renderer->cleanup();
+    stack_.renderer.reset();  // Renderer holds a pointer to the player
+    stack_.player.reset();
+    VideoStack::cleanupStatics();
+    restoreContext();
+    LOG_INFO(LOG_VIDEO, "Video stack released");
+}
+
+bool VideoPipeline::idleExpired(bool playing, int& wait_ms) {
+    wait_ms = -1;
+    if (!created() || g_idle_timeout.count() == 0) {
+        return false;
+    }
+    auto now = Clock::now();
+    if (playing) {
+        last_used_ = now;
+        return false;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        last_used_ + g_idle_timeout - now).count();
+    if (remaining <= 0) {
+        LOG_INFO(LOG_VIDEO, "Nothing played for %llds, releasing video stack",
+                 static_cast<long long>(g_idle_timeout.count()));
+        return true;
+    }
+    wait_ms = static_cast<int>(remaining);
+    return false;
+}
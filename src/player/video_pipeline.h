@@ -0,0 +1,72 @@
+#pragma once
+
+#include "video_stack.h"
+#include "mpv_event_thread.h"
+#ifndef __APPLE__
+#include "video_render_controller.h"
+#endif
+#include <chrono>
+
+// Video stack created on demand instead of at startup: nothing video-related
+// exists (libmpv isn't even loaded) until acquire(), normally from the first
+// playerLoad. Once nothing has played for the idle timeout the main loop
+// release()s it all again, and the next load starts over. The event thread
+// and render controller objects live as long as the pipeline so callers can
+// hold references; only their threads start and stop with the stack.
+class VideoPipeline {
+public:
+#ifdef __APPLE__
+    explicit VideoPipeline(SDL_Window* window);
+#elif defined(_WIN32)
+    VideoPipeline(SDL_Window* window, WGLContext* wgl);
+#else
+    VideoPipeline(SDL_Window* window, EGLContext_* egl);
+#endif
+    ~VideoPipeline();
+    VideoPipeline(const VideoPipeline&) = delete;
+    VideoPipeline& operator=(const VideoPipeline&) = delete;
+
+    // Time without playback before release is due (0 = never, default 5 min)
+    static void setIdleTimeout(std::chrono::seconds timeout);
+
+    // Main thread. Create the stack if needed and start its threads; width
+    // and height are the logical window size. Also restarts the idle timer.
+    bool acquire(int width, int height);
+    // Main thread. Stop the threads and destroy the stack (no-op when not created)
+    void release();
+    bool created() const { return stack_.player != nullptr; }
+
+    // Null while not created
+    MpvPlayer* player() const { return stack_.player.get(); }
+    VideoRenderer* renderer() const { return stack_.renderer.get(); }
+
+    MpvEventThread& events() { return events_; }
+#ifndef __APPLE__
+    VideoRenderController& controller() { return controller_; }
+#endif
+
+    // Main loop, once per iteration: true once the stack has gone unused for
+    // the idle timeout (the caller then releases it). wait_ms: time left
+    // until then, -1 when no release is pending.
+    bool idleExpired(bool playing, int& wait_ms);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Leave the main GL context current again (renderer setup/cleanup
+    // switches to its shared context)
+    void restoreContext();
+
+    SDL_Window* window_;
+#ifdef _WIN32
+    WGLContext* wgl_;
+#elif !defined(__APPLE__)
+    EGLContext_* egl_;
+#endif
+    VideoStack stack_;
+    MpvEventThread events_;
+#ifndef __APPLE__
+    VideoRenderController controller_;
+#endif
+    Clock::time_point last_used_;
+};
@@ -1,6 +1,7 @@
 #include "video_render_controller.h"
 #include "video_renderer.h"
 #include "logging.h"
+#include "trace.h"
 #include <chrono>
 
 VideoRenderController::~VideoRenderController() {
@@ -32,6 +33,10 @@ void VideoRenderController::stop() {
             thread_.join();
         }
     }
+    // Restartable with another renderer; until then nothing touches this one
+    renderer_ = nullptr;
+    active_.store(false);
+    video_ready_.store(false);
     LOG_INFO(LOG_VIDEO, "video render thread stopped");
 }
 
@@ -50,7 +55,7 @@ void VideoRenderController::render(int width, int height) {
 }
 
 float VideoRenderController::getClearAlpha() const {
-    return renderer_->getClearAlpha(video_ready_.load());
+    return renderer_ ? renderer_->getClearAlpha(video_ready_.load()) : 1.0f;
 }
 
 void VideoRenderController::requestResize(int width, int height) {
@@ -62,7 +67,7 @@ void VideoRenderController::requestResize(int width, int height) {
         }
         resize_pending_.store(true);
         cv_.notify_one();
-    } else {
+    } else if (renderer_) {
         // Sync mode: resize immediately
         renderer_->resize(width, height);
     }
@@ -72,13 +77,14 @@ void VideoRenderController::requestSetColorspace() {
     if (threaded_) {
         colorspace_pending_.store(true);
         notify();
-    } else {
+    } else if (renderer_) {
         // Sync mode: set immediately
         renderer_->setColorspace();
     }
 }
 
 void VideoRenderController::threadFunc() {
+    TraceRecorder::setThreadName("Video render");
     while (running_.load()) {
         // Handle resize first
         if (resize_pending_.exchange(false)) {
@@ -99,8 +105,12 @@ void VideoRenderController::threadFunc() {
             int w = width_.load();
             int h = height_.load();
             if (w > 0 && h > 0 && renderer_->hasFrame()) {
+                TRACE_SPAN("video.render");
                 if (renderer_->render(w, h)) {
-                    video_ready_.store(true);
+                    bool first = !video_ready_.exchange(true);
+                    if (on_frame_ && (first || renderer_->compositesToWindow())) {
+                        on_frame_();
+                    }
                 }
             }
         }
@@ -113,4 +123,5 @@ void VideoRenderController::threadFunc() {
                    colorspace_pending_.load() || frame_notified_.load();
         });
     }
+    renderer_->renderThreadExiting();
 }
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 
 class VideoRenderer;
 
@@ -20,6 +21,8 @@ public:
     // Initialize for synchronous mode (X11/OpenGL - must use main thread)
     void startSync(VideoRenderer* renderer);
 
+    // Stop rendering and forget the renderer (start again with a new one).
+    // Until then getClearAlpha() is opaque and requests are held or dropped.
     void stop();
 
     // Render video frame - threaded: updates dimensions, sync: renders directly
@@ -34,6 +37,11 @@ public:
     // Request colorspace setup (executed on render thread, or immediately in sync mode)
     void requestSetColorspace();
 
+    // Called on the render thread when a rendered frame needs the main loop to
+    // draw: the renderer composites into the window, or this is the first frame
+    // (clear alpha changes). Set before startThreaded.
+    void setFrameCallback(std::function<void()> cb) { on_frame_ = std::move(cb); }
+
     // Enable/disable rendering
     void setActive(bool active) {
         active_.store(active);
@@ -56,6 +64,7 @@ private:
     void threadFunc();
 
     VideoRenderer* renderer_ = nullptr;
+    std::function<void()> on_frame_;
     std::thread thread_;
     bool threaded_ = false;
     std::atomic<bool> running_{false};
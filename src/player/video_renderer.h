@@ -10,6 +10,8 @@ public:
 
     // Composite video to screen (for threaded OpenGL renderers)
     virtual void composite(int width, int height) { (void)width; (void)height; }
+    // composite() currently draws into the main window surface (no partial redraws)
+    virtual bool compositesToWindow() const { return false; }
 
     // Subsurface lifecycle (no-op for composite renderers)
     virtual void setVisible(bool visible) = 0;
@@ -17,6 +19,8 @@ public:
     virtual void setDestinationSize(int width, int height) = 0;  // HiDPI logical size
     virtual void setColorspace() = 0;
     virtual void cleanup() = 0;
+    // Called on the render thread right before it exits (threaded mode)
+    virtual void renderThreadExiting() {}
 
     // For frame clear decision
     virtual float getClearAlpha(bool video_ready) const = 0;
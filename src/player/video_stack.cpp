@@ -1,6 +1,7 @@
 #include "video_stack.h"
 #include "video_renderer.h"
 #include "mpv/mpv_player.h"
+#include "mpv/mpv_library.h"
 #include "logging.h"
 #include <SDL3/SDL.h>
 #include <cstdlib>
@@ -26,6 +27,9 @@ namespace {
 
 VideoStack VideoStack::create(SDL_Window* window, int width, int height) {
     VideoStack stack;
+    if (!MpvLibrary::load()) {
+        return stack;
+    }
 
     // Register atexit handler to clean up before static destructors
     // (handles Cmd+Q via NSApplication terminate: which calls exit())
@@ -74,6 +78,9 @@ VideoStack VideoStack::create(SDL_Window* window, int width, int height) {
 VideoStack VideoStack::create(SDL_Window* window, int width, int height, WGLContext* wgl) {
     (void)window; (void)width; (void)height;
     VideoStack stack;
+    if (!MpvLibrary::load()) {
+        return stack;
+    }
 
     auto player = std::make_unique<MpvPlayerGL>();
     if (!player->init(wgl)) {
@@ -106,10 +113,27 @@ VideoStack VideoStack::create(SDL_Window* window, int width, int height, WGLCont
 // Internal storage for Wayland subsurface (must outlive renderer)
 namespace {
     std::unique_ptr<WaylandSubsurface> g_wayland_subsurface;
+    VideoPresentMode g_present_mode = VideoPresentMode::Fifo;
+
+    VkPresentModeKHR toVkPresentMode(VideoPresentMode mode) {
+        switch (mode) {
+        case VideoPresentMode::FifoRelaxed: return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        case VideoPresentMode::Mailbox: return VK_PRESENT_MODE_MAILBOX_KHR;
+        case VideoPresentMode::Fifo: break;
+        }
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+}
+
+void VideoStack::setPresentMode(VideoPresentMode mode) {
+    g_present_mode = mode;
 }
 
 VideoStack VideoStack::create(SDL_Window* window, int width, int height, EGLContext_* egl) {
     VideoStack stack;
+    if (!MpvLibrary::load()) {
+        return stack;
+    }
 
     // Detect Wayland vs X11 at runtime
     const char* videoDriver = SDL_GetCurrentVideoDriver();
@@ -128,6 +152,7 @@ VideoStack VideoStack::create(SDL_Window* window, int width, int height, EGLCont
 
         int physical_w, physical_h;
         SDL_GetWindowSizeInPixels(window, &physical_w, &physical_h);
+        g_wayland_subsurface->setPresentMode(toVkPresentMode(g_present_mode));
         if (!g_wayland_subsurface->createSwapchain(physical_w, physical_h)) {
             LOG_ERROR(LOG_PLATFORM, "Fatal: Wayland subsurface swapchain failed");
             return stack;
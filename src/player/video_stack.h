@@ -10,6 +10,13 @@ struct SDL_Window;
 class WGLContext;
 #elif !defined(__APPLE__)
 class EGLContext_;
+
+// Swapchain present mode for the Wayland video subsurface
+enum class VideoPresentMode {
+    Fifo,          // Vsync, never tears (default)
+    FifoRelaxed,   // Vsync, tears instead of waiting when a frame is late
+    Mailbox        // Newest frame replaces the queued one, no tearing
+};
 #endif
 
 // Video subsystem - owns player and renderer
@@ -17,7 +24,8 @@ struct VideoStack {
     std::unique_ptr<MpvPlayer> player;
     std::unique_ptr<VideoRenderer> renderer;
 
-    // Factory - creates platform-appropriate video stack
+    // Factory - creates platform-appropriate video stack (loads libmpv on
+    // first use; empty stack if that or any part fails)
 #ifdef __APPLE__
     static VideoStack create(SDL_Window* window, int width, int height);
 #elif defined(_WIN32)
@@ -26,6 +34,11 @@ struct VideoStack {
     static VideoStack create(SDL_Window* window, int width, int height, EGLContext_* egl);
 #endif
 
+#if !defined(__APPLE__) && !defined(_WIN32)
+    // Present mode for the Wayland subsurface (call before create)
+    static void setPresentMode(VideoPresentMode mode);
+#endif
+
     // Cleanup static resources (call before program exit to avoid static destructor issues)
     static void cleanupStatics();
 };
@@ -1,105 +1,323 @@
 #include "settings.h"
-#include <fstream>
-#include <sstream>
+#include "json_reader.h"
+#include "logging.h"
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
-#include <thread>
+#include <string_view>
 #ifdef _WIN32
+#include <windows.h>
 #include <direct.h>
+#include <io.h>
 #define MKDIR(path) _mkdir(path)
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #define MKDIR(path) mkdir(path, 0755)
 #endif
 
+// How long the writer waits for more changes before writing
+static constexpr auto kSaveDebounce = std::chrono::milliseconds(500);
+
 Settings& Settings::instance() {
     static Settings instance;
     return instance;
 }
 
-std::string Settings::getConfigPath() {
-    std::string config_dir;
+Settings::~Settings() {
+    flush();
+}
+
+const std::string& Settings::configPath() {
+    std::call_once(path_once_, [this]() {
+        std::string config_dir;
 
 #ifdef _WIN32
-    const char* appdata = std::getenv("APPDATA");
-    if (appdata && appdata[0]) {
-        config_dir = appdata;
-    } else {
-        config_dir = "C:\\";
-    }
-    config_dir += "\\jellyfin-desktop-cef";
+        const char* appdata = std::getenv("APPDATA");
+        if (appdata && appdata[0]) {
+            config_dir = appdata;
+        } else {
+            config_dir = "C:\\";
+        }
+        config_dir += "\\jellyfin-desktop-cef";
 #else
-    const char* xdg_config = std::getenv("XDG_CONFIG_HOME");
-    if (xdg_config && xdg_config[0]) {
-        config_dir = xdg_config;
-    } else {
-        const char* home = std::getenv("HOME");
-        if (home) {
-            config_dir = std::string(home) + "/.config";
+        const char* xdg_config = std::getenv("XDG_CONFIG_HOME");
+        if (xdg_config && xdg_config[0]) {
+            config_dir = xdg_config;
         } else {
-            config_dir = "/tmp";
+            const char* home = std::getenv("HOME");
+            if (home) {
+                config_dir = std::string(home) + "/.config";
+            } else {
+                config_dir = "/tmp";
+            }
         }
-    }
-    config_dir += "/jellyfin-desktop-cef";
+        config_dir += "/jellyfin-desktop-cef";
 #endif
 
-    MKDIR(config_dir.c_str());
+        MKDIR(config_dir.c_str());
+        config_path_ = config_dir + "/settings.json";
+    });
+    return config_path_;
+}
 
-    return config_dir + "/settings.json";
+static WindowGeometry parseWindowGeometry(std::string_view json) {
+    WindowGeometry g;
+    bool has_x = false, has_y = false;
+    JsonReader reader(json);
+    std::string_view key;
+    JsonValue value;
+    while (reader.nextMember(key, value)) {
+        if (key == "width") {
+            g.width = static_cast<int>(value.toInt(g.width));
+        } else if (key == "height") {
+            g.height = static_cast<int>(value.toInt(g.height));
+        } else if (key == "x" && value.isNumber()) {
+            g.x = static_cast<int>(value.toInt());
+            has_x = true;
+        } else if (key == "y" && value.isNumber()) {
+            g.y = static_cast<int>(value.toInt());
+            has_y = true;
+        } else if (key == "maximized") {
+            g.maximized = value.toBool();
+        } else if (key == "display" && value.isString()) {
+            g.display = value.str();
+        }
+    }
+    g.has_position = has_x && has_y;
+    if (g.width <= 0 || g.height <= 0) {
+        g.width = WindowGeometry::kDefaultWidth;
+        g.height = WindowGeometry::kDefaultHeight;
+    }
+    return g;
 }
 
 bool Settings::load() {
-    std::ifstream file(getConfigPath());
-    if (!file.is_open()) {
+    const std::string& path = configPath();
+
+    // Map the file instead of copying it through a stream
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    size_t size = static_cast<size_t>(file_size.QuadPart);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) {
         return false;
     }
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+#endif
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
-
-    // Simple JSON parsing for serverUrl
-    size_t pos = content.find("\"serverUrl\"");
-    if (pos != std::string::npos) {
-        pos = content.find(':', pos);
-        if (pos != std::string::npos) {
-            pos = content.find('"', pos);
-            if (pos != std::string::npos) {
-                size_t end = content.find('"', pos + 1);
-                if (end != std::string::npos) {
-                    server_url_ = content.substr(pos + 1, end - pos - 1);
-                }
-            }
+    std::string server_url;
+    WindowGeometry window;
+    int version = 0;
+
+    JsonReader reader(std::string_view(static_cast<const char*>(data), size));
+    std::string_view key;
+    JsonValue value;
+    while (reader.nextMember(key, value)) {
+        if (key == "version") {
+            version = static_cast<int>(value.toInt());
+        } else if (key == "serverUrl" && value.isString()) {
+            server_url = value.str();
+        } else if (key == "window" && value.type == JsonValue::Type::Object) {
+            window = parseWindowGeometry(value.raw);
         }
     }
+    bool ok = !reader.failed();
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+
+    if (!ok) {
+        LOG_WARN(LOG_MAIN, "Settings: %s is malformed, using defaults", path.c_str());
+        return false;
+    }
+    if (version > kVersion) {
+        LOG_WARN(LOG_MAIN, "Settings: version %d is newer than %d, reading known keys only",
+                 version, kVersion);
+    }
 
+    std::lock_guard<std::mutex> lock(mutex_);
+    server_url_ = std::move(server_url);
+    window_ = std::move(window);
     return true;
 }
 
-bool Settings::save() {
-    std::ofstream file(getConfigPath());
-    if (!file.is_open()) {
+std::string Settings::serverUrl() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return server_url_;
+}
+
+void Settings::setServerUrl(const std::string& url) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    server_url_ = url;
+}
+
+WindowGeometry Settings::windowGeometry() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return window_;
+}
+
+bool Settings::setWindowGeometry(const WindowGeometry& geometry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (window_ == geometry) {
         return false;
     }
+    window_ = geometry;
+    return true;
+}
+
+// Caller holds mutex_
+std::string Settings::serialize() const {
+    std::string out;
+    out.reserve(256 + server_url_.size());
+    out += "{\n";
+    out += "  \"version\": " + std::to_string(kVersion) + ",\n";
+    out += "  \"serverUrl\": \"" + jsonEscape(server_url_) + "\",\n";
+    out += "  \"window\": {\n";
+    out += "    \"width\": " + std::to_string(window_.width) + ",\n";
+    out += "    \"height\": " + std::to_string(window_.height) + ",\n";
+    if (window_.has_position) {
+        out += "    \"x\": " + std::to_string(window_.x) + ",\n";
+        out += "    \"y\": " + std::to_string(window_.y) + ",\n";
+    }
+    out += "    \"maximized\": ";
+    out += window_.maximized ? "true" : "false";
+    out += ",\n";
+    out += "    \"display\": \"" + jsonEscape(window_.display) + "\"\n";
+    out += "  }\n";
+    out += "}\n";
+    return out;
+}
 
-    file << "{\n";
-    file << "  \"serverUrl\": \"" << server_url_ << "\"\n";
-    file << "}\n";
+// Caller holds write_mutex_
+bool Settings::writeFile(const std::string& content) {
+    const std::string& path = configPath();
+    std::string tmp_path = path + ".tmp";
 
-    return true;
+    // Write a sibling file and rename it over the old one, so a crash
+    // mid-write never leaves a truncated settings.json behind
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        LOG_WARN(LOG_MAIN, "Settings: cannot write %s", tmp_path.c_str());
+        return false;
+    }
+    bool ok = std::fwrite(content.data(), 1, content.size(), file) == content.size() &&
+              std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(tmp_path.c_str(), path.c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    ok = ok && std::rename(tmp_path.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) {
+        LOG_WARN(LOG_MAIN, "Settings: saving %s failed", path.c_str());
+        std::remove(tmp_path.c_str());
+    }
+    return ok;
+}
+
+bool Settings::save() {
+    // Snapshot under write_mutex_ so writes land in snapshot order
+    std::lock_guard<std::mutex> write_lock(write_mutex_);
+    std::string content;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        content = serialize();
+        dirty_ = false;  // Supersedes a pending background write
+    }
+    return writeFile(content);
 }
 
 void Settings::saveAsync() {
-    // Capture current state and save in background
-    std::string url = server_url_;
-    std::string path = getConfigPath();
-
-    std::thread([this, url, path]() {
-        std::lock_guard<std::mutex> lock(save_mutex_);
-        std::ofstream file(path);
-        if (file.is_open()) {
-            file << "{\n";
-            file << "  \"serverUrl\": \"" << url << "\"\n";
-            file << "}\n";
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+        return;
+    }
+    dirty_ = true;
+    if (!writer_.joinable()) {
+        writer_ = std::thread(&Settings::writerLoop, this);
+    }
+    writer_cv_.notify_one();
+}
+
+void Settings::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        writer_cv_.wait(lock, [this]() { return dirty_ || stop_; });
+        if (!dirty_) {
+            break;
         }
-    }).detach();
+        // Let a burst of changes settle; stop cuts the wait short
+        writer_cv_.wait_for(lock, kSaveDebounce, [this]() { return stop_; });
+        lock.unlock();
+        {
+            // Same lock order as save(): write_mutex_, then mutex_
+            std::lock_guard<std::mutex> write_lock(write_mutex_);
+            std::string content;
+            {
+                std::lock_guard<std::mutex> state_lock(mutex_);
+                if (dirty_) {
+                    dirty_ = false;
+                    content = serialize();
+                }
+            }
+            if (!content.empty()) {
+                writeFile(content);  // Empty if a save() got there first
+            }
+        }
+        lock.lock();
+    }
+}
+
+void Settings::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    writer_cv_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
 }
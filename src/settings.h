@@ -1,23 +1,71 @@
 #pragma once
 
-#include <string>
+#include <condition_variable>
 #include <mutex>
+#include <string>
+#include <thread>
+
+// Last window placement, restored when the window is created so the first
+// frame is already at the right size
+struct WindowGeometry {
+    static constexpr int kDefaultWidth = 1280;
+    static constexpr int kDefaultHeight = 720;
+
+    // Logical size/position of the restored (not maximized) window
+    int width = kDefaultWidth;
+    int height = kDefaultHeight;
+    bool has_position = false;
+    int x = 0;
+    int y = 0;
+    bool maximized = false;
+    std::string display;  // Display name, empty if unknown
+
+    bool operator==(const WindowGeometry& o) const {
+        return width == o.width && height == o.height && has_position == o.has_position &&
+               x == o.x && y == o.y && maximized == o.maximized && display == o.display;
+    }
+    bool operator!=(const WindowGeometry& o) const { return !(*this == o); }
+};
 
+// settings.json: read once at startup, written by a single background
+// writer that coalesces bursts of changes (e.g. a window drag) into one
+// write-to-temp + rename. Accessors are thread-safe.
 class Settings {
 public:
+    static constexpr int kVersion = 1;
+
     static Settings& instance();
+    ~Settings();
 
     bool load();
-    bool save();
-    void saveAsync();  // Fire-and-forget async save
+    bool save();       // Write now, on the calling thread
+    void saveAsync();  // Debounced background write
+    void flush();      // Write anything pending and stop the writer (shutdown)
+
+    std::string serverUrl() const;
+    void setServerUrl(const std::string& url);
 
-    const std::string& serverUrl() const { return server_url_; }
-    void setServerUrl(const std::string& url) { server_url_ = url; }
+    WindowGeometry windowGeometry() const;
+    // Returns true if anything changed
+    bool setWindowGeometry(const WindowGeometry& geometry);
 
 private:
     Settings() = default;
-    std::string getConfigPath();
+    const std::string& configPath();
+    std::string serialize() const;
+    bool writeFile(const std::string& content);
+    void writerLoop();
 
+    mutable std::mutex mutex_;  // Guards the values below
     std::string server_url_;
-    std::mutex save_mutex_;  // Prevent concurrent saves
+    WindowGeometry window_;
+
+    std::string config_path_;
+    std::once_flag path_once_;
+    std::mutex write_mutex_;  // One writer at a time (save() vs background)
+
+    std::thread writer_;
+    std::condition_variable writer_cv_;
+    bool dirty_ = false;  // Guarded by mutex_
+    bool stop_ = false;   // Guarded by mutex_
 };
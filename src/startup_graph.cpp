@@ -0,0 +1,140 @@
+#include "startup_graph.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+StartupGraph::StartupGraph() : t0_(Clock::now()) {}
+
+StartupGraph::~StartupGraph() {
+    for (Node& node : nodes_) {
+        if (node.thread.joinable()) {
+            node.thread.join();
+        }
+    }
+}
+
+double StartupGraph::ms(Clock::time_point t) const {
+    return std::chrono::duration<double, std::milli>(t - t0_).count();
+}
+
+StartupGraph::Stage StartupGraph::spawn(const char* name, std::vector<Stage> deps,
+                                        std::function<bool()> fn) {
+    Stage stage;
+    Node* node;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stage = static_cast<Stage>(nodes_.size());
+        node = &nodes_.emplace_back();
+        node->name = name;
+        node->deps = std::move(deps);
+        node->worker = true;
+    }
+    node->thread = std::thread([this, stage, node, fn = std::move(fn)]() {
+        if (!waitDeps(*node)) {
+            LOG_WARN(LOG_MAIN, "Startup: skipping %s (dependency failed)", node->name);
+            finish(stage, false);
+            return;
+        }
+        node->start = Clock::now();
+        finish(stage, fn());
+    });
+    return stage;
+}
+
+StartupGraph::Stage StartupGraph::add(const char* name, std::vector<Stage> deps) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Inline stages run in program order on the calling thread
+    if (last_inline_ >= 0) {
+        deps.push_back(last_inline_);
+    }
+    Stage stage = static_cast<Stage>(nodes_.size());
+    Node& node = nodes_.emplace_back();
+    node.name = name;
+    node.deps = std::move(deps);
+    node.worker = false;
+    last_inline_ = stage;
+    return stage;
+}
+
+bool StartupGraph::begin(Stage stage) {
+    Node& node = nodes_[stage];
+    bool ok = waitDeps(node);
+    node.start = Clock::now();
+    return ok;
+}
+
+void StartupGraph::end(Stage stage, bool ok) {
+    finish(stage, ok);
+}
+
+bool StartupGraph::waitDeps(const Node& node) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool ok = true;
+    for (Stage dep : node.deps) {
+        cv_.wait(lock, [&]() { return nodes_[dep].done; });
+        ok = ok && nodes_[dep].ok;
+    }
+    return ok;
+}
+
+void StartupGraph::finish(Stage stage, bool ok) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Node& node = nodes_[stage];
+        node.finish = Clock::now();
+        if (node.start == Clock::time_point()) {
+            node.start = node.finish;  // Skipped
+        }
+        node.ok = ok;
+        node.done = true;
+    }
+    cv_.notify_all();
+}
+
+bool StartupGraph::wait(Stage stage) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return nodes_[stage].done; });
+    return nodes_[stage].ok;
+}
+
+void StartupGraph::report() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() {
+        return std::all_of(nodes_.begin(), nodes_.end(), [](const Node& n) { return n.done; });
+    });
+    if (nodes_.empty()) return;
+
+    // Walk back from the last stage to finish, each time to the dependency
+    // that finished last (the one the stage was waiting for)
+    Stage last = 0;
+    for (Stage i = 1; i < static_cast<Stage>(nodes_.size()); i++) {
+        if (nodes_[i].finish > nodes_[last].finish) last = i;
+    }
+    std::vector<Stage> path;
+    for (Stage s = last; s >= 0;) {
+        path.push_back(s);
+        Stage gate = -1;
+        for (Stage dep : nodes_[s].deps) {
+            if (gate < 0 || nodes_[dep].finish > nodes_[gate].finish) gate = dep;
+        }
+        s = gate;
+    }
+    std::reverse(path.begin(), path.end());
+
+    std::string chain;
+    for (Stage s : path) {
+        const Node& n = nodes_[s];
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "%s%s %.0f ms", chain.empty() ? "" : " -> ", n.name,
+                      ms(n.finish) - ms(n.start));
+        chain += buf;
+    }
+    LOG_INFO(LOG_MAIN, "Startup: %.0f ms, critical path: %s", ms(nodes_[last].finish), chain.c_str());
+    for (const Node& n : nodes_) {
+        LOG_INFO(LOG_MAIN, "  %-14s %-6s start %7.1f ms  took %7.1f ms%s", n.name,
+                 n.worker ? "worker" : "main", ms(n.start), ms(n.finish) - ms(n.start),
+                 n.ok ? "" : "  FAILED");
+    }
+}
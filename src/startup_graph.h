@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Startup as a dependency graph. Worker stages run on their own thread as
+// soon as their dependencies finish; inline stages are code the caller
+// runs itself (bracketed with begin/end), implicitly after the previous
+// inline stage. report() logs each stage's timing and the critical path:
+// the chain of stages that actually gated the last one to finish.
+//
+//   StartupGraph graph;
+//   auto cache = graph.spawn("cacheDir", {}, [&] { return makeCacheDir(); });
+//   auto window = graph.add("window");
+//   graph.begin(window); ...; graph.end(window);
+//   auto browsers = graph.add("browsers", {cache});
+//   if (!graph.begin(browsers)) { ... }  // waits for cacheDir
+class StartupGraph {
+public:
+    using Stage = int;
+
+    StartupGraph();
+    ~StartupGraph();  // Joins worker stages
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    // Worker stage. fn returns false on failure; stages depending on a
+    // failed stage are skipped and fail too.
+    Stage spawn(const char* name, std::vector<Stage> deps, std::function<bool()> fn);
+
+    // Inline stage, run by the caller between begin() and end()
+    Stage add(const char* name, std::vector<Stage> deps = {});
+    // Waits for the dependencies; false if one failed
+    bool begin(Stage stage);
+    void end(Stage stage, bool ok = true);
+
+    // Wait for a stage to finish; false if it failed
+    bool wait(Stage stage);
+
+    // Log stage timings and the critical path (waits for all stages)
+    void report();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        const char* name = nullptr;
+        std::vector<Stage> deps;
+        bool worker = false;
+        bool done = false;
+        bool ok = false;
+        Clock::time_point start;
+        Clock::time_point finish;
+        std::thread thread;
+    };
+
+    bool waitDeps(const Node& node);
+    void finish(Stage stage, bool ok);
+    double ms(Clock::time_point t) const;
+
+    Clock::time_point t0_;
+    std::deque<Node> nodes_;  // Stable addresses while workers run
+    Stage last_inline_ = -1;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
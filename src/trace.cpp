@@ -0,0 +1,207 @@
+#include "trace.h"
+#include "json_reader.h"
+#include "logging.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#else
+#include <sys/syscall.h>
+#endif
+#endif
+
+// Spans per thread and session; further spans are counted as dropped
+static constexpr uint32_t kThreadCapacity = 1 << 16;
+
+std::atomic<bool> TraceRecorder::enabled_{false};
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+// Written only by its thread; read by collectJson() after stop()
+struct ThreadBuffer {
+    uint64_t tid = 0;
+    std::string name;  // Guarded by g_mutex
+    std::atomic<uint32_t> session{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> dropped{0};
+    std::unique_ptr<TraceEvent[]> events;
+};
+
+std::mutex g_mutex;  // Guards g_buffers and thread names
+std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+std::atomic<uint32_t> g_session{0};
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+uint64_t currentThreadId() {
+    // Same ids Chromium uses, so spans on CEF threads share their tracks
+#ifdef _WIN32
+    return GetCurrentThreadId();
+#elif defined(__APPLE__)
+    return pthread_mach_thread_np(pthread_self());
+#else
+    return static_cast<uint64_t>(syscall(SYS_gettid));
+#endif
+}
+
+uint64_t currentProcessId() {
+#ifdef _WIN32
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint64_t>(getpid());
+#endif
+}
+
+ThreadBuffer* threadBuffer() {
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = currentThreadId();
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_buffers.push_back(buffer);
+        t_buffer = buffer.get();
+    }
+    return t_buffer;
+}
+
+}  // namespace
+
+void TraceRecorder::start() {
+    g_session.fetch_add(1, std::memory_order_acq_rel);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::stop() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+void TraceRecorder::setThreadName(const char* name) {
+    ThreadBuffer* buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    buffer->name = name;
+}
+
+uint64_t TraceRecorder::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void TraceRecorder::record(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+    ThreadBuffer* buffer = threadBuffer();
+    uint32_t session = g_session.load(std::memory_order_acquire);
+    if (buffer->session.load(std::memory_order_relaxed) != session) {
+        // First span of a new session on this thread
+        if (!buffer->events) {
+            buffer->events.reset(new TraceEvent[kThreadCapacity]);
+        }
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->session.store(session, std::memory_order_release);
+    }
+    uint32_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= kThreadCapacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = {name, begin_ns, end_ns};
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+std::string TraceRecorder::collectJson(size_t* dropped) {
+    uint32_t session = g_session.load(std::memory_order_acquire);
+    uint64_t pid = currentProcessId();
+    size_t total_dropped = 0;
+    std::string out;
+    char buf[256];
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    for (const auto& buffer : g_buffers) {
+        if (!buffer->name.empty()) {
+            int len = std::snprintf(buf, sizeof(buf),
+                                    "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%llu,\"tid\":%llu,"
+                                    "\"args\":{\"name\":\"",
+                                    static_cast<unsigned long long>(pid),
+                                    static_cast<unsigned long long>(buffer->tid));
+            if (!out.empty()) out += ',';
+            out.append(buf, static_cast<size_t>(len));
+            out += jsonEscape(buffer->name);
+            out += "\"}}";
+        }
+        if (buffer->session.load(std::memory_order_acquire) != session) continue;
+        uint32_t count = buffer->count.load(std::memory_order_acquire);
+        total_dropped += buffer->dropped.load(std::memory_order_relaxed);
+        out.reserve(out.size() + count * 96);
+        for (uint32_t i = 0; i < count; i++) {
+            const TraceEvent& ev = buffer->events[i];
+            int len = std::snprintf(buf, sizeof(buf),
+                                    "{\"ph\":\"X\",\"cat\":\"native\",\"name\":\"%s\",\"pid\":%llu,"
+                                    "\"tid\":%llu,\"ts\":%.3f,\"dur\":%.3f}",
+                                    ev.name, static_cast<unsigned long long>(pid),
+                                    static_cast<unsigned long long>(buffer->tid),
+                                    static_cast<double>(ev.begin_ns) / 1000.0,
+                                    static_cast<double>(ev.end_ns - ev.begin_ns) / 1000.0);
+            if (len <= 0 || static_cast<size_t>(len) >= sizeof(buf)) continue;
+            if (!out.empty()) out += ',';
+            out.append(buf, static_cast<size_t>(len));
+        }
+    }
+    if (dropped) *dropped = total_dropped;
+    return out;
+}
+
+bool writeMergedTrace(const std::string& path, std::string_view chromium_trace,
+                      const std::string& native_events) {
+    // Chromium writes {"traceEvents":[...],"metadata":{...}}: splice our
+    // events into its array and keep the other members as they are
+    std::string_view chromium_events;
+    std::string other_members;
+    JsonReader reader(chromium_trace);
+    std::string_view key;
+    JsonValue value;
+    while (reader.nextMember(key, value)) {
+        if (key == "traceEvents" && value.type == JsonValue::Type::Array) {
+            chromium_events = value.raw.substr(1, value.raw.size() - 2);
+            size_t first = chromium_events.find_first_not_of(" \t\r\n");
+            if (first == std::string_view::npos) chromium_events = {};
+        } else {
+            other_members += ",\"";
+            other_members += key;
+            other_members += "\":";
+            other_members += value.type == JsonValue::Type::String
+                ? "\"" + std::string(value.raw) + "\"" : std::string(value.raw);
+        }
+    }
+    if (!chromium_trace.empty() && reader.failed()) {
+        LOG_WARN(LOG_MAIN, "Trace: Chromium trace is malformed, writing native spans only");
+        chromium_events = {};
+        other_members.clear();
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR(LOG_MAIN, "Trace: cannot write %s", path.c_str());
+        return false;
+    }
+    std::fputs("{\"traceEvents\":[", file);
+    std::fwrite(chromium_events.data(), 1, chromium_events.size(), file);
+    if (!chromium_events.empty() && !native_events.empty()) std::fputc(',', file);
+    std::fwrite(native_events.data(), 1, native_events.size(), file);
+    std::fputc(']', file);
+    std::fwrite(other_members.data(), 1, other_members.size(), file);
+    std::fputs("}\n", file);
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Span recorder for our own threads, written as Chrome trace events so it
+// can be merged with Chromium's trace and opened in Perfetto/about:tracing.
+//
+// Each thread appends to its own fixed-size buffer: recording a span is a
+// clock read and a store, no locks. While tracing is off a span costs one
+// relaxed load. Span names must be string literals (stored by pointer).
+class TraceRecorder {
+public:
+    // Begin a new session; previous events are discarded
+    static void start();
+    static void stop();
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Name the calling thread in the trace (thread_name metadata)
+    static void setThreadName(const char* name);
+
+    // Monotonic clock, same time base as Chromium's trace timestamps
+    static uint64_t nowNs();
+    static void record(const char* name, uint64_t begin_ns, uint64_t end_ns);
+
+    // Events of the last session as comma-separated trace event objects.
+    // Call after stop(). dropped: spans lost to full thread buffers.
+    static std::string collectJson(size_t* dropped = nullptr);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name_(name), begin_ns_(TraceRecorder::enabled() ? TraceRecorder::nowNs() : 0) {}
+    ~TraceSpan() { end(); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // End early (for spans over part of a scope)
+    void end() {
+        if (begin_ns_ && TraceRecorder::enabled()) {
+            TraceRecorder::record(name_, begin_ns_, TraceRecorder::nowNs());
+        }
+        begin_ns_ = 0;
+    }
+
+private:
+    const char* name_;
+    uint64_t begin_ns_;
+};
+
+#define TRACE_SPAN_CONCAT2(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT2(a, b)
+// Span covering the rest of the enclosing scope
+#define TRACE_SPAN(name) TraceSpan TRACE_SPAN_CONCAT(trace_span_, __LINE__)(name)
+
+// Write a Chrome trace JSON file holding Chromium's events (the file
+// CefEndTracing produced, may be empty) followed by native_events.
+bool writeMergedTrace(const std::string& path, std::string_view chromium_trace,
+                      const std::string& native_events);
@@ -70,7 +70,8 @@
 
             this._core.handlers.onTimeUpdate = (time) => {
                 if (!this._isFadingOut) {
-                    this._core._currentTime = time;
+                    const position = this._core.takePosition(time);
+                    if (position !== null) this._core._currentTime = position;
                     this._core._lastTimerTick = Date.now();
                     this.events.trigger(this, 'timeupdate');
                 }
@@ -113,6 +114,7 @@
                 const ms = (options.playerStartPositionTicks || 0) / 10000;
                 this._currentPlayOptions = options;
                 this._core._currentTime = ms;
+                this._core._seekTarget = null;
 
                 window.api.player.load(val,
                     { startMilliseconds: ms, autoplay: true },
@@ -4,6 +4,8 @@
             this.events = events;
             this._duration = undefined;
             this._currentTime = null;
+            this._seekTarget = null;
+            this._seekDeadline = 0;
             this._paused = false;
             this._volume = 100;
             this._playRate = 1;
@@ -31,12 +33,31 @@
                 const now = Date.now();
                 const elapsed = now - this._lastTimerTick;
                 this._lastTimerTick = now;
-                const rate = this._playRate || 1.0;
-                this._currentTime += elapsed * rate;
+                const state = window.jmpNative && window.jmpNative.playerState;
+                const position = state && state.valid ? this.takePosition(state.position) : null;
+                if (position !== null) {
+                    // Exact position from the shared state mirror
+                    this._currentTime = position;
+                } else {
+                    const rate = this._playRate || 1.0;
+                    this._currentTime += elapsed * rate;
+                }
                 this.events.trigger(this.player, 'timeupdate');
             }, 250);
         }
 
+        // Position reported by native code, or null while a seek is pending:
+        // mpv keeps reporting the old position until the seek completes, so
+        // the seek target stands until reports reach it (or give up after 10 s)
+        takePosition(position) {
+            if (this._seekTarget === null) return position;
+            if (Math.abs(position - this._seekTarget) < 1000 || Date.now() > this._seekDeadline) {
+                this._seekTarget = null;
+                return position;
+            }
+            return null;
+        }
+
         stopTimeUpdateTimer() {
             if (this._timeUpdateTimer) {
                 clearInterval(this._timeUpdateTimer);
@@ -90,6 +111,8 @@
         currentTime(val) {
             if (val != null) {
                 this._currentTime = val;
+                this._seekTarget = val;
+                this._seekDeadline = Date.now() + 10000;
                 this._lastTimerTick = Date.now();
                 window.api.player.seekTo(val);
                 return;
@@ -103,7 +126,11 @@
 
         duration() { return this._duration || null; }
         seekable() { return Boolean(this._duration); }
-        getBufferedRanges() { return window._bufferedRanges || []; }
+        getBufferedRanges() {
+            const state = window.jmpNative && window.jmpNative.playerState;
+            if (state && state.valid) return state.bufferedRanges;
+            return window._bufferedRanges || [];
+        }
 
         // Playback rate
         setPlaybackRate(value) {
@@ -88,7 +88,8 @@
 
             this._core.handlers.onTimeUpdate = (time) => {
                 if (time && !this._timeUpdated) this._timeUpdated = true;
-                this._core._currentTime = time;
+                const position = this._core.takePosition(time);
+                if (position !== null) this._core._currentTime = position;
                 this._core._lastTimerTick = Date.now();
                 this.events.trigger(this, 'timeupdate');
             };
@@ -144,6 +145,7 @@
                 const ms = (options.playerStartPositionTicks || 0) / 10000;
                 this._currentPlayOptions = options;
                 this._core._currentTime = ms;
+                this._core._seekTarget = null;
 
                 const streams = options.mediaSource?.MediaStreams || [];
                 const defaultAudioIdx = options.mediaSource.DefaultAudioStreamIndex ?? -1;
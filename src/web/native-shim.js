@@ -264,6 +264,23 @@
         }
     };
 
+    // Native pushes call these directly with typed arguments (no script eval)
+    if (window.jmpNative && window.jmpNative.setPushHandlers) {
+        window.jmpNative.setPushHandlers({
+            playing: () => window._nativeEmit('playing'),
+            paused: () => window._nativeEmit('paused'),
+            finished: () => window._nativeEmit('finished'),
+            canceled: () => window._nativeEmit('canceled'),
+            error: (msg) => window._nativeEmit('error', msg),
+            rateChanged: (rate) => window._nativeSetRate(rate),
+            position: (ms) => window._nativeUpdatePosition(ms),
+            duration: (ms) => window._nativeUpdateDuration(ms),
+            bufferedRanges: (ranges) => window._nativeUpdateBufferedRanges(ranges),
+            hostInput: (action) => window._nativeHostInput([action]),
+            seek: (ms) => window._nativeSeek(ms),
+        });
+    }
+
     // window.NativeShell - app info and plugins
     const plugins = ['mpvVideoPlayer', 'mpvAudioPlayer', 'inputPlugin'];
     for (const plugin of plugins) {